@@ -2,6 +2,7 @@
 #define ARTOBJECT_H
 
 #include <string>
+#include <memory>
 #include<QString>
 class ArtObject
 {
@@ -32,6 +33,9 @@ public:
 
     virtual std::string getType() const noexcept;
 
+    // Deep copy with the same dynamic type
+    virtual std::shared_ptr<ArtObject> clone() const;
+
 private:
     std::string name_;
     std::string description_;
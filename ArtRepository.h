@@ -23,6 +23,7 @@ public:
     ArtPtr get(std::size_t index) const noexcept override;
     std::size_t size() const noexcept override;
     void clear() noexcept override;
+    std::size_t removeMany(std::vector<std::size_t> indices) noexcept override;
 
     // ── Persistence (stubs) ──
     bool loadFromFile(const QString& /*filePath*/) override {
@@ -32,7 +33,10 @@ public:
         return false;  // in‐memory repo does not persist
     }
 
-private:
+protected:
+    // For file-backed subclasses: swap in a freshly loaded item list
+    void replaceAll(std::vector<ArtPtr> items) noexcept;
+
     std::vector<ArtPtr> items_;
 };
 
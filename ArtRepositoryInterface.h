@@ -3,11 +3,30 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
 #include <QString>
 
+#include "ArtSnapshot.h"
 
 class ArtObject;
 
+// Receives mutation events from a repository. Per-item callbacks fire as
+// each change happens; repositoryChanged() fires once per standalone
+// mutation, or once at the end of a batch.
+class RepositoryObserver {
+public:
+    using ArtPtr = std::shared_ptr<ArtObject>;
+
+    virtual ~RepositoryObserver() = default;
+
+    virtual void itemAdded(std::size_t /*index*/, const ArtPtr& /*art*/) {}
+    virtual void itemUpdated(std::size_t /*index*/, const ArtPtr& /*oldArt*/,
+                             const ArtPtr& /*newArt*/) {}
+    virtual void itemRemoved(std::size_t /*index*/, const ArtPtr& /*art*/) {}
+    virtual void itemsReset() {}
+    virtual void repositoryChanged() {}
+};
+
 class ArtRepositoryInterface {
 public:
     using ArtPtr = std::shared_ptr<ArtObject>;
@@ -22,11 +41,104 @@ public:
     virtual std::size_t size() const noexcept = 0;
     virtual void clear() noexcept = 0;
 
+    // Append all of 'arts' in order. The default adds one at a time.
+    virtual void addMany(const std::vector<ArtPtr>& arts) {
+        BatchScope batch(*this);
+        for (const auto& art : arts) add(art);
+    }
+
+    // Remove every listed index (any order, duplicates ignored). Returns
+    // how many items were removed. The default removes one at a time.
+    virtual std::size_t removeMany(std::vector<std::size_t> indices) noexcept {
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        std::size_t removed = 0;
+        BatchScope batch(*this);
+        for (auto it = indices.rbegin(); it != indices.rend(); ++it) {
+            if (remove(*it)) ++removed;
+        }
+        return removed;
+    }
+
+    // ── Concurrent readers ──
+    // Consistent copy of the current items for background work. The
+    // default copies every pointer; repositories can do better.
+    virtual ArtSnapshotPtr snapshot() const {
+        std::vector<ArtPtr> items;
+        items.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i) items.push_back(get(i));
+        return std::make_shared<const ArtSnapshot>(std::move(items));
+    }
+
     // ── Persistence ──
     // Load all art objects from the given file. Return true on success.
     virtual bool loadFromFile(const QString& filePath) = 0;
     // Save current in-memory objects to the given file. Return true on success.
     virtual bool saveToFile(const QString& filePath) const = 0;
+
+    // ── Observers ──
+    void addObserver(RepositoryObserver* observer) {
+        observers_.push_back(observer);
+    }
+    void removeObserver(RepositoryObserver* observer) noexcept {
+        observers_.erase(std::remove(observers_.begin(), observers_.end(), observer),
+                         observers_.end());
+    }
+
+    // ── Batches ──
+    // Between beginBatch() and the matching endBatch() observers still
+    // see every item change, but repositoryChanged() is held back and
+    // delivered once at the end. Batches nest.
+    void beginBatch() noexcept { ++batchDepth_; }
+    void endBatch() noexcept {
+        if (batchDepth_ == 0 || --batchDepth_ > 0 || !batchDirty_) return;
+        batchDirty_ = false;
+        for (auto* o : observers_) o->repositoryChanged();
+    }
+
+    class BatchScope {
+    public:
+        explicit BatchScope(ArtRepositoryInterface& repo) noexcept : repo_(repo) {
+            repo_.beginBatch();
+        }
+        ~BatchScope() { repo_.endBatch(); }
+        BatchScope(const BatchScope&) = delete;
+        BatchScope& operator=(const BatchScope&) = delete;
+    private:
+        ArtRepositoryInterface& repo_;
+    };
+
+protected:
+    // Implementations call these after applying each change
+    void notifyAdded(std::size_t index, const ArtPtr& art) noexcept {
+        for (auto* o : observers_) o->itemAdded(index, art);
+        notifyChanged();
+    }
+    void notifyUpdated(std::size_t index, const ArtPtr& oldArt, const ArtPtr& newArt) noexcept {
+        for (auto* o : observers_) o->itemUpdated(index, oldArt, newArt);
+        notifyChanged();
+    }
+    void notifyRemoved(std::size_t index, const ArtPtr& art) noexcept {
+        for (auto* o : observers_) o->itemRemoved(index, art);
+        notifyChanged();
+    }
+    void notifyReset() noexcept {
+        for (auto* o : observers_) o->itemsReset();
+        notifyChanged();
+    }
+
+private:
+    void notifyChanged() noexcept {
+        if (batchDepth_ > 0) {
+            batchDirty_ = true;
+            return;
+        }
+        for (auto* o : observers_) o->repositoryChanged();
+    }
+
+    std::vector<RepositoryObserver*> observers_;
+    int  batchDepth_ = 0;
+    bool batchDirty_ = false;
 };
 
 #endif // ARTREPOSITORYINTERFACE_H
@@ -0,0 +1,90 @@
+#ifndef ARTSNAPSHOT_H
+#define ARTSNAPSHOT_H
+
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+
+class ArtObject;
+
+// Immutable, point-in-time view of a repository's items. Holding one
+// keeps the items alive, and it can be read from any thread while the
+// repository goes on changing.
+//
+// Items are stored in fixed-size chunks (all full except the last), so
+// a new version of a large snapshot can share every chunk it does not
+// touch with the previous one (see ConcurrentArtRepository).
+class ArtSnapshot {
+public:
+    using ArtPtr   = std::shared_ptr<ArtObject>;
+    using Chunk    = std::vector<ArtPtr>;
+    using ChunkPtr = std::shared_ptr<const Chunk>;
+
+    static constexpr std::size_t kChunkShift = 10;
+    static constexpr std::size_t kChunkSize  = std::size_t(1) << kChunkShift;
+    static constexpr std::size_t kChunkMask  = kChunkSize - 1;
+
+    ArtSnapshot() noexcept = default;
+
+    explicit ArtSnapshot(std::vector<ArtPtr> items) : size_(items.size()) {
+        if (items.size() <= kChunkSize) {
+            if (!items.empty()) chunks_.push_back(std::make_shared<const Chunk>(std::move(items)));
+            return;
+        }
+        chunks_.reserve((items.size() + kChunkMask) >> kChunkShift);
+        for (std::size_t i = 0; i < items.size(); i += kChunkSize) {
+            const std::size_t end = std::min(items.size(), i + kChunkSize);
+            chunks_.push_back(std::make_shared<const Chunk>(
+                std::make_move_iterator(items.begin() + i),
+                std::make_move_iterator(items.begin() + end)));
+        }
+    }
+
+    // 'chunks' must all hold kChunkSize items except the last one
+    ArtSnapshot(std::vector<ChunkPtr> chunks, std::size_t size) noexcept
+        : chunks_(std::move(chunks)), size_(size) {}
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    const ArtPtr& at(std::size_t index) const noexcept {
+        return (*chunks_[index >> kChunkShift])[index & kChunkMask];
+    }
+
+    const std::vector<ChunkPtr>& chunks() const noexcept { return chunks_; }
+
+    // Forward iteration, e.g. for (const auto& art : *snapshot)
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = ArtPtr;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const ArtPtr*;
+        using reference         = const ArtPtr&;
+
+        const_iterator(const ArtSnapshot* owner, std::size_t index) noexcept
+            : owner_(owner), index_(index) {}
+
+        reference operator*() const noexcept { return owner_->at(index_); }
+        pointer operator->() const noexcept { return &owner_->at(index_); }
+        const_iterator& operator++() noexcept { ++index_; return *this; }
+        const_iterator operator++(int) noexcept { auto old = *this; ++index_; return old; }
+        bool operator==(const const_iterator& o) const noexcept { return index_ == o.index_; }
+        bool operator!=(const const_iterator& o) const noexcept { return index_ != o.index_; }
+
+    private:
+        const ArtSnapshot* owner_;
+        std::size_t        index_;
+    };
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+
+private:
+    std::vector<ChunkPtr> chunks_;
+    std::size_t           size_ = 0;
+};
+
+using ArtSnapshotPtr = std::shared_ptr<const ArtSnapshot>;
+
+#endif // ARTSNAPSHOT_H
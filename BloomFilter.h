@@ -0,0 +1,76 @@
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Set membership with no false negatives and a bounded false positive
+// rate, in about 10 bits per item at 1%. Items are inserted as 64-bit
+// hashes (callers hash their keys once); the k probe positions are
+// derived from that one hash by double hashing.
+//
+// Items cannot be removed: owners rebuild the filter once enough of its
+// items are gone (see NameIndex). Copies are independent, so a copy can
+// be handed to worker threads as a read-only snapshot.
+class BloomFilter {
+public:
+    BloomFilter() = default;
+
+    // Sized for 'capacity' items at 'falsePositiveRate'
+    explicit BloomFilter(std::size_t capacity, double falsePositiveRate = 0.01) {
+        if (capacity == 0) capacity = 1;
+        const double ln2 = std::log(2.0);
+        const double bits = -static_cast<double>(capacity) * std::log(falsePositiveRate) / (ln2 * ln2);
+        words_.assign((static_cast<std::size_t>(bits) + 63) / 64 + 1, 0);
+        bits_ = words_.size() * 64;
+        hashes_ = std::max(1, static_cast<int>(std::lround(bits / capacity * ln2)));
+    }
+
+    void insert(std::uint64_t hash) noexcept {
+        if (bits_ == 0) return;
+        std::uint64_t h1 = hash, h2 = second(hash);
+        for (int i = 0; i < hashes_; ++i, h1 += h2) {
+            const std::uint64_t bit = h1 % bits_;
+            words_[bit >> 6] |= std::uint64_t(1) << (bit & 63);
+        }
+        ++count_;
+    }
+
+    // false: definitely never inserted; true: probably inserted
+    bool mightContain(std::uint64_t hash) const noexcept {
+        if (bits_ == 0) return false;
+        std::uint64_t h1 = hash, h2 = second(hash);
+        for (int i = 0; i < hashes_; ++i, h1 += h2) {
+            const std::uint64_t bit = h1 % bits_;
+            if (!(words_[bit >> 6] & (std::uint64_t(1) << (bit & 63)))) return false;
+        }
+        return true;
+    }
+
+    void clear() noexcept {
+        std::fill(words_.begin(), words_.end(), 0);
+        count_ = 0;
+    }
+
+    std::size_t count() const noexcept { return count_; }   // insertions
+    std::size_t bitCount() const noexcept { return bits_; }
+    int hashCount() const noexcept { return hashes_; }
+
+private:
+    // Second, odd step for double hashing
+    static std::uint64_t second(std::uint64_t h) noexcept {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h | 1;
+    }
+
+    std::vector<std::uint64_t> words_;
+    std::uint64_t              bits_   = 0;
+    int                        hashes_ = 0;
+    std::size_t                count_  = 0;
+};
+
+#endif // BLOOMFILTER_H
@@ -0,0 +1,97 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Fixed-capacity lock-free multi-producer/multi-consumer queue (Dmitry
+// Vyukov's bounded MPMC design). Every slot carries a sequence number
+// that tells producers and consumers whose turn it is, so a push or pop
+// is one CAS on the shared position plus the slot handoff, with no locks
+// and no allocation after construction.
+//
+// tryPush()/tryPop() never block: they return false when the queue is
+// full/empty. Capacity is rounded up to a power of two.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity)
+        : mask_(roundUp(capacity) - 1), slots_(new Slot[mask_ + 1])
+    {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+    // A hint only: may be stale by the time the caller acts on it
+    bool empty() const noexcept { return head_.load() == tail_.load(); }
+
+    bool tryPush(T&& value) {
+        Slot* slot;
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = std::move(value);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        Slot* slot;
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;   // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(slot->value);
+        slot->value = T();
+        slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static std::size_t roundUp(std::size_t n) noexcept {
+        std::size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // Producers and consumers hammer different ends: keep them on
+    // separate cache lines
+    static constexpr std::size_t kLine = 64;
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T                        value;
+    };
+
+    const std::size_t        mask_;
+    std::unique_ptr<Slot[]>  slots_;
+    alignas(kLine) std::atomic<std::size_t> tail_{0};
+    alignas(kLine) std::atomic<std::size_t> head_{0};
+};
+
+#endif // BOUNDEDQUEUE_H
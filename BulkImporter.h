@@ -0,0 +1,88 @@
+#ifndef BULKIMPORTER_H
+#define BULKIMPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ArtObject.h"
+#include "ArtSnapshot.h"
+#include "BloomFilter.h"
+#include "TaskScheduler.h"
+
+// Imports every CSV/JSON catalog export in a directory (e.g. one per
+// regional branch) on top of what is already loaded.
+//
+// The work runs as a pipeline on the shared scheduler:
+//   read   files are read in chunks of rows, a couple of files at a time
+//   parse  chunks are parsed and validated in parallel, one task each
+//   commit one task at a time drops duplicates and hands out batches
+// Stages are connected by bounded lock-free queues. The number of chunks
+// in flight is capped at the queues' capacity, so pushes never fail:
+// readers that would exceed it park until the commit stage frees a slot.
+// No stage ever blocks a worker.
+//
+// Results reach the GUI thread through batchReady() in large batches;
+// the receiver appends them (ArtRepositoryInterface::addMany).
+class BulkImporter : public QObject {
+    Q_OBJECT
+
+public:
+    using ArtPtr = std::shared_ptr<ArtObject>;
+    using Batch  = std::vector<ArtPtr>;
+
+    struct Report {
+        int     files       = 0;   // catalog files found
+        int     failedFiles = 0;   // could not be opened or parsed
+        quint64 rows        = 0;   // rows read so far
+        quint64 imported    = 0;   // rows handed out in batches
+        quint64 invalid     = 0;   // rows that failed to parse or validate
+        quint64 duplicates  = 0;   // already in the catalog, or earlier in the import
+        double  seconds     = 0;
+
+        double rowsPerSecond() const noexcept {
+            return seconds > 0 ? rows / seconds : 0.0;
+        }
+    };
+
+    explicit BulkImporter(QObject* parent = nullptr);
+    ~BulkImporter() override;
+
+    // Import every *.csv and *.json file in 'directory'. Rows matching a
+    // record of 'existing' (or an earlier row) are skipped. An import
+    // already running is cancelled.
+    //
+    // 'existingNames' (NameIndex::bloomSnapshot() of the same catalog)
+    // lets the parse stage clear most new rows in parallel; the keys of
+    // 'existing' are only built once some row might be a duplicate.
+    void start(const QString& directory, ArtSnapshotPtr existing,
+               std::shared_ptr<const BloomFilter> existingNames = nullptr);
+    void cancel();
+    bool isRunning() const noexcept;
+
+    // ── Row checks (pure, also used by the tests) ──
+    // Same key for the same artwork in two exports: type, name and
+    // location, ignoring ASCII case and surrounding blanks
+    static std::string dedupKey(const ArtObject& art);
+    // Has a name, a finite non-negative price and, for digital art, a
+    // resolution
+    static bool isValid(const ArtObject& art);
+
+signals:
+    void batchReady(const BulkImporter::Batch& batch);
+    void progress(const BulkImporter::Report& report);
+    void finished(const BulkImporter::Report& report);
+
+private:
+    struct Pipeline;
+
+    TaskGroup                 tasks_;
+    std::shared_ptr<Pipeline> pipeline_;
+    bool                      running_ = false;
+};
+
+#endif // BULKIMPORTER_H
@@ -0,0 +1,99 @@
+#ifndef CATALOGGENERATOR_H
+#define CATALOGGENERATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ArtObject.h"
+
+// How a synthetic catalog should look. Rates are per record (0..1);
+// the type mix is relative weights.
+struct CatalogSpec {
+    std::uint64_t seed = 1;
+
+    // ── Type mix ──
+    double paintings  = 0.5;
+    double sculptures = 0.3;
+    double digital    = 0.2;
+
+    // ── Prices: log-normal around the median, clamped, rounded to cents ──
+    double medianPrice = 2500.0;
+    double priceSpread = 1.2;     // sigma of ln(price)
+    double minPrice    = 10.0;
+    double maxPrice    = 5.0e6;
+
+    // ── Strings ──
+    int nameWordsMin   = 1;
+    int nameWordsMax   = 5;
+    int descriptionMin = 20;      // characters, roughly
+    int descriptionMax = 240;
+
+    // ── Locations: this many distinct ones, Zipf-skewed (0 = uniform) ──
+    std::uint64_t locations    = 200;
+    double        locationSkew = 1.0;
+
+    // ── Content that trips up parsers ──
+    double unicodeRate = 0.05;    // non-ASCII words in the name or description
+    double quoteRate   = 0.02;    // commas and double quotes in the name and description
+    double newlineRate = 0.01;    // line breaks in the description
+    double imageRate   = 0.5;     // records with an image path
+};
+
+// Writes realistic catalogs of any size in the formats the repositories
+// read: the CsvRepository CSV header and the JsonRepository array.
+//
+// Record i depends only on the spec and i, not on how many records are
+// written or in which order, so a 10k catalog is the prefix of the 1M one
+// with the same seed, and shards can be generated in parallel. Randomness
+// is SplitMix64 with our own mapping to ranges (the std distributions
+// differ between standard libraries), so a seed gives the same bytes on
+// every build.
+class CatalogGenerator {
+public:
+    enum class Format { Csv, Json };
+
+    struct Record {
+        std::string   type;          // "Painting", "Sculpture" or "DigitalArt"
+        std::string   name;
+        std::string   description;
+        double        price = 0.0;
+        std::string   location;
+        std::string   extra;         // canvas type, material or software
+        int           resolutionX = 0;
+        int           resolutionY = 0;
+        std::string   imagePath;
+    };
+
+    explicit CatalogGenerator(CatalogSpec spec = {});
+
+    const CatalogSpec& spec() const noexcept { return spec_; }
+
+    Record record(std::uint64_t index) const;
+    std::shared_ptr<ArtObject> art(std::uint64_t index) const;
+    std::vector<std::shared_ptr<ArtObject>> arts(std::uint64_t first, std::uint64_t count) const;
+    // Location number 'rank' (0 is the most frequent)
+    std::string locationName(std::uint64_t rank) const;
+
+    // Records [first, first + count) as a complete file; bytes written
+    std::uint64_t write(std::ostream& out, Format format, std::uint64_t count,
+                        std::uint64_t first = 0) const;
+
+    // "csv" / "json", or a file name with that extension
+    static bool formatFromName(const std::string& name, Format* format);
+    static const char* formatName(Format format) noexcept;
+
+    static std::string csvRow(const Record& r);
+    static std::string jsonObject(const Record& r);
+
+private:
+    std::uint64_t pickLocation(double unit) const;
+
+    CatalogSpec         spec_;
+    double              typeTotal_ = 1.0;
+    std::vector<double> locationCdf_;   // cumulative weights; empty when uniform
+};
+
+#endif // CATALOGGENERATOR_H
@@ -0,0 +1,53 @@
+#ifndef CATALOGLOADER_H
+#define CATALOGLOADER_H
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ArtObject.h"
+#include "TaskScheduler.h"
+
+// Parses a catalog file (CSV or JSON, chosen by extension) on a worker
+// thread and hands the records to the GUI thread in batches as they are
+// parsed, so the window can show and filter the loaded prefix while the
+// rest of the file is still being read.
+class CatalogLoader : public QObject {
+    Q_OBJECT
+
+public:
+    using ArtPtr = std::shared_ptr<ArtObject>;
+    using Batch  = std::vector<ArtPtr>;
+
+    explicit CatalogLoader(QObject* parent = nullptr);
+    ~CatalogLoader() override;
+
+    // Start loading 'filePath'; a load already running is cancelled.
+    void start(const QString& filePath);
+    void cancel();
+    bool isRunning() const noexcept;
+
+signals:
+    void batchLoaded(const CatalogLoader::Batch& batch);
+    // Percentage of the file consumed so far; -1 while it is unknown.
+    void progress(int percent);
+    void finished(bool ok);
+
+private:
+    using Sink = std::function<void(Batch&&, int percent)>;
+
+    static bool readCsv(const QString& filePath, const Sink& sink,
+                        const std::atomic_bool& cancelled);
+    static bool readJson(const QString& filePath, const Sink& sink,
+                         const std::atomic_bool& cancelled);
+
+    TaskGroup                         tasks_{true};   // one load at a time, in order
+    std::shared_ptr<std::atomic_bool> cancelled_;
+    bool                              running_ = false;
+};
+
+#endif // CATALOGLOADER_H
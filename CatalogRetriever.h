@@ -0,0 +1,50 @@
+#ifndef CATALOGRETRIEVER_H
+#define CATALOGRETRIEVER_H
+
+#include <memory>
+#include <string>
+
+#include "ArtRepositoryInterface.h"
+#include "SimilarityIndex.h"
+
+// Grounds a chat question in the catalog: picks out the few records the
+// question is about and writes them up as a short block for the prompt.
+//
+//   "which bronze sculptures in Vienna are under 5k?"
+//     kinds      sculpture
+//     locations  every catalog location "vienna" names
+//     price      at most 5000
+//     text       ranked by SimilarityIndex ("bronze" is a material word)
+//
+// The block holds at most k records of bounded length, so the prompt
+// stays the same size however large the catalog grows. The lookup is
+// one filtered pass over SimilarityIndex, a few milliseconds for a
+// million records. GUI thread only, like the index.
+class CatalogRetriever {
+public:
+    static constexpr std::size_t kDefaultRecords   = 8;
+    static constexpr std::size_t kDescriptionChars = 120;
+
+    struct Result {
+        std::string      context;     // empty when the question is not about the catalog
+        std::size_t      records = 0;
+        SimilarityFilter filter;
+        double           milliseconds = 0.0;
+    };
+
+    CatalogRetriever(std::shared_ptr<ArtRepositoryInterface> repo, const SimilarityIndex& index);
+
+    Result retrieve(const std::string& question, std::size_t k = kDefaultRecords) const;
+
+    // Kinds and price bounds named in the question (locations need the
+    // index, see SimilarityIndex::locationsIn)
+    static SimilarityFilter parseFilter(const std::string& question);
+    // "5k", "$5,000", "2.5m", "1200" -> value; false if not a number
+    static bool parsePrice(const std::string& word, double* value);
+
+private:
+    std::shared_ptr<ArtRepositoryInterface> repo_;
+    const SimilarityIndex&                  index_;
+};
+
+#endif // CATALOGRETRIEVER_H
@@ -0,0 +1,176 @@
+#ifndef CHATCONTEXT_H
+#define CHATCONTEXT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ChatMessage {
+    std::string role;      // "system", "user" or "assistant"
+    std::string content;
+};
+
+// What goes into each chat request, kept under a token budget so the
+// payload stops growing with the session:
+//   system prompt
+//   summary of older turns (written by the model, cached until refolded)
+//   the most recent turns that fit
+//   grounding for the latest question (catalog records), if any
+// Turns that no longer fit are handed out by foldRequest() to be
+// summarized together with the previous summary; once setSummary() has
+// the result they are dropped. Until then a clipped excerpt of them
+// stands in, within its own small budget.
+//
+// Tokens are estimated at 4 bytes each, close enough for English text
+// to size requests; the server does the exact count.
+class ChatContext {
+public:
+    static constexpr std::size_t kPerMessageTokens = 4;     // role and framing
+    static constexpr std::size_t kSummaryTokens    = 400;   // cap on the cached summary
+    static constexpr std::size_t kExcerptTokens    = 300;   // stand-in while folding
+    static constexpr std::size_t kExcerptChars     = 160;   // per message
+
+    struct Stats {
+        std::uint64_t requests  = 0;
+        std::uint64_t bytesSent = 0;   // request bodies, summaries not included
+        std::uint64_t lastBytes = 0;
+        std::uint64_t maxBytes  = 0;
+        std::uint64_t summaries = 0;
+    };
+
+    explicit ChatContext(std::size_t budgetTokens = 3000, std::string systemPrompt = std::string())
+        : budget_(budgetTokens), system_(std::move(systemPrompt)) {}
+
+    static std::size_t estimateTokens(const std::string& text) noexcept {
+        return (text.size() + 3) / 4;
+    }
+
+    void add(std::string role, std::string content) {
+        messages_.push_back({std::move(role), std::move(content)});
+    }
+
+    // Messages for the next request. 'grounding' goes in as a system
+    // message just before the latest one and is not kept: the next
+    // question gets its own.
+    std::vector<ChatMessage> build(const std::string& grounding = std::string()) const {
+        std::vector<ChatMessage> out;
+        if (!system_.empty()) out.push_back({"system", system_});
+        if (!summary_.empty()) {
+            out.push_back({"system", "Summary of the earlier conversation: " + summary_});
+        }
+        const std::size_t start = recentStart(grounding);
+        if (start > 0) {
+            const std::string excerpt = excerptOf(start);
+            if (!excerpt.empty()) {
+                out.push_back({"system", "Earlier messages (abridged):\n" + excerpt});
+            }
+        }
+        out.insert(out.end(), messages_.begin() + start, messages_.end());
+        if (!grounding.empty()) {
+            out.insert(out.empty() || messages_.empty() ? out.end() : out.end() - 1,
+                       {"system", grounding});
+        }
+        return out;
+    }
+
+    // Turns to fold into the summary, if any and none are being folded:
+    // a prompt for the model plus the sequence number to pass back to
+    // setSummary(). Empty if nothing needs folding.
+    std::vector<ChatMessage> foldRequest(std::uint64_t* foldEnd) {
+        const std::size_t start = recentStart();
+        if (folding_ || start == 0) return {};
+        folding_ = true;
+
+        // Oldest first, one budget's worth per fold, so a backlog left by
+        // failed folds does not make the summary request itself unbounded
+        std::string text;
+        if (!summary_.empty()) text += "Summary so far:\n" + summary_ + "\n\n";
+        text += "New messages:\n";
+        std::size_t end = 0;
+        while (end < start && (end == 0 || estimateTokens(text) < budget_)) {
+            text += messages_[end].role + ": " + messages_[end].content + "\n";
+            ++end;
+        }
+        *foldEnd = firstSeq_ + end;
+        const std::string instruction =
+            "Summarize this conversation in at most " + std::to_string(kSummaryTokens * 3 / 4)
+            + " words. Keep names of artworks, prices, locations, questions still open and "
+              "anything the user asked to remember. Reply with the summary only.";
+        return {{"system", instruction}, {"user", text}};
+    }
+
+    void setSummary(std::string summary, std::uint64_t foldEnd) {
+        folding_ = false;
+        if (foldEnd <= firstSeq_) return;   // already folded
+        const std::size_t n = std::min<std::size_t>(foldEnd - firstSeq_, messages_.size());
+        messages_.erase(messages_.begin(), messages_.begin() + n);
+        firstSeq_ += n;
+        if (summary.size() > kSummaryTokens * 4) summary.resize(kSummaryTokens * 4);
+        summary_ = std::move(summary);
+        ++stats_.summaries;
+    }
+
+    void foldFailed() noexcept { folding_ = false; }
+
+    void recordSent(std::uint64_t bytes) noexcept {
+        ++stats_.requests;
+        stats_.bytesSent += bytes;
+        stats_.lastBytes = bytes;
+        stats_.maxBytes  = std::max(stats_.maxBytes, bytes);
+    }
+
+    const Stats& stats() const noexcept { return stats_; }
+    const std::string& summary() const noexcept { return summary_; }
+    std::size_t pendingMessages() const noexcept { return messages_.size(); }
+
+private:
+    static std::size_t cost(const ChatMessage& m) noexcept {
+        return estimateTokens(m.content) + kPerMessageTokens;
+    }
+
+    // First message that goes out verbatim: the longest suffix within
+    // the budget, at least the last message, starting at a user turn
+    std::size_t recentStart(const std::string& grounding = std::string()) const {
+        std::size_t used = kExcerptTokens;
+        if (!grounding.empty()) used += estimateTokens(grounding) + kPerMessageTokens;
+        if (!system_.empty())  used += estimateTokens(system_) + kPerMessageTokens;
+        if (!summary_.empty()) used += estimateTokens(summary_) + 2 * kPerMessageTokens;
+
+        std::size_t start = messages_.size();
+        while (start > 0) {
+            const std::size_t c = cost(messages_[start - 1]);
+            if (start < messages_.size() && used + c > budget_) break;
+            used += c;
+            --start;
+        }
+        while (start > 0 && start + 1 < messages_.size() && messages_[start].role != "user") ++start;
+        return start;
+    }
+
+    // Newest first until kExcerptTokens, then back in order
+    std::string excerptOf(std::size_t end) const {
+        std::vector<std::string> lines;
+        std::size_t used = 0;
+        for (std::size_t i = end; i-- > 0; ) {
+            std::string line = messages_[i].role + ": " + messages_[i].content.substr(0, kExcerptChars);
+            if (messages_[i].content.size() > kExcerptChars) line += "...";
+            if (used + estimateTokens(line) > kExcerptTokens) break;
+            used += estimateTokens(line);
+            lines.push_back(std::move(line));
+        }
+        std::string out;
+        for (auto it = lines.rbegin(); it != lines.rend(); ++it) out += *it + "\n";
+        return out;
+    }
+
+    std::size_t              budget_;
+    std::string              system_;
+    std::string              summary_;
+    std::vector<ChatMessage> messages_;       // not yet folded, oldest first
+    std::uint64_t            firstSeq_ = 0;   // sequence number of messages_[0]
+    bool                     folding_  = false;
+    Stats                    stats_;
+};
+
+#endif // CHATCONTEXT_H
@@ -2,109 +2,489 @@
 #define CHATDIALOG_H
 
 #include <QDialog>
-#include <QTextBrowser>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QLabel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QtNetwork/QNetworkAccessManager>
+#include <QShowEvent>
 #include <QtNetwork/QNetworkRequest>
-#include <QtNetwork/QNetworkReply>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
 #include <QUrl>
 #include <QDebug>
 
+#include <functional>
+
 #include "api.h"
+#include "SseParser.h"
+#include "ChatContext.h"
+#include "ResponseCache.h"
+#include "ChatTransport.h"
+#include "ChatTranscript.h"
+#include "ChatTelemetry.h"
 
+// Chat with a completion endpoint. Replies are streamed: the request asks
+// for server-sent events and each delta is appended to the transcript as
+// it arrives. A server that answers with one plain JSON body still works.
+// The transcript is a ChatTranscriptModel shown by ChatTranscriptView,
+// which lays out only new, changed and visible messages, so long
+// sessions stay as quick as short ones.
+//
+// Each request carries the system prompt, a summary of older turns and
+// the recent ones, within ChatContext's token budget. Older turns are
+// summarized by the same endpoint in the background. With setGrounding()
+// each question also carries what the catalog has on it (see
+// CatalogRetriever), a few records rather than the whole catalog.
+//
+// With setResponseCache() a question asked before with the same context
+// is answered from disk.
+//
+// Requests go through ChatTransport: each has an id, timeouts and
+// retries with backoff, and the status line says when one is retried.
+//
+// Every reply is measured (ChatRequestMetrics: first byte, first token,
+// total, bytes each way, tokens and tokens/s). A line under the status
+// shows the session so far, and each reply is appended as one JSON line
+// to the metrics file: ART_CHAT_METRICS when set, otherwise
+// chat_metrics.jsonl in the application data directory.
+//
+// The endpoint and model come from ART_CHAT_ENDPOINT / ART_CHAT_MODEL
+// when set (e.g. a local mock server), or setEndpoint() / setModel().
 class ChatDialog : public QDialog {
     Q_OBJECT
 
 public:
+    // Question -> context for the prompt ("" for none)
+    using Grounding = std::function<std::string(const std::string&)>;
+
     explicit ChatDialog(QWidget *parent = nullptr)
         : QDialog(parent),
-        messageView(new QTextBrowser(this)),
+        transcript(new ChatTranscriptModel(this)),
+        messageView(new ChatTranscriptView(this)),
         inputLine(new QLineEdit(this)),
         sendButton(new QPushButton("Send", this)),
-        networkManager(new QNetworkAccessManager(this))
+        stopButton(new QPushButton("Stop", this)),
+        statusLabel(new QLabel(this)),
+        summaryLabel(new QLabel(this)),
+        transport(new ChatTransport(this)),
+        endpoint(QUrl(qEnvironmentVariable("ART_CHAT_ENDPOINT",
+                                           "https://openrouter.ai/api/v1/chat/completions"))),
+        model(qEnvironmentVariable("ART_CHAT_MODEL", "deepseek/deepseek-chat:free")),
+        context(3000, "You help the user of an art catalog application with questions "
+                      "about artworks, artists, prices and collections."),
+        metricsPath(qEnvironmentVariable("ART_CHAT_METRICS",
+                                         QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                                             + "/chat_metrics.jsonl"))
     {
 
         setWindowTitle("Chat");
         resize(400, 300);
 
+        messageView->setModel(transcript);
         auto *layout = new QVBoxLayout(this);
         layout->addWidget(messageView);
 
         auto *inputLayout = new QHBoxLayout;
         inputLayout->addWidget(inputLine);
         inputLayout->addWidget(sendButton);
+        inputLayout->addWidget(stopButton);
         layout->addLayout(inputLayout);
+        layout->addWidget(statusLabel);
+        layout->addWidget(summaryLabel);
+        summaryLabel->setWordWrap(true);
+        summaryLabel->setEnabled(false);   // greyed: secondary to the status
+        stopButton->setEnabled(false);
 
         connect(sendButton, &QPushButton::clicked, this, &ChatDialog::onSend);
         connect(inputLine, &QLineEdit::returnPressed, this, &ChatDialog::onSend);
-        connect(networkManager, &QNetworkAccessManager::finished,
-                this, &ChatDialog::onNetworkReply);
+        connect(stopButton, &QPushButton::clicked, this, &ChatDialog::onStop);
+        connect(transport, &ChatTransport::dataReceived, this, &ChatDialog::onData);
+        connect(transport, &ChatTransport::retrying, this, &ChatDialog::onRetrying);
+        connect(transport, &ChatTransport::finished, this, &ChatDialog::onTransportFinished);
+    }
+
+    ~ChatDialog() override {
+        // The transport goes with us and drops its requests unreported
+        transport->disconnect(this);
+        if (context.stats().requests > 0) {
+            qInfo().noquote() << "[ChatDialog] requests by outcome:\n" << transport->statsSummary();
+        }
+        if (telemetry.requests() + telemetry.local() > 0) {
+            qInfo().noquote() << "[ChatDialog] session:" << QString::fromStdString(telemetry.summary());
+        }
     }
 
+    void setEndpoint(const QUrl& url) { endpoint = url; }
+    void setModel(const QString& name) { model = name; }
+    void setGrounding(Grounding g) { grounding = std::move(g); }
+    void setResponseCache(std::shared_ptr<ResponseCache> c) { cache = std::move(c); }
+
 private slots:
     void onSend() {
-        API API_TOKEN;
         QString text = inputLine->text().trimmed();
-        if (text.isEmpty()) return;
+        if (text.isEmpty() || replyId) return;
 
-        messageView->append("<b>You:</b> " + text);
-        QJsonObject userMsg;
-        userMsg["role"] = "user";
-        userMsg["content"] = text;
-        conversation.append(userMsg);
+        transcript->append("You", text);
+        context.add("user", text.toStdString());
         inputLine->clear();
 
-        QNetworkRequest request(QUrl("https://openrouter.ai/api/v1/chat/completions"));
-        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-        request.setRawHeader("Authorization", QByteArray("Bearer ") + QByteArray(API_TOKEN.getToken()));
-        request.setRawHeader("HTTP-Referer", QByteArray("my-qt-chat-app"));
-        request.setRawHeader("X-Title", QByteArray("MyQtDesktopChat"));
+        std::string records;
+        if (grounding) {
+            QElapsedTimer retrieval;
+            retrieval.start();
+            records = grounding(text.toStdString());
+            qInfo().noquote() << QString("[ChatDialog] catalog context: %1 bytes in %2 ms")
+                                     .arg(records.size()).arg(retrieval.nsecsElapsed() / 1e6, 0, 'f', 2);
+        }
+        const std::vector<ChatMessage> messages = context.build(records);
+        sentBytes = 0;
+        promptEstimate = 0;
+        for (const ChatMessage& m : messages) {
+            promptEstimate += ChatContext::estimateTokens(m.content) + ChatContext::kPerMessageTokens;
+        }
+        usagePrompt = usageCompletion = -1;
 
-        QJsonObject body;
-        body["model"] = "deepseek/deepseek-chat:free";
-        body["messages"] = conversation;
+        // The reply paragraph fills in as deltas arrive
+        botRow = transcript->append("Bot", QString());
+        botText.clear();
+        chunks = 0;
+        firstTokenMs = -1;
+        stopped = false;
+        elapsed.start();
+        sendButton->setEnabled(false);
+        stopButton->setEnabled(true);
+        dispatch(messages);
+    }
 
-        networkManager->post(request, QJsonDocument(body).toJson());
+    void onStop() {
+        if (!replyId) return;
+        stopped = true;
+        transport->abort(replyId);   // finished() follows right away
     }
 
-    void onNetworkReply(QNetworkReply* reply) {
-        int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-        QByteArray resp = reply->readAll();
-        //qDebug() << "HTTP status:" << status << "\nBody:" << resp;
+    void onData(quint64 id, const QByteArray& chunk, bool isEventStream) {
+        if (id == summaryId) {
+            summaryBody += chunk;
+            return;
+        }
+        if (id != replyId) return;
+        eventStream = isEventStream;
+        if (!eventStream) {
+            rawBody += chunk;   // plain JSON: parsed at the end
+            return;
+        }
+        for (const SseEvent& event : parser.feed(chunk.constData(), std::size_t(chunk.size()))) {
+            handleEvent(event);
+        }
+    }
 
-        if (reply->error() != QNetworkReply::NoError) {
-            messageView->append("<b>Bot:</b> Error fetching reply");
-        } else {
-            QJsonDocument doc = QJsonDocument::fromJson(resp);
-            QString botText;
+    void onRetrying(quint64 id, int nextAttempt, int delayMs, const QString& reason) {
+        if (id != replyId) return;
+        statusLabel->setText(QString("%1; trying again in %2 s (attempt %3)")
+                                 .arg(reason).arg(delayMs / 1000.0, 0, 'f', 1).arg(nextAttempt));
+    }
+
+    void onTransportFinished(const ChatTransport::Result& result) {
+        if (result.id == summaryId) onSummaryFinished(result);
+        else if (result.id == replyId) onReplyFinished(result);
+    }
+
+protected:
+    // Open the connection while the user types the first question
+    void showEvent(QShowEvent* event) override {
+        QDialog::showEvent(event);
+        transport->warmUp(endpoint);
+    }
+
+private:
+    void onReplyFinished(const ChatTransport::Result& result) {
+        replyId = 0;
+        if (eventStream) {
+            for (const SseEvent& event : parser.finish()) handleEvent(event);
+        }
+
+        const bool ok = result.outcome == ChatTransport::Outcome::Ok;
+        bool complete = ok && !failed;
+        if (stopped) {
+            appendText(" [stopped]");
+        } else if (ok && !eventStream) {
+            // Non-streaming server: the whole completion in one body
+            QJsonDocument doc = QJsonDocument::fromJson(rawBody);
+            QString text;
             if (doc.isObject()) {
+                takeUsage(doc.object());
                 auto choices = doc.object()["choices"].toArray();
                 if (!choices.isEmpty()) {
-                    botText = choices[0].toObject()["message"].toObject()["content"].toString();
+                    text = choices[0].toObject()["message"].toObject()["content"].toString();
                 }
             }
-            if (botText.isEmpty()) botText = QString::fromUtf8(resp);
-            messageView->append("<b>Bot:</b> " + botText);
-            QJsonObject botMsg;
-            botMsg["role"] = "assistant";
-            botMsg["content"] = botText;
-            conversation.append(botMsg);
+            if (text.isEmpty()) {
+                text = QString::fromUtf8(rawBody);
+                complete = false;
+            }
+            appendToken(text);
+        } else if (!ok) {
+            const QString tries = result.attempts > 1
+                ? QString(" after %1 attempts").arg(result.attempts) : QString();
+            if (!botText.isEmpty()) appendText(" [connection lost: " + result.error + "]");
+            else appendText("Error fetching reply (" + result.error + tries + ")");
         }
-        reply->deleteLater();
+
+        if (cache && complete && !botText.isEmpty()) cache->insert(replyKey, botText);
+
+        const double seconds = elapsed.nsecsElapsed() / 1e9;
+        QString timing = firstTokenMs >= 0
+            ? QString("First token %1 ms, %2 chunks in %3 s, sent %4 bytes")
+                  .arg(firstTokenMs).arg(chunks).arg(seconds, 0, 'f', 1)
+                  .arg(context.stats().lastBytes)
+            : QString("No tokens, %1 s").arg(seconds, 0, 'f', 1);
+        if (result.attempts > 1) timing += QString(", %1 attempts").arg(result.attempts);
+        qInfo().noquote() << "[ChatDialog] request" << result.id << timing
+                          << ChatTransport::outcomeName(result.outcome) << "HTTP" << result.httpStatus
+                          << (result.http2 ? "(HTTP/2)" : "");
+
+        ChatRequestMetrics m = newMetrics(stopped ? "cancelled" : ChatTransport::outcomeName(result.outcome));
+        m.id            = result.id;
+        m.attempts      = result.attempts;
+        m.http2         = result.http2;
+        m.requestBytes  = sentBytes;
+        m.responseBytes = std::uint64_t(result.bytesReceived);
+        m.ttfbMs        = double(result.firstByteMs);
+        record(m);
+        completeReply(timing);
     }
 
-private:
-    QTextBrowser             *messageView;
+    // From the cache, or sent
+    void dispatch(const std::vector<ChatMessage>& messages) {
+        if (cache) {
+            replyKey = ResponseCache::key(endpoint, model, messages);
+            QString cached;
+            if (cache->lookup(replyKey, &cached)) {
+                appendToken(cached);
+                const QString timing = QString("Cached reply in %1 ms")
+                                           .arg(elapsed.nsecsElapsed() / 1e6, 0, 'f', 1);
+                qInfo().noquote() << "[ChatDialog]" << timing;
+                record(newMetrics("cached"));
+                completeReply(timing);
+                return;
+            }
+        }
+        post(messages);
+    }
+
+    void post(const std::vector<ChatMessage>& messages) {
+        const QByteArray payload = requestBody(messages, true);
+        context.recordSent(std::uint64_t(payload.size()));
+        sentBytes = std::uint64_t(payload.size());
+        const ChatContext::Stats& stats = context.stats();
+        qInfo().noquote() << QString("[ChatDialog] request %1: %2 bytes (avg %3, max %4)")
+                                 .arg(stats.requests).arg(payload.size())
+                                 .arg(stats.bytesSent / stats.requests).arg(stats.maxBytes);
+
+        rawBody.clear();
+        parser.reset();
+        failed = false;
+        eventStream = false;
+        statusLabel->setText("Waiting for the first token…");
+
+        replyId = transport->post(makeRequest(true), payload);
+    }
+
+    // ── Metrics ──
+    // What is known of the current reply by now; the caller fills in the
+    // transport's side
+    ChatRequestMetrics newMetrics(const char* outcome) const {
+        ChatRequestMetrics m;
+        m.timestampMs   = QDateTime::currentMSecsSinceEpoch();
+        m.model         = model.toStdString();
+        m.outcome       = outcome;
+        m.responseBytes = std::uint64_t(botText.toUtf8().size());
+        m.ttftMs        = double(firstTokenMs);
+        m.totalMs       = elapsed.nsecsElapsed() / 1e6;
+        m.tokensEstimated = usagePrompt < 0 || usageCompletion < 0;
+        m.promptTokens     = usagePrompt >= 0 ? std::uint64_t(usagePrompt) : promptEstimate;
+        m.completionTokens = usageCompletion >= 0
+            ? std::uint64_t(usageCompletion) : ChatContext::estimateTokens(botText.toStdString());
+        return m;
+    }
+
+    void record(const ChatRequestMetrics& m) {
+        telemetry.record(m);
+        summaryLabel->setText(QString::fromStdString(telemetry.summary()));
+        const std::string line = m.toJson();
+        qInfo().noquote() << "[ChatDialog] metrics" << QString::fromStdString(line);
+
+        QDir().mkpath(QFileInfo(metricsPath).absolutePath());
+        QFile file(metricsPath);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            file.write(line.data(), qint64(line.size()));
+            file.write("\n");
+        } else if (!metricsFileFailed) {
+            metricsFileFailed = true;   // once per session is enough
+            qWarning() << "[ChatDialog] cannot append to" << metricsPath << file.errorString();
+        }
+    }
+
+    // Token counts as the server reports them, when it does
+    void takeUsage(const QJsonObject& obj) {
+        const QJsonObject usage = obj["usage"].toObject();
+        if (usage.isEmpty()) return;
+        // JSON numbers are doubles; QJsonValue::toInteger() is Qt 6 only
+        if (usage.contains("prompt_tokens")) {
+            usagePrompt = qint64(usage["prompt_tokens"].toDouble(-1));
+        }
+        if (usage.contains("completion_tokens")) {
+            usageCompletion = qint64(usage["completion_tokens"].toDouble(-1));
+        }
+    }
+
+    // Common end of a reply, however it came
+    void completeReply(const QString& timing) {
+        // A stopped reply is still what the user saw; keep it in context
+        if (!botText.isEmpty()) context.add("assistant", botText.toStdString());
+        statusLabel->setText(timing);
+        sendButton->setEnabled(true);
+        stopButton->setEnabled(false);
+        foldOlderTurns();
+    }
+
+    QNetworkRequest makeRequest(bool stream) const {
+        API API_TOKEN;
+        QNetworkRequest request(endpoint);
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+        if (stream) request.setRawHeader("Accept", "text/event-stream");
+        request.setRawHeader("Authorization", QByteArray("Bearer ") + QByteArray(API_TOKEN.getToken()));
+        request.setRawHeader("HTTP-Referer", QByteArray("my-qt-chat-app"));
+        request.setRawHeader("X-Title", QByteArray("MyQtDesktopChat"));
+        return request;
+    }
+
+    QByteArray requestBody(const std::vector<ChatMessage>& messages, bool stream) const {
+        QJsonArray array;
+        for (const ChatMessage& m : messages) {
+            QJsonObject msg;
+            msg["role"] = QString::fromStdString(m.role);
+            msg["content"] = QString::fromStdString(m.content);
+            array.append(msg);
+        }
+        QJsonObject body;
+        body["model"] = model;
+        body["messages"] = array;
+        body["stream"] = stream;
+        // Token counts in the last event, for the metrics
+        if (stream) body["stream_options"] = QJsonObject{{"include_usage", true}};
+        return QJsonDocument(body).toJson(QJsonDocument::Compact);
+    }
+
+    // Turns that fell out of the budget are summarized in the background;
+    // until the summary is back an excerpt of them is sent instead
+    void foldOlderTurns() {
+        if (summaryId) return;
+        const auto prompt = context.foldRequest(&summaryFoldEnd);
+        if (prompt.empty()) return;
+        summaryBody.clear();
+        summaryId = transport->post(makeRequest(false), requestBody(prompt, false));
+    }
+
+    void onSummaryFinished(const ChatTransport::Result& result) {
+        summaryId = 0;
+        QString text;
+        if (result.outcome == ChatTransport::Outcome::Ok) {
+            const QJsonDocument doc = QJsonDocument::fromJson(summaryBody);
+            const auto choices = doc.object()["choices"].toArray();
+            if (!choices.isEmpty()) {
+                text = choices[0].toObject()["message"].toObject()["content"].toString().trimmed();
+            }
+        }
+        summaryBody.clear();
+        if (text.isEmpty()) {
+            qWarning() << "[ChatDialog] summarizing older turns failed:" << result.error;
+            context.foldFailed();
+        } else {
+            context.setSummary(text.toStdString(), summaryFoldEnd);
+            qInfo() << "[ChatDialog] folded older turns into a summary of"
+                    << text.size() << "chars";
+        }
+    }
+
+    void handleEvent(const SseEvent& event) {
+        if (event.data == "[DONE]") return;
+        const QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(event.data));
+        if (!doc.isObject()) return;
+        const QJsonObject obj = doc.object();
+        if (obj.contains("error")) {
+            failed = true;
+            appendText(" [error: " + obj["error"].toObject()["message"].toString() + "]");
+            return;
+        }
+        takeUsage(obj);   // a usage-only event has no choices
+        const auto choices = obj["choices"].toArray();
+        if (choices.isEmpty()) return;
+        appendToken(choices[0].toObject()["delta"].toObject()["content"].toString());
+    }
+
+    void appendToken(const QString& text) {
+        if (text.isEmpty()) return;
+        if (firstTokenMs < 0) {
+            firstTokenMs = elapsed.elapsed();
+            statusLabel->setText(QString("First token %1 ms").arg(firstTokenMs));
+        }
+        ++chunks;
+        botText += text;
+        appendText(text);
+    }
+
+    // Text at the end of the reply; the view follows it only if the user
+    // has not scrolled up
+    void appendText(const QString& text) {
+        transcript->appendText(botRow, text);
+    }
+
+    ChatTranscriptModel      *transcript;
+    ChatTranscriptView       *messageView;
     QLineEdit                *inputLine;
     QPushButton              *sendButton;
-    QNetworkAccessManager    *networkManager;
-    QJsonArray                conversation;
+    QPushButton              *stopButton;
+    QLabel                   *statusLabel;
+    QLabel                   *summaryLabel;
+    ChatTransport            *transport;
+    QUrl                      endpoint;
+    QString                   model;
+    ChatContext               context;
+    quint64                   summaryId = 0;
+    std::uint64_t             summaryFoldEnd = 0;
+    QByteArray                summaryBody;
+    Grounding                 grounding;
+    std::shared_ptr<ResponseCache> cache;
+    ChatTelemetry             telemetry;
+    QString                   metricsPath;
+    bool                      metricsFileFailed = false;
+
+    // The reply being streamed
+    quint64                   replyId      = 0;
+    bool                      eventStream  = false;
+    SseParser                 parser;
+    QString                   botText;
+    int                       botRow       = -1;
+    QByteArray                rawBody;
+    QElapsedTimer             elapsed;
+    qint64                    firstTokenMs = -1;
+    int                       chunks       = 0;
+    bool                      stopped      = false;
+    bool                      failed       = false;   // error event mid-stream
+    QByteArray                replyKey;
+    std::uint64_t             sentBytes      = 0;
+    std::uint64_t             promptEstimate = 0;
+    qint64                    usagePrompt     = -1;   // from the server, -1 if not reported
+    qint64                    usageCompletion = -1;
 };
 
 #endif // CHATDIALOG_H
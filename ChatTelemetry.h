@@ -0,0 +1,129 @@
+#ifndef CHATTELEMETRY_H
+#define CHATTELEMETRY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "LatencyHistogram.h"
+
+// What one chat reply cost, as ChatDialog measured it. Times are from the
+// moment the question was sent; -1 when the event never happened.
+//   ttfb   first response byte: network, queueing and prompt processing
+//   ttft   first token of the answer
+//   total  last byte, so total - ttft is the model generating
+// Token counts are the server's when it reports usage, otherwise
+// estimated from bytes (tokensEstimated).
+struct ChatRequestMetrics {
+    std::uint64_t id               = 0;
+    std::int64_t  timestampMs      = 0;   // wall clock, ms since epoch
+    std::string   model;
+    std::string   outcome;               // "ok", "cached" or another transport outcome
+    int           attempts         = 0;
+    bool          http2            = false;
+    std::uint64_t requestBytes     = 0;
+    std::uint64_t responseBytes    = 0;
+    std::uint64_t promptTokens     = 0;
+    std::uint64_t completionTokens = 0;
+    bool          tokensEstimated  = true;
+    double        ttfbMs           = -1;
+    double        ttftMs           = -1;
+    double        totalMs          = 0;
+
+    // Generation speed once the first token is out; 0 if unknown
+    double tokensPerSecond() const noexcept {
+        const double generating = totalMs - ttftMs;
+        return (ttftMs >= 0 && generating > 1.0 && completionTokens > 1)
+            ? double(completionTokens - 1) * 1000.0 / generating : 0.0;
+    }
+
+    // One line of the metrics file
+    std::string toJson() const {
+        char line[640];
+        std::snprintf(line, sizeof line,
+                      "{\"ts\":%lld,\"id\":%llu,\"model\":\"%s\",\"outcome\":\"%s\",\"attempts\":%d,"
+                      "\"http2\":%s,\"request_bytes\":%llu,\"response_bytes\":%llu,"
+                      "\"prompt_tokens\":%llu,\"completion_tokens\":%llu,\"tokens_estimated\":%s,"
+                      "\"ttfb_ms\":%.1f,\"ttft_ms\":%.1f,\"total_ms\":%.1f,\"tokens_per_s\":%.1f}",
+                      static_cast<long long>(timestampMs), static_cast<unsigned long long>(id),
+                      escaped(model).c_str(), escaped(outcome).c_str(), attempts,
+                      http2 ? "true" : "false", static_cast<unsigned long long>(requestBytes),
+                      static_cast<unsigned long long>(responseBytes),
+                      static_cast<unsigned long long>(promptTokens),
+                      static_cast<unsigned long long>(completionTokens),
+                      tokensEstimated ? "true" : "false", ttfbMs, ttftMs, totalMs, tokensPerSecond());
+        return line;
+    }
+
+private:
+    static std::string escaped(const std::string& text) {
+        std::string out;
+        for (char c : text.substr(0, 120)) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) out += c;
+        }
+        return out;
+    }
+};
+
+// Running totals over the session for the dialog's summary line. Replies
+// from the cache are only counted; the latency figures are about requests
+// that went out.
+class ChatTelemetry {
+public:
+    void record(const ChatRequestMetrics& m) {
+        if (m.outcome == "cached") {
+            ++local_;
+            return;
+        }
+        ++requests_;
+        if (m.outcome != "ok" && m.outcome != "cancelled") ++failed_;
+        if (m.ttfbMs >= 0) ttfb_.record(m.ttfbMs);
+        if (m.ttftMs >= 0) ttft_.record(m.ttftMs);
+        total_.record(m.totalMs);
+        promptTokens_ += m.promptTokens;
+        const double rate = m.tokensPerSecond();
+        if (rate > 0) {
+            rateSum_ += rate;
+            ++rated_;
+        }
+    }
+
+    std::uint64_t requests() const noexcept { return requests_; }
+    std::uint64_t local() const noexcept { return local_; }
+    const LatencyHistogram& ttfb() const noexcept { return ttfb_; }
+    const LatencyHistogram& ttft() const noexcept { return ttft_; }
+    const LatencyHistogram& total() const noexcept { return total_; }
+    double meanTokensPerSecond() const noexcept { return rated_ ? rateSum_ / double(rated_) : 0.0; }
+    double meanPromptTokens() const noexcept {
+        return requests_ ? double(promptTokens_) / double(requests_) : 0.0;
+    }
+
+    // "4 sent (1 failed), 2 from cache · first byte p50 <= 500 ms · first token
+    //  p50 <= 1000 ms · total p50 <= 5000 ms · 41 tok/s · prompt ~820 tokens"
+    std::string summary() const {
+        char line[320];
+        std::snprintf(line, sizeof line,
+                      "%llu sent (%llu failed), %llu from cache \xC2\xB7 first byte p50 <= %.0f ms"
+                      " \xC2\xB7 first token p50 <= %.0f ms \xC2\xB7 total p50 <= %.0f ms"
+                      " \xC2\xB7 %.0f tok/s \xC2\xB7 prompt ~%.0f tokens",
+                      static_cast<unsigned long long>(requests_), static_cast<unsigned long long>(failed_),
+                      static_cast<unsigned long long>(local_), ttfb_.percentile(0.5),
+                      ttft_.percentile(0.5), total_.percentile(0.5), meanTokensPerSecond(),
+                      meanPromptTokens());
+        return line;
+    }
+
+private:
+    LatencyHistogram ttfb_;
+    LatencyHistogram ttft_;
+    LatencyHistogram total_;
+    std::uint64_t    requests_     = 0;
+    std::uint64_t    failed_       = 0;
+    std::uint64_t    local_        = 0;
+    std::uint64_t    promptTokens_ = 0;
+    std::uint64_t    rated_        = 0;
+    double           rateSum_      = 0.0;
+};
+
+#endif // CHATTELEMETRY_H
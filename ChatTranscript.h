@@ -0,0 +1,101 @@
+#ifndef CHATTRANSCRIPT_H
+#define CHATTRANSCRIPT_H
+
+#include <QAbstractListModel>
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QString>
+#include <QTextLayout>
+
+#include <vector>
+
+// ── ChatTranscriptModel ──
+// The chat as a list of messages. The reply being streamed grows in place
+// through appendText(), which reports its row as changed.
+class ChatTranscriptModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Roles { SpeakerRole = Qt::UserRole + 1, TextRole };
+
+    explicit ChatTranscriptModel(QObject* parent = nullptr);
+
+    // Row of the new message
+    int append(const QString& speaker, const QString& text);
+    void appendText(int row, const QString& text);
+    void clear();
+
+    const QString& speakerAt(int row) const { return messages_[std::size_t(row)].speaker; }
+    const QString& textAt(int row) const { return messages_[std::size_t(row)].text; }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Message {
+        QString speaker;
+        QString text;
+    };
+    std::vector<Message> messages_;
+};
+
+// ── ChatTranscriptView ──
+// Shows a ChatTranscriptModel, laying out only what it needs: a message
+// is laid out once when it arrives (to learn its height) and again only
+// when it changes or its layout has been evicted from the cache of recent
+// ones. When the width changes, every height becomes an estimate from the
+// text length and only the messages on screen are laid out; the others
+// are measured as they scroll into view. Tops of all messages are kept as
+// prefix sums, so appending is O(1) whatever the length of the session,
+// and painting finds the first visible message by binary search.
+//
+// New text scrolls into view only if the view was already at the bottom.
+// Copy from the context menu (one message or the whole transcript).
+class ChatTranscriptView : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    static constexpr int kCachedLayouts = 256;
+
+    explicit ChatTranscriptView(QWidget* parent = nullptr);
+
+    void setModel(ChatTranscriptModel* model);
+    ChatTranscriptModel* model() const noexcept { return model_; }
+
+    int rowAt(int y) const;   // viewport coordinates; -1 if none
+    void scrollToBottom();
+    // Layouts made so far and those cached now (for the tests)
+    quint64 layoutsBuilt() const noexcept { return layoutsBuilt_; }
+    int cachedLayouts() const { return layouts_.size(); }
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void contextMenuEvent(QContextMenuEvent* event) override;
+
+private slots:
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+    void onModelReset();
+
+private:
+    QTextLayout* layoutFor(int row) const;
+    int measure(int row) const;
+    void relayoutAll();
+    bool measureVisible();
+    void updateScrollRange(bool follow);
+    bool atBottom() const;
+    int textWidth() const;
+    qint64 contentHeight() const;
+
+    ChatTranscriptModel*              model_ = nullptr;
+    std::vector<int>                  heights_;
+    std::vector<char>                 measured_;      // heights_ laid out, not estimated
+    std::vector<qint64>               tops_;          // prefix sums of heights_
+    int                               layoutWidth_ = -1;
+    mutable QCache<int, QTextLayout>  layouts_;       // by row, at layoutWidth_
+    mutable quint64                   layoutsBuilt_ = 0;
+};
+
+#endif // CHATTRANSCRIPT_H
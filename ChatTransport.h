@@ -0,0 +1,123 @@
+#ifndef CHATTRANSPORT_H
+#define CHATTRANSPORT_H
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QNetworkReply>
+
+#include <array>
+#include <random>
+#include <unordered_map>
+
+#include "LatencyHistogram.h"
+#include "RetryPolicy.h"
+
+class QTimer;
+
+// HTTP posts for the chat, each with its own id so any number can be in
+// flight (a streamed answer and a background summary, say) and every
+// signal says which request it belongs to.
+//
+// Each attempt has two timeouts: connectTimeoutMs until the response
+// headers arrive, then readTimeoutMs between chunks, so a long stream is
+// fine but a stalled one is not. Failed attempts are retried per
+// RetryPolicy as long as nothing has been delivered yet. Body data of an
+// HTTP error answer is kept for the Result, not delivered.
+//
+// All requests share one QNetworkAccessManager with HTTP/2 allowed, so
+// they multiplex over one connection per host; warmUp() opens it ahead
+// of the first question.
+//
+// Attempt latencies are kept per outcome (statsSummary()).
+// Options come from ART_CHAT_CONNECT_TIMEOUT_MS, ART_CHAT_READ_TIMEOUT_MS
+// and ART_CHAT_MAX_ATTEMPTS when set. GUI thread only.
+class ChatTransport : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Outcome { Ok, HttpError, Timeout, NetworkError, Cancelled };
+    static constexpr std::size_t kOutcomes = 5;
+
+    struct Options {
+        int         connectTimeoutMs = 15000;   // until the response headers
+        int         readTimeoutMs    = 30000;   // between chunks
+        RetryPolicy retry;
+    };
+
+    struct Result {
+        quint64    id            = 0;
+        Outcome    outcome       = Outcome::Ok;
+        int        httpStatus    = 0;
+        int        attempts      = 0;
+        qint64     elapsedMs     = 0;       // all attempts and backoff
+        qint64     firstByteMs   = -1;      // since post(), of the last attempt
+        qint64     bytesReceived = 0;       // delivered to dataReceived()
+        bool       http2         = false;   // of the last attempt
+        QString    error;                   // empty when Ok
+        QByteArray errorBody;               // of an HTTP error answer, clipped
+    };
+
+    explicit ChatTransport(QObject* parent = nullptr);
+    ~ChatTransport() override;
+
+    static Options optionsFromEnvironment();
+    void setOptions(const Options& options) { options_ = options; }
+    const Options& options() const noexcept { return options_; }
+
+    quint64 post(QNetworkRequest request, const QByteArray& body);
+    // finished() with Outcome::Cancelled follows right away
+    void abort(quint64 id);
+    bool isActive(quint64 id) const { return pending_.count(id) != 0; }
+
+    void warmUp(const QUrl& endpoint);
+
+    static const char* outcomeName(Outcome outcome) noexcept;
+    const LatencyHistogram& latency(Outcome outcome) const noexcept {
+        return latency_[std::size_t(outcome)];
+    }
+    QString statsSummary() const;
+
+signals:
+    void dataReceived(quint64 id, const QByteArray& chunk, bool eventStream);
+    void retrying(quint64 id, int nextAttempt, int delayMs, const QString& reason);
+    void finished(const ChatTransport::Result& result);
+
+private:
+    struct Pending {
+        QNetworkRequest         request;
+        QByteArray              body;
+        QPointer<QNetworkReply> reply;
+        QTimer*                 timer = nullptr;
+        QElapsedTimer           total;
+        QElapsedTimer           attempt;
+        int                     attempts      = 0;
+        qint64                  firstByteMs   = -1;      // of the current attempt, since post()
+        qint64                  bytesReceived = 0;
+        bool                    headers       = false;   // of the current attempt
+        bool                    delivered     = false;   // data handed out: no more retries
+        bool                    timedOut      = false;
+        bool                    cancelled     = false;
+        QByteArray              errorBody;
+    };
+
+    void startAttempt(quint64 id);
+    void onHeaders(quint64 id, QNetworkReply* reply);
+    bool takeData(quint64 id, QNetworkReply* reply);
+    void onTimeout(quint64 id);
+    void onAttemptFinished(quint64 id, QNetworkReply* reply);
+    void complete(quint64 id, Result result);
+
+    QNetworkAccessManager*                manager_;
+    Options                               options_;
+    std::unordered_map<quint64, Pending>  pending_;
+    quint64                               nextId_ = 1;
+    std::array<LatencyHistogram, kOutcomes> latency_;
+    std::mt19937                          random_;
+    quint64                               retries_      = 0;
+    quint64                               http2Replies_ = 0;
+};
+
+#endif // CHATTRANSPORT_H
@@ -2,8 +2,17 @@
 #define COMMAND_H
 
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include <variant>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include "ArtRepositoryInterface.h"
 #include "ArtObject.h"
+#include "Painting.h"
+#include "Sculpture.h"
+#include "DigitalArt.h"
 
 
 class Command {
@@ -15,18 +24,152 @@ public:
 
     // Undo the action
     virtual void undo() = 0;
+
+    // Approximate bytes this command keeps alive, for the undo budget
+    virtual std::size_t memoryCost() const noexcept { return sizeof(Command); }
+
+    // Fold 'next' (executed right after this one) into this command so
+    // one undo reverts both. Returns false if they cannot be merged.
+    virtual bool mergeWith(const Command& /*next*/) { return false; }
+
+    // Set the executed state without touching the repository, for a
+    // command rebuilt from a saved history (see UndoJournal)
+    virtual void markExecuted(bool executed) noexcept = 0;
 };
 
 using CommandPtr = std::unique_ptr<Command>;
 
+// Rough heap + object size of an art object held by a command
+inline std::size_t artMemoryCost(const std::shared_ptr<ArtObject>& art) noexcept {
+    if (!art) return 0;
+    return sizeof(ArtObject) + 32
+         + art->getName().capacity()
+         + art->getDescription().capacity()
+         + art->getLocation().capacity()
+         + static_cast<std::size_t>(art->getImagePath().size()) * sizeof(QChar);
+}
+
+// Same dynamic type and field values. A command restored from a saved
+// history holds equal copies, not the repository's objects.
+inline bool sameArt(const ArtObject& a, const ArtObject& b) {
+    if (&a == &b) return true;
+    if (a.getType() != b.getType() || a.getName() != b.getName()
+        || a.getDescription() != b.getDescription() || a.getPrice() != b.getPrice()
+        || a.getLocation() != b.getLocation() || a.getImagePath() != b.getImagePath()) {
+        return false;
+    }
+    if (auto p = dynamic_cast<const Painting*>(&a)) {
+        auto q = dynamic_cast<const Painting*>(&b);
+        return q && p->getCanvasType() == q->getCanvasType();
+    }
+    if (auto p = dynamic_cast<const Sculpture*>(&a)) {
+        auto q = dynamic_cast<const Sculpture*>(&b);
+        return q && p->getMaterial() == q->getMaterial();
+    }
+    if (auto p = dynamic_cast<const DigitalArt*>(&a)) {
+        auto q = dynamic_cast<const DigitalArt*>(&b);
+        return q && p->getSoftware() == q->getSoftware()
+            && p->getResolutionX() == q->getResolutionX()
+            && p->getResolutionY() == q->getResolutionY();
+    }
+    return true;
+}
+
+constexpr std::size_t kArtNotFound = static_cast<std::size_t>(-1);
+
+// Position of 'art' in the repository: the object itself, else an equal
+// record, looking at 'hint' first. kArtNotFound if neither is there.
+inline std::size_t findArt(const ArtRepositoryInterface& repo,
+                           const std::shared_ptr<ArtObject>& art, std::size_t hint) {
+    if (!art) return kArtNotFound;
+    const std::size_t n = repo.size();
+    if (hint < n && repo.get(hint) == art) return hint;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (repo.get(i) == art) return i;
+    }
+    if (hint < n) {
+        if (auto at = repo.get(hint); at && sameArt(*at, *art)) return hint;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (auto at = repo.get(i); at && sameArt(*at, *art)) return i;
+    }
+    return kArtNotFound;
+}
+
+// findArt() for a group: result[k] is where arts[k] is, or kArtNotFound.
+// Each position is used at most once; 'first' is where arts[0] is
+// expected, with the rest following it.
+inline std::vector<std::size_t> findArts(const ArtRepositoryInterface& repo,
+                                         const std::vector<std::shared_ptr<ArtObject>>& arts,
+                                         std::size_t first) {
+    std::vector<std::size_t> found(arts.size(), kArtNotFound);
+    const std::size_t n = repo.size();
+    std::vector<bool> used(n, false);
+
+    // By identity, wherever they ended up
+    std::unordered_map<const ArtObject*, std::size_t> mine;
+    mine.reserve(arts.size());
+    for (std::size_t k = 0; k < arts.size(); ++k) {
+        if (arts[k]) mine.emplace(arts[k].get(), k);
+    }
+    std::size_t missing = arts.size();
+    for (std::size_t i = 0; i < n && missing > 0; ++i) {
+        auto it = mine.find(repo.get(i).get());
+        if (it != mine.end() && found[it->second] == kArtNotFound) {
+            found[it->second] = i;
+            used[i] = true;
+            --missing;
+        }
+    }
+    if (missing == 0) return found;
+
+    // By value: the expected position first, then anywhere
+    std::unordered_map<std::string, std::vector<std::size_t>> byName;
+    for (std::size_t k = 0; k < arts.size(); ++k) {
+        if (found[k] != kArtNotFound || !arts[k]) continue;
+        const std::size_t i = first + k;
+        if (i < n && !used[i]) {
+            if (auto at = repo.get(i); at && sameArt(*at, *arts[k])) {
+                found[k] = i;
+                used[i] = true;
+                continue;
+            }
+        }
+        byName[arts[k]->getName()].push_back(k);
+    }
+    if (byName.empty()) return found;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (used[i]) continue;
+        auto at = repo.get(i);
+        if (!at) continue;
+        auto bucket = byName.find(at->getName());
+        if (bucket == byName.end()) continue;
+        for (std::size_t& k : bucket->second) {
+            if (k != kArtNotFound && sameArt(*at, *arts[k])) {
+                found[k] = i;
+                used[i] = true;
+                k = kArtNotFound;
+                break;
+            }
+        }
+    }
+    return found;
+}
+
 class AddCommand : public Command {
 public:
     AddCommand(std::shared_ptr<ArtRepositoryInterface> repo,
                std::shared_ptr<ArtObject> art)
         : repo_(std::move(repo)), art_(std::move(art)), executed_(false) {}
 
+    // Restored from a saved history: 'index' is where the art was appended
+    AddCommand(std::shared_ptr<ArtRepositoryInterface> repo,
+               std::shared_ptr<ArtObject> art, std::size_t index)
+        : repo_(std::move(repo)), art_(std::move(art)), index_(index), executed_(false) {}
+
     void execute() override {
         if (executed_) return;
+        index_ = repo_->size();
         repo_->add(art_);
         executed_ = true;
     }
@@ -34,19 +177,88 @@ public:
     void undo() override {
         if (!executed_) return;
 
-        for (std::size_t i = 0; i < repo_->size(); ++i) {
-            auto candidate = repo_->get(i);
-            if (candidate == art_) {
-                repo_->remove(i);
-                break;
-            }
+        // Everything pushed later has been undone, so the art is usually
+        // still where it was appended. If it is gone, leave the repo alone.
+        const std::size_t found = findArt(*repo_, art_, index_);
+        if (found != kArtNotFound) {
+            // A restored command holds an equal copy, not the repo's object:
+            // adopt the object so redo re-adds exactly what was removed
+            art_ = repo_->get(found);
+            repo_->remove(found);
         }
         executed_ = false;
     }
 
+    void markExecuted(bool executed) noexcept override { executed_ = executed; }
+
+    std::size_t memoryCost() const noexcept override {
+        return sizeof(*this) + artMemoryCost(art_);
+    }
+
+    const std::shared_ptr<ArtObject>& art() const noexcept { return art_; }
+    std::size_t index() const noexcept { return index_; }
+
 private:
     std::shared_ptr<ArtRepositoryInterface> repo_;
     std::shared_ptr<ArtObject> art_;
+    std::size_t index_ = 0;
+    bool executed_;
+};
+
+// ── AddManyCommand ──
+class AddManyCommand : public Command {
+public:
+    AddManyCommand(std::shared_ptr<ArtRepositoryInterface> repo,
+                   std::vector<std::shared_ptr<ArtObject>> arts)
+        : repo_(std::move(repo)), arts_(std::move(arts)), executed_(false) {}
+
+    // Already in the repository, or restored from a saved history:
+    // 'index' is where the first one was appended
+    AddManyCommand(std::shared_ptr<ArtRepositoryInterface> repo,
+                   std::vector<std::shared_ptr<ArtObject>> arts, std::size_t index)
+        : repo_(std::move(repo)), arts_(std::move(arts)), index_(index), executed_(false) {}
+
+    void execute() override {
+        if (executed_) return;
+        index_ = repo_->size();
+        repo_->addMany(arts_);
+        executed_ = true;
+    }
+
+    void undo() override {
+        if (!executed_) return;
+
+        // Find the objects wherever they ended up (other records may have
+        // been appended in between, e.g. during a bulk import). A restored
+        // command holds equal copies: adopt the repo's objects so redo
+        // re-adds exactly what was removed. Records that are gone stay gone.
+        const std::vector<std::size_t> positions = findArts(*repo_, arts_, index_);
+        std::vector<std::size_t> found;
+        found.reserve(positions.size());
+        for (std::size_t k = 0; k < positions.size(); ++k) {
+            if (positions[k] == kArtNotFound) continue;
+            arts_[k] = repo_->get(positions[k]);
+            found.push_back(positions[k]);
+        }
+        repo_->removeMany(std::move(found));
+        executed_ = false;
+    }
+
+    void markExecuted(bool executed) noexcept override { executed_ = executed; }
+
+    std::size_t memoryCost() const noexcept override {
+        std::size_t bytes = sizeof(*this) + arts_.capacity() * sizeof(std::shared_ptr<ArtObject>);
+        for (const auto& art : arts_) bytes += artMemoryCost(art);
+        return bytes;
+    }
+
+    const std::vector<std::shared_ptr<ArtObject>>& arts() const noexcept { return arts_; }
+    std::size_t index() const noexcept { return index_; }
+
+private:
+    std::shared_ptr<ArtRepositoryInterface> repo_;
+    std::vector<std::shared_ptr<ArtObject>> arts_;
+    std::size_t index_ = 0;
     bool executed_;
 };
 
@@ -57,6 +269,12 @@ public:
     RemoveCommand(std::shared_ptr<ArtRepositoryInterface> repo, std::size_t index)
         : repo_(std::move(repo)), index_(index), executed_(false) {}
 
+    // Restored from a saved history
+    RemoveCommand(std::shared_ptr<ArtRepositoryInterface> repo, std::size_t index,
+                  std::shared_ptr<ArtObject> removedArt)
+        : repo_(std::move(repo)), index_(index),
+        removedArt_(std::move(removedArt)), executed_(false) {}
+
     void execute() override {
         if (executed_) return;
         // Save the pointer so we can re-add on undo
@@ -76,6 +294,15 @@ public:
         executed_ = false;
     }
 
+    void markExecuted(bool executed) noexcept override { executed_ = executed; }
+
+    std::size_t memoryCost() const noexcept override {
+        return sizeof(*this) + artMemoryCost(removedArt_);
+    }
+
+    std::size_t index() const noexcept { return index_; }
+    const std::shared_ptr<ArtObject>& removedArt() const noexcept { return removedArt_; }
+
 private:
     std::shared_ptr<ArtRepositoryInterface> repo_;
     std::size_t index_;
@@ -83,6 +310,83 @@ private:
     bool executed_;
 };
 
+// ── RemoveManyCommand ──
+class RemoveManyCommand : public Command {
+public:
+    // ‘indices’ are positions in the repo when this command was created
+    RemoveManyCommand(std::shared_ptr<ArtRepositoryInterface> repo,
+                      std::vector<std::size_t> indices)
+        : repo_(std::move(repo)), indices_(std::move(indices)), executed_(false) {}
+
+    // Restored from a saved history
+    RemoveManyCommand(std::shared_ptr<ArtRepositoryInterface> repo,
+                      std::vector<std::size_t> indices,
+                      std::vector<std::shared_ptr<ArtObject>> removedArt)
+        : repo_(std::move(repo)), indices_(std::move(indices)),
+        removedArt_(std::move(removedArt)), executed_(false) {}
+
+    void execute() override {
+        if (executed_) return;
+        if (removedArt_.empty()) {
+            // First run: remember what goes, in repository order
+            std::sort(indices_.begin(), indices_.end());
+            indices_.erase(std::unique(indices_.begin(), indices_.end()), indices_.end());
+            std::vector<std::size_t> valid;
+            for (std::size_t index : indices_) {
+                if (auto art = repo_->get(index)) {
+                    valid.push_back(index);
+                    removedArt_.push_back(art);
+                }
+            }
+            indices_ = std::move(valid);
+            repo_->removeMany(indices_);
+        } else {
+            // Redo: undo re-appended the objects, normally as the tail, but
+            // find them wherever they are and remove only those
+            const std::size_t n = repo_->size();
+            const std::vector<std::size_t> found =
+                findArts(*repo_, removedArt_, n - std::min(n, removedArt_.size()));
+            std::vector<std::size_t> positions;
+            positions.reserve(found.size());
+            for (std::size_t k = 0; k < found.size(); ++k) {
+                if (found[k] == kArtNotFound) continue;
+                removedArt_[k] = repo_->get(found[k]);
+                positions.push_back(found[k]);
+            }
+            repo_->removeMany(std::move(positions));
+        }
+        executed_ = true;
+    }
+
+    void undo() override {
+        if (!executed_) return;
+        // Same as RemoveCommand: re-append at the end
+        ArtRepositoryInterface::BatchScope batch(*repo_);
+        for (const auto& art : removedArt_) repo_->add(art);
+        executed_ = false;
+    }
+
+    void markExecuted(bool executed) noexcept override { executed_ = executed; }
+
+    const std::vector<std::size_t>& indices() const noexcept { return indices_; }
+    const std::vector<std::shared_ptr<ArtObject>>& removedArt() const noexcept {
+        return removedArt_;
+    }
+
+    std::size_t memoryCost() const noexcept override {
+        std::size_t bytes = sizeof(*this) + indices_.capacity() * sizeof(std::size_t)
+                          + removedArt_.capacity() * sizeof(std::shared_ptr<ArtObject>);
+        for (const auto& art : removedArt_) bytes += artMemoryCost(art);
+        return bytes;
+    }
+
+private:
+    std::shared_ptr<ArtRepositoryInterface> repo_;
+    std::vector<std::size_t> indices_;
+    std::vector<std::shared_ptr<ArtObject>> removedArt_;
+    bool executed_;
+};
+
 // ── EditCommand ──
 class EditCommand : public Command {
 public:
@@ -109,6 +413,16 @@ public:
         executed_ = false;
     }
 
+    void markExecuted(bool executed) noexcept override { executed_ = executed; }
+
+    std::size_t memoryCost() const noexcept override {
+        return sizeof(*this) + artMemoryCost(oldArt_) + artMemoryCost(newArt_);
+    }
+
+    std::size_t index() const noexcept { return index_; }
+    const std::shared_ptr<ArtObject>& oldArt() const noexcept { return oldArt_; }
+    const std::shared_ptr<ArtObject>& newArt() const noexcept { return newArt_; }
+
 private:
     std::shared_ptr<ArtRepositoryInterface> repo_;
     std::size_t index_;
@@ -117,4 +431,184 @@ private:
     bool executed_;
 };
 
+// ── FieldEditCommand ──
+// Like EditCommand, but only remembers the fields that changed. Applying
+// it replaces the record with an edited clone, so objects already handed
+// out (e.g. in a search snapshot) are never modified in place.
+enum class ArtField {
+    Name, Description, Price, Location,
+    CanvasType,                       // Painting
+    Material,                         // Sculpture
+    Software, ResolutionX, ResolutionY // DigitalArt
+};
+
+using FieldValue = std::variant<std::string, double, int>;
+
+struct FieldDelta {
+    ArtField   field;
+    FieldValue oldValue;
+    FieldValue newValue;
+};
+
+// Set one field on 'art'; false if its type has no such field
+inline bool applyField(ArtObject& art, ArtField field, const FieldValue& value) {
+    auto text   = std::get_if<std::string>(&value);
+    auto number = std::get_if<double>(&value);
+    auto whole  = std::get_if<int>(&value);
+
+    switch (field) {
+    case ArtField::Name:        if (text) art.setName(*text);        return text != nullptr;
+    case ArtField::Description: if (text) art.setDescription(*text); return text != nullptr;
+    case ArtField::Location:    if (text) art.setLocation(*text);    return text != nullptr;
+    case ArtField::Price:       if (number) art.setPrice(*number);   return number != nullptr;
+    case ArtField::CanvasType:
+        if (auto p = dynamic_cast<Painting*>(&art); p && text) {
+            p->setCanvasType(*text);
+            return true;
+        }
+        return false;
+    case ArtField::Material:
+        if (auto sc = dynamic_cast<Sculpture*>(&art); sc && text) {
+            sc->setMaterial(*text);
+            return true;
+        }
+        return false;
+    case ArtField::Software:
+        if (auto d = dynamic_cast<DigitalArt*>(&art); d && text) {
+            d->setSoftware(*text);
+            return true;
+        }
+        return false;
+    case ArtField::ResolutionX:
+        if (auto d = dynamic_cast<DigitalArt*>(&art); d && whole) {
+            d->setResolution(*whole, d->getResolutionY());
+            return true;
+        }
+        return false;
+    case ArtField::ResolutionY:
+        if (auto d = dynamic_cast<DigitalArt*>(&art); d && whole) {
+            d->setResolution(d->getResolutionX(), *whole);
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
+class FieldEditCommand : public Command {
+public:
+    FieldEditCommand(std::shared_ptr<ArtRepositoryInterface> repo,
+                     std::size_t index,
+                     std::vector<FieldDelta> deltas)
+        : repo_(std::move(repo)), index_(index),
+        deltas_(std::move(deltas)), executed_(false) {}
+
+    // Single-field convenience
+    FieldEditCommand(std::shared_ptr<ArtRepositoryInterface> repo,
+                     std::size_t index, ArtField field,
+                     FieldValue oldValue, FieldValue newValue)
+        : FieldEditCommand(std::move(repo), index,
+                           {FieldDelta{field, std::move(oldValue), std::move(newValue)}}) {}
+
+    void execute() override {
+        if (executed_) return;
+        apply(false);
+        executed_ = true;
+    }
+
+    void undo() override {
+        if (!executed_) return;
+        apply(true);
+        executed_ = false;
+    }
+
+    void markExecuted(bool executed) noexcept override { executed_ = executed; }
+
+    std::size_t memoryCost() const noexcept override {
+        std::size_t bytes = sizeof(*this) + deltas_.capacity() * sizeof(FieldDelta);
+        for (const auto& d : deltas_) bytes += heapBytes(d.oldValue) + heapBytes(d.newValue);
+        return bytes;
+    }
+
+    // Another edit of exactly the same fields of the same record: keep
+    // our old values and take its new ones
+    bool mergeWith(const Command& next) override {
+        auto other = dynamic_cast<const FieldEditCommand*>(&next);
+        if (!other || other->repo_ != repo_ || other->index_ != index_
+            || other->deltas_.size() != deltas_.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < deltas_.size(); ++i) {
+            if (deltas_[i].field != other->deltas_[i].field) return false;
+        }
+        for (std::size_t i = 0; i < deltas_.size(); ++i) {
+            deltas_[i].newValue = other->deltas_[i].newValue;
+        }
+        return true;
+    }
+
+    std::size_t index() const noexcept { return index_; }
+    const std::vector<FieldDelta>& deltas() const noexcept { return deltas_; }
+
+private:
+    static std::size_t heapBytes(const FieldValue& v) noexcept {
+        auto str = std::get_if<std::string>(&v);
+        return str ? str->capacity() : 0;
+    }
+
+    void apply(bool useOld) {
+        auto current = repo_->get(index_);
+        if (!current) return;
+        auto edited = current->clone();
+        for (const auto& d : deltas_) {
+            applyField(*edited, d.field, useOld ? d.oldValue : d.newValue);
+        }
+        repo_->update(index_, edited);
+    }
+
+    std::shared_ptr<ArtRepositoryInterface> repo_;
+    std::size_t index_;
+    std::vector<FieldDelta> deltas_;
+    bool executed_;
+};
+
+// ── CompositeCommand ──
+// Runs its children as one undoable unit. The repository is held in a
+// batch meanwhile, so observers see a single repositoryChanged().
+class CompositeCommand : public Command {
+public:
+    explicit CompositeCommand(std::shared_ptr<ArtRepositoryInterface> repo)
+        : repo_(std::move(repo)) {}
+
+    void add(CommandPtr cmd) { children_.push_back(std::move(cmd)); }
+    bool empty() const noexcept { return children_.empty(); }
+    std::size_t size() const noexcept { return children_.size(); }
+
+    void execute() override {
+        ArtRepositoryInterface::BatchScope batch(*repo_);
+        for (auto& cmd : children_) cmd->execute();
+    }
+
+    void undo() override {
+        ArtRepositoryInterface::BatchScope batch(*repo_);
+        for (auto it = children_.rbegin(); it != children_.rend(); ++it) (*it)->undo();
+    }
+
+    void markExecuted(bool executed) noexcept override {
+        for (auto& cmd : children_) cmd->markExecuted(executed);
+    }
+
+    std::size_t memoryCost() const noexcept override {
+        std::size_t bytes = sizeof(*this) + children_.capacity() * sizeof(CommandPtr);
+        for (const auto& cmd : children_) bytes += cmd->memoryCost();
+        return bytes;
+    }
+
+    const std::vector<CommandPtr>& children() const noexcept { return children_; }
+
+private:
+    std::shared_ptr<ArtRepositoryInterface> repo_;
+    std::vector<CommandPtr> children_;
+};
+
 #endif // COMMAND_H
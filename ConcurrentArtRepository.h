@@ -0,0 +1,70 @@
+#ifndef CONCURRENTARTREPOSITORY_H
+#define CONCURRENTARTREPOSITORY_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <QString>
+
+#include "ArtObject.h"
+#include "ArtRepositoryInterface.h"
+#include "ArtSnapshot.h"
+
+// In-memory repository whose readers never wait for its writer.
+//
+// The items live in an immutable, chunked ArtSnapshot. Every mutation
+// builds the next version, sharing all untouched chunks with the current
+// one, and publishes it with an atomic pointer swap (RCU style). Old
+// versions stay alive for as long as some reader still holds them.
+//
+//  - snapshot() is O(1) and may be called from any thread.
+//  - Mutations are serialized; add/update copy one chunk plus the chunk
+//    table, remove/removeMany rebuild from the first affected chunk on.
+//  - get()/size() read the writer's current version and, like the
+//    mutations, belong to the writer thread (the GUI thread here).
+//    Other threads take a snapshot() instead.
+//  - Observers are notified on the writer thread after publishing.
+class ConcurrentArtRepository : public ArtRepositoryInterface {
+public:
+    using ArtPtr = std::shared_ptr<ArtObject>;
+
+    ConcurrentArtRepository();
+    ~ConcurrentArtRepository() override = default;
+
+    // ── In-memory CRUD ──
+    void add(const ArtPtr& art) override;
+    void addMany(const std::vector<ArtPtr>& arts) override;
+    bool update(std::size_t index, const ArtPtr& art) noexcept override;
+    bool remove(std::size_t index) noexcept override;
+    ArtPtr get(std::size_t index) const noexcept override;
+    std::size_t size() const noexcept override;
+    void clear() noexcept override;
+    std::size_t removeMany(std::vector<std::size_t> indices) noexcept override;
+
+    // ── Concurrent readers ──
+    ArtSnapshotPtr snapshot() const override;
+
+    // ── Persistence (stubs) ──
+    bool loadFromFile(const QString& /*filePath*/) override {
+        return false;  // in-memory repo does not persist
+    }
+    bool saveToFile(const QString& /*filePath*/) const override {
+        return false;  // in-memory repo does not persist
+    }
+
+protected:
+    // For file-backed subclasses: swap in a freshly loaded item list
+    void replaceAll(std::vector<ArtPtr> items) noexcept;
+
+private:
+    // Version with the items at [keep * kChunkSize, ...) replaced by 'tail'
+    static ArtSnapshotPtr rebuild(const ArtSnapshot& base, std::size_t keepChunks,
+                                  std::vector<ArtPtr> tail);
+    void publish(ArtSnapshotPtr next) noexcept;
+
+    std::mutex     writeMutex_;   // one writer at a time
+    ArtSnapshotPtr head_;         // writer's view; only the writer touches it
+    ArtSnapshotPtr published_;    // readers' view; std::atomic_load/store only
+};
+
+#endif // CONCURRENTARTREPOSITORY_H
@@ -7,36 +7,32 @@
 #include <QFile>
 #include <QTextStream>
 
-#include "ArtRepositoryInterface.h"
+#include "ConcurrentArtRepository.h"
 #include "ArtObject.h"
 #include "Painting.h"
 #include "Sculpture.h"
 #include "DigitalArt.h"
 
-class CsvRepository : public ArtRepositoryInterface {
+// In-memory CRUD comes from ConcurrentArtRepository; this adds the CSV file format
+class CsvRepository : public ConcurrentArtRepository {
 public:
     using ArtPtr = std::shared_ptr<ArtObject>;
 
     CsvRepository() noexcept = default;
     ~CsvRepository() override = default;
 
-    // ── In‐memory CRUD ──
-    void add(const ArtPtr& art) override;
-    bool update(std::size_t index, const ArtPtr& art) noexcept override;
-    bool remove(std::size_t index) noexcept override;
-    ArtPtr get(std::size_t index) const noexcept override;
-    std::size_t size() const noexcept override;
-    void clear() noexcept override;
-
     // ── Persistence ──
     bool loadFromFile(const QString& filePath) override;
     bool saveToFile(const QString& filePath) const override;
 
-private:
-    std::vector<ArtPtr> items_;
-
+    // ── Row codec (shared with CatalogLoader) ──
+    // One record from 'in': several lines when a quoted field holds line
+    // breaks (joined with '\n'); empty at the end of the stream
+    static QString readCsvRecord(QTextStream& in);
     // Helper to parse a CSV line into fields, handling quoted commas
-    QStringList parseCsvLine(const QString& line) const;
+    static QStringList parseCsvLine(const QString& line);
+    // Build the art object described by one row; nullptr for a bad row
+    static ArtPtr fromCsvFields(const QStringList& fields);
 };
 
 #endif // CSVREPOSITORY_H
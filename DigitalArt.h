@@ -28,6 +28,7 @@ public:
     void setResolution(int resolutionX, int resolutionY);
 
     std::string getType() const noexcept override;
+    std::shared_ptr<ArtObject> clone() const override;
 
 private:
     std::string software_;
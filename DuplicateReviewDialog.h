@@ -0,0 +1,136 @@
+#ifndef DUPLICATEREVIEWDIALOG_H
+#define DUPLICATEREVIEWDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QDialogButtonBox>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "ArtObject.h"
+#include "ArtSnapshot.h"
+#include "NearDuplicateFinder.h"
+
+// Lists the pairs NearDuplicateFinder found, most similar first, one row
+// per pair. Ticking a row marks its second record for removal; nothing
+// is ticked up front. The caller removes selected() in one undo step.
+class DuplicateReviewDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    using ArtPtr = std::shared_ptr<ArtObject>;
+
+    // A table widget gets sluggish well before a million rows
+    static constexpr int kMaxRows = 5000;
+
+    DuplicateReviewDialog(ArtSnapshotPtr items, std::vector<NearDuplicate> pairs,
+                          QWidget* parent = nullptr)
+        : QDialog(parent),
+        items_(std::move(items)),
+        pairs_(std::move(pairs)),
+        table_(new QTableWidget(this))
+    {
+        setWindowTitle("Possible Duplicates");
+        resize(900, 500);
+
+        const int rows = static_cast<int>(std::min<std::size_t>(pairs_.size(), kMaxRows));
+        auto* summary = new QLabel(this);
+        summary->setText(pairs_.size() > std::size_t(kMaxRows)
+            ? QString("%1 possible duplicates, showing the %2 most similar. "
+                      "Tick the rows whose second record should be removed.")
+                  .arg(pairs_.size()).arg(rows)
+            : QString("%1 possible duplicates. "
+                      "Tick the rows whose second record should be removed.")
+                  .arg(pairs_.size()));
+
+        table_->setColumnCount(6);
+        table_->setHorizontalHeaderLabels({"Remove", "Similarity", "Keep", "Duplicate",
+                                           "Prices", "Locations"});
+        table_->setRowCount(rows);
+        table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+        table_->verticalHeader()->hide();
+        table_->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+        table_->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
+
+        for (int row = 0; row < rows; ++row) {
+            const NearDuplicate& pair = pairs_[row];
+            const auto& keep = items_->at(pair.first);
+            const auto& drop = items_->at(pair.second);
+
+            auto* check = new QTableWidgetItem;
+            check->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
+            check->setCheckState(Qt::Unchecked);
+            table_->setItem(row, 0, check);
+            table_->setItem(row, 1, new QTableWidgetItem(
+                QString("%1 %").arg(pair.similarity * 100.0, 0, 'f', 0)));
+            table_->setItem(row, 2, new QTableWidgetItem(QString::fromStdString(keep->getName())));
+            table_->setItem(row, 3, new QTableWidgetItem(QString::fromStdString(drop->getName())));
+            table_->setItem(row, 4, new QTableWidgetItem(
+                QString("%1 / %2").arg(keep->getPrice(), 0, 'f', 2).arg(drop->getPrice(), 0, 'f', 2)));
+            table_->setItem(row, 5, new QTableWidgetItem(
+                QString("%1 / %2").arg(QString::fromStdString(keep->getLocation()),
+                                       QString::fromStdString(drop->getLocation()))));
+
+            // Full descriptions on hover
+            table_->item(row, 2)->setToolTip(QString::fromStdString(keep->getDescription()));
+            table_->item(row, 3)->setToolTip(QString::fromStdString(drop->getDescription()));
+        }
+        table_->resizeColumnToContents(0);
+        table_->resizeColumnToContents(1);
+
+        auto* tickAll  = new QPushButton("Tick All", this);
+        auto* tickNone = new QPushButton("Tick None", this);
+        connect(tickAll, &QPushButton::clicked, this, [this]() { setAll(Qt::Checked); });
+        connect(tickNone, &QPushButton::clicked, this, [this]() { setAll(Qt::Unchecked); });
+
+        auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+        buttons->button(QDialogButtonBox::Ok)->setText("Remove Ticked");
+        connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+        connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+        auto* layout = new QVBoxLayout(this);
+        layout->addWidget(summary);
+        layout->addWidget(table_);
+        auto* bottom = new QHBoxLayout;
+        bottom->addWidget(tickAll);
+        bottom->addWidget(tickNone);
+        bottom->addStretch();
+        bottom->addWidget(buttons);
+        layout->addLayout(bottom);
+    }
+
+    // Records to remove, each once (a record can be the duplicate of
+    // several others)
+    std::vector<ArtPtr> selected() const {
+        std::vector<ArtPtr> out;
+        std::unordered_set<const ArtObject*> seen;
+        for (int row = 0; row < table_->rowCount(); ++row) {
+            if (table_->item(row, 0)->checkState() != Qt::Checked) continue;
+            const ArtPtr& art = items_->at(pairs_[row].second);
+            if (seen.insert(art.get()).second) out.push_back(art);
+        }
+        return out;
+    }
+
+private:
+    void setAll(Qt::CheckState state) {
+        for (int row = 0; row < table_->rowCount(); ++row) {
+            table_->item(row, 0)->setCheckState(state);
+        }
+    }
+
+    ArtSnapshotPtr             items_;
+    std::vector<NearDuplicate> pairs_;
+    QTableWidget*              table_;
+};
+
+#endif // DUPLICATEREVIEWDIALOG_H
@@ -0,0 +1,112 @@
+#ifndef GALLERYVIEW_H
+#define GALLERYVIEW_H
+
+#include <QAbstractListModel>
+#include <QStyledItemDelegate>
+#include <QListView>
+#include <QMultiHash>
+#include <QTimer>
+#include <QImage>
+#include <QSize>
+
+#include <memory>
+#include <vector>
+
+#include "ArtRepositoryInterface.h"
+
+class ThumbnailLoader;
+class ThumbnailDiskCache;
+
+// ── GalleryModel ──
+// One row per visible repository index. Thumbnails are requested lazily
+// from data(), which the view only calls for tiles it is painting.
+class GalleryModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    GalleryModel(std::shared_ptr<ArtRepositoryInterface> repo,
+                 ThumbnailLoader* loader,
+                 QObject* parent = nullptr);
+
+    void setIndices(const std::vector<std::size_t>& indices);
+    void appendIndices(const std::vector<std::size_t>& indices);
+    std::size_t repoIndexAt(int row) const noexcept;
+
+    void setTileSize(const QSize& size);
+    QSize tileSize() const noexcept;
+
+    // Tiles [first, last] are on screen: cancel decodes for everything
+    // else and prefetch the page that follows.
+    void setViewport(int first, int last);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private slots:
+    void onThumbnailReady(const QString& path, const QSize& size, const QImage& image);
+
+private:
+    QString imagePathAt(int row) const;
+
+    std::shared_ptr<ArtRepositoryInterface> repo_;
+    ThumbnailLoader*             loader_;
+    std::vector<std::size_t>     indices_;
+    QSize                        tileSize_{128, 128};
+    mutable QMultiHash<QString, int> waiting_;   // image path → rows to repaint
+};
+
+// ── GalleryDelegate ──
+// Paints every tile: thumbnail (or a flat placeholder) plus the name.
+// QListView does not create a widget per item, so this one delegate is
+// effectively the pool of recycled tiles.
+class GalleryDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit GalleryDelegate(QObject* parent = nullptr);
+
+    void setTileSize(const QSize& size);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option,
+               const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option,
+                   const QModelIndex& index) const override;
+
+private:
+    QSize tileSize_{128, 128};
+};
+
+// ── GalleryView ──
+// Grid of artwork thumbnails with its own byte-bounded thumbnail cache,
+// so browsing the grid does not evict the detail preview.
+class GalleryView : public QListView {
+    Q_OBJECT
+
+public:
+    GalleryView(std::shared_ptr<ArtRepositoryInterface> repo,
+                std::shared_ptr<ThumbnailDiskCache> disk,
+                QWidget* parent = nullptr);
+
+    void setIndices(const std::vector<std::size_t>& indices);
+    void appendIndices(const std::vector<std::size_t>& indices);
+    void setCurrentRow(int row);
+
+    // Upper bound on decoded thumbnail bytes the grid keeps in memory.
+    void setMemoryBudget(qint64 bytes);
+
+signals:
+    void currentRowChanged(int row);
+
+protected:
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    void updateViewport();
+
+    ThumbnailLoader* loader_;
+    GalleryModel*    model_;
+    GalleryDelegate* delegate_;
+    QTimer           viewportTimer_;
+};
+
+#endif // GALLERYVIEW_H
@@ -0,0 +1,49 @@
+#ifndef IMAGEPREFETCHER_H
+#define IMAGEPREFETCHER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QSize>
+#include <QTimer>
+
+class ThumbnailLoader;
+
+// Prefetch policy on top of ThumbnailLoader: decodes the thumbnails the
+// user is likely to look at next (rows around the selection and the
+// page below the viewport) at low priority, within a memory budget, and
+// stays quiet while the user is typing.
+class ImagePrefetcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ImagePrefetcher(ThumbnailLoader* loader, QObject* parent = nullptr);
+
+    // How many rows on each side of the selection to prefetch.
+    void setRadius(int rows) noexcept;
+    int radius() const noexcept;
+
+    // Upper bound on decoded bytes held for the prefetch window.
+    void setBudget(qint64 bytes) noexcept;
+
+    // New window of image paths, most wanted first.
+    void update(const QStringList& paths, const QSize& size);
+
+    // Cancel outstanding prefetches and hold off for a short while; the
+    // last window is resumed once the user has been idle.
+    void backOff();
+
+    // One-line hit/miss summary of the underlying loader.
+    QString statsSummary() const;
+
+private:
+    void apply();
+
+    ThumbnailLoader* loader_;
+    QTimer           resumeTimer_;
+    QStringList      paths_;
+    QSize            size_;
+    int              radius_ = 4;
+    qint64           budget_ = 16LL * 1024 * 1024;
+};
+
+#endif // IMAGEPREFETCHER_H
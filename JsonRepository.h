@@ -9,33 +9,30 @@
 #include <QJsonArray>
 #include <QJsonObject>
 
-#include "ArtRepositoryInterface.h"
+#include "ConcurrentArtRepository.h"
 #include "ArtObject.h"
 #include "Painting.h"
 #include "Sculpture.h"
 #include "DigitalArt.h"
 
-class JsonRepository : public ArtRepositoryInterface {
+// In-memory CRUD comes from ConcurrentArtRepository; this adds the JSON file format
+class JsonRepository : public ConcurrentArtRepository {
 public:
     using ArtPtr = std::shared_ptr<ArtObject>;
 
     JsonRepository() noexcept = default;
     ~JsonRepository() override = default;
 
-    // ── In-memory CRUD ──
-    void add(const ArtPtr& art) override;
-    bool update(std::size_t index, const ArtPtr& art) noexcept override;
-    bool remove(std::size_t index) noexcept override;
-    ArtPtr get(std::size_t index) const noexcept override;
-    std::size_t size() const noexcept override;
-    void clear() noexcept override;
-
     // ── Persistence ──
     bool loadFromFile(const QString& filePath) override;
     bool saveToFile(const QString& filePath) const override;
 
-private:
-    std::vector<ArtPtr> items_;
+    // ── Record codec (shared with CatalogLoader and UndoJournal) ──
+    // Build the art object described by one array element; nullptr if
+    // the type is unknown
+    static ArtPtr fromJson(const QJsonObject& obj);
+    // Inverse of fromJson()
+    static QJsonObject toJson(const ArtObject& art);
 };
 
 #endif // JSONREPOSITORY_H
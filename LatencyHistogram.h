@@ -0,0 +1,63 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Latencies in fixed 1-2-5 buckets from 1 ms to 60 s, small enough to
+// keep one per outcome for the whole session. Percentiles are reported
+// as the upper bound of the bucket they fall in ("p90 <= 2000 ms"),
+// which is as precise as a network timing needs to be.
+class LatencyHistogram {
+public:
+    static constexpr std::array<double, 15> kBounds = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 60000};
+    static constexpr std::size_t kBuckets = kBounds.size() + 1;   // last one is > 60 s
+
+    void record(double ms) noexcept {
+        const auto it = std::lower_bound(kBounds.begin(), kBounds.end(), ms);
+        ++counts_[std::size_t(it - kBounds.begin())];
+        ++count_;
+        sum_ += ms;
+        max_ = std::max(max_, ms);
+    }
+
+    std::uint64_t count() const noexcept { return count_; }
+    std::uint64_t bucket(std::size_t i) const noexcept { return counts_[i]; }
+    double mean() const noexcept { return count_ ? sum_ / double(count_) : 0.0; }
+    double max() const noexcept { return max_; }
+
+    // Upper bound of the bucket holding the q-th sample (0 < q <= 1);
+    // max() for the overflow bucket, 0 when empty
+    double percentile(double q) const noexcept {
+        if (count_ == 0) return 0.0;
+        const auto rank = std::max<std::uint64_t>(1, std::uint64_t(q * double(count_) + 0.999999));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return i < kBounds.size() ? std::min(kBounds[i], max_) : max_;
+        }
+        return max_;
+    }
+
+    // "n=12 mean 340 ms, p50 <= 200, p90 <= 1000, p99 <= 2000, max 1830 ms"
+    std::string summary() const {
+        char line[160];
+        std::snprintf(line, sizeof line,
+                      "n=%llu mean %.0f ms, p50 <= %.0f, p90 <= %.0f, p99 <= %.0f, max %.0f ms",
+                      static_cast<unsigned long long>(count_), mean(), percentile(0.5),
+                      percentile(0.9), percentile(0.99), max_);
+        return line;
+    }
+
+private:
+    std::array<std::uint64_t, kBuckets> counts_{};
+    std::uint64_t count_ = 0;
+    double        sum_   = 0.0;
+    double        max_   = 0.0;
+};
+
+#endif // LATENCYHISTOGRAM_H
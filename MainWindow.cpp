@@ -5,59 +5,155 @@
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QPixmap>
+#include <QScrollBar>
+#include <QStatusBar>
 #include <QDebug>
+#include <QElapsedTimer>
 
-#include "painting.h"
-#include "sculpture.h"
+#include <set>
+
+#include "Painting.h"
+#include "Sculpture.h"
 #include "DigitalArt.h"
+#include "ThumbnailDiskCache.h"
+#include "TaskScheduler.h"
+#include "DuplicateReviewDialog.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , chatDialog(new ChatDialog(this))
+    , thumbnails_(new ThumbnailLoader(this))
+    , prefetcher_(new ImagePrefetcher(thumbnails_, this))
+    , catalogLoader_(new CatalogLoader(this))
+    , importer_(new BulkImporter(this))
+    , searchEngine_(new SearchEngine(this))
+    , searchDebounce_(new QTimer(this))
 {
     setupUI();
     resize(800, 600);
 
+    thumbnailDisk_ = std::make_shared<ThumbnailDiskCache>(ThumbnailDiskCache::defaultPath());
+    thumbnails_->setDiskCache(thumbnailDisk_);
+    chatDialog->setResponseCache(std::make_shared<ResponseCache>(ResponseCache::defaultPath()));
+
     // ── Choose which repository to use ──
     //  (1) In-memory only:
     //repo_ = std::make_shared<ArtRepository>();
 
     //  (2) CSV-backed (uncomment next lines & comment out #1):
      //repo_ = std::make_shared<CsvRepository>();
-    //repo_->loadFromFile("/Users/turlefabian/Desktop/art_data.csv");
+    //catalogPath_ = "/Users/turlefabian/Desktop/art_data.csv";
 
     //  (3) JSON-backed (uncomment next lines & comment out above):
      repo_ = std::make_shared<JsonRepository>();
-     repo_->loadFromFile("/Users/turlefabian/Desktop/art_data.json");
+     catalogPath_ = "/Users/turlefabian/Desktop/art_data.json";
      //qDebug() << "[MainWindow] Current working directory:" << QDir::currentPath();
-     //bool ok = repo_->loadFromFile("art_data.json");
-     //qDebug() << "[MainWindow] loadFromFile returned" << ok;
+     //catalogPath_ = "art_data.json";
+
+    // The file itself is parsed by catalogLoader_ once the window is up
+    nameIndex_ = std::make_unique<NameIndex>(repo_);
+    similarityIndex_ = std::make_unique<SimilarityIndex>(repo_);
+    catalogRetriever_ = std::make_unique<CatalogRetriever>(repo_, *similarityIndex_);
+    chatDialog->setGrounding([this](const std::string& question) {
+        return catalogRetriever_->retrieve(question).context;
+    });
+
+    // Gallery needs the repository, so it joins the stack only now
+    galleryView = new GalleryView(repo_, thumbnailDisk_);
+    viewStack->addWidget(galleryView);
 
     // ── Connect signals & slots ──
     connect(listWidget, &QListWidget::currentRowChanged,
             this, &MainWindow::onSelectionChanged);
+    connect(similarList, &QListWidget::itemActivated,
+            this, &MainWindow::onSimilarActivated);
     connect(btnAdd, &QPushButton::clicked, this, &MainWindow::onAdd);
     connect(btnEdit, &QPushButton::clicked, this, &MainWindow::onEdit);
     connect(btnRemove, &QPushButton::clicked, this, &MainWindow::onRemove);
+    connect(btnAdjust, &QPushButton::clicked, this, &MainWindow::onAdjustPrices);
+    connect(btnImport, &QPushButton::clicked, this, &MainWindow::onImport);
+    connect(btnDuplicates, &QPushButton::clicked, this, &MainWindow::onFindDuplicates);
     connect(btnChat, &QPushButton::clicked, this, &MainWindow::onChat);
     connect(btnFilter, &QPushButton::clicked, this, &MainWindow::onFilter);
     connect(btnClearFilter, &QPushButton::clicked, this, &MainWindow::onClearFilter);
     connect(btnSearch, &QPushButton::clicked, this, &MainWindow::onSearch);
 
+    // Live search: evaluate once typing pauses
+    searchDebounce_->setSingleShot(true);
+    searchDebounce_->setInterval(150);
+    connect(searchEdit, &QLineEdit::textChanged,
+            searchDebounce_, qOverload<>(&QTimer::start));
+    connect(searchDebounce_, &QTimer::timeout, this, &MainWindow::onSearch);
+    connect(searchEngine_, &SearchEngine::resultsReady,
+            this, &MainWindow::onSearchResults);
+    connect(searchEngine_, &SearchEngine::finished,
+            this, &MainWindow::onSearchFinished);
+
     // Undo/Redo
     connect(btnUndo, &QPushButton::clicked, this, &MainWindow::onUndo);
     connect(btnRedo, &QPushButton::clicked, this, &MainWindow::onRedo);
 
+    // Thumbnails
+    connect(thumbnails_, &ThumbnailLoader::thumbnailReady,
+            this, &MainWindow::onThumbnailReady);
+    connect(thumbnails_, &ThumbnailLoader::thumbnailFailed,
+            this, &MainWindow::onThumbnailFailed);
+
+    // Prefetch the next page while scrolling; stay quiet while typing
+    connect(listWidget->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &MainWindow::schedulePrefetch);
+    connect(searchEdit, &QLineEdit::textEdited,
+            prefetcher_, &ImagePrefetcher::backOff);
+
+    // Gallery mode shares the selection with the list
+    connect(btnGallery, &QPushButton::toggled, this, &MainWindow::onToggleGallery);
+    connect(galleryView, &GalleryView::currentRowChanged,
+            listWidget, &QListWidget::setCurrentRow);
+
+    // Background catalog load: records show up batch by batch
+    connect(catalogLoader_, &CatalogLoader::batchLoaded,
+            this, &MainWindow::onCatalogBatch);
+    connect(catalogLoader_, &CatalogLoader::progress,
+            this, &MainWindow::onCatalogProgress);
+    connect(catalogLoader_, &CatalogLoader::finished,
+            this, &MainWindow::onCatalogLoaded);
+
+    // Bulk import: same batch path as the catalog load
+    connect(importer_, &BulkImporter::batchReady, this, &MainWindow::onImportBatch);
+    connect(importer_, &BulkImporter::finished, this, &MainWindow::onImportFinished);
+
     refreshList();
+    if (!catalogPath_.isEmpty()) {
+        // The undo journal opens once the file is in; an edit made before
+        // that would not be journaled and a recovery replay would clash
+        setEditingEnabled(false);
+        loadProgress->show();
+        catalogLoader_->start(catalogPath_);
+    }
 }
 
 MainWindow::~MainWindow()
 {
-    // If you choose CSV at runtime:
-    // repo_->saveToFile("/Users/turlefabian/Desktop/art_data.csv");
+    // A duplicate search over a big catalog would hold up the exit
+    if (duplicateCancel_) duplicateCancel_->store(true);
+
+    qInfo() << "[MainWindow] thumbnails:" << prefetcher_->statsSummary();
+    qInfo().noquote() << "[MainWindow] background tasks:\n"
+                      << QString::fromStdString(TaskScheduler::instance().statsSummary());
 
-    // If you choose JSON:
-    repo_->saveToFile("/Users/turlefabian/Desktop/art_data.json");
+    // Saving a half-loaded catalog would truncate the file on disk
+    if (catalogLoader_->isRunning()) {
+        qWarning() << "[MainWindow] catalog still loading, not saving" << catalogPath_;
+        return;
+    }
+    if (catalogLoadFailed_) {
+        qWarning() << "[MainWindow] catalog failed to load, not saving" << catalogPath_;
+        return;
+    }
+    if (!catalogPath_.isEmpty() && repo_->saveToFile(catalogPath_)) {
+        // The journal's history now matches the file on disk
+        journal_.checkpoint(history_);
+    }
 }
 
 void MainWindow::setupUI()
@@ -76,14 +172,20 @@ void MainWindow::setupUI()
     searchEdit = new QLineEdit;
     searchEdit->setPlaceholderText("Search by name...");
     btnSearch = new QPushButton("Search");
+    btnGallery = new QPushButton("Gallery");
+    btnGallery->setCheckable(true);
     auto searchLayout = new QHBoxLayout;
     searchLayout->addWidget(searchEdit);
     searchLayout->addWidget(btnSearch);
+    searchLayout->addWidget(btnGallery);
     leftLayout->addLayout(searchLayout);
 
-    // 2) List
+    // 2) List (the gallery is stacked on top of it once the repo exists)
+    viewStack = new QStackedWidget;
     listWidget = new QListWidget;
-    leftLayout->addWidget(listWidget);
+    listWidget->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    viewStack->addWidget(listWidget);
+    leftLayout->addWidget(viewStack);
 
     // Right pane: image + details
     rightPane = new QWidget(splitter);
@@ -97,8 +199,21 @@ void MainWindow::setupUI()
     lblDetails = new QLabel;
     lblDetails->setWordWrap(true);
 
+    lblSimilar = new QLabel(tr("Similar artworks:"));
+    similarList = new QListWidget;
+    similarList->setMaximumHeight(120);
+
     rightLayout->addWidget(imgLabel);
     rightLayout->addWidget(lblDetails);
+    rightLayout->addWidget(lblSimilar);
+    rightLayout->addWidget(similarList);
+
+    // Catalog load progress lives in the status bar
+    loadProgress = new QProgressBar;
+    loadProgress->setMaximumWidth(200);
+    loadProgress->setRange(0, 100);
+    statusBar()->addPermanentWidget(loadProgress);
+    loadProgress->hide();
 
     // Make splitter 50/50
     splitter->setStretchFactor(0, 1);
@@ -109,6 +224,9 @@ void MainWindow::setupUI()
     btnAdd         = new QPushButton("Add",    central);
     btnEdit        = new QPushButton("Edit",   central);
     btnRemove      = new QPushButton("Remove", central);
+    btnAdjust      = new QPushButton("Adjust Prices", central);
+    btnImport      = new QPushButton("Import...", central);
+    btnDuplicates  = new QPushButton("Find Duplicates", central);
     btnChat        = new QPushButton("Chat",   central);
     btnFilter      = new QPushButton("Filter", central);
     btnClearFilter = new QPushButton("Clear Filter", central);
@@ -125,6 +243,9 @@ void MainWindow::setupUI()
     btnLayout1->addWidget(btnAdd);
     btnLayout1->addWidget(btnEdit);
     btnLayout1->addWidget(btnRemove);
+    btnLayout1->addWidget(btnAdjust);
+    btnLayout1->addWidget(btnImport);
+    btnLayout1->addWidget(btnDuplicates);
     btnLayout1->addWidget(btnChat);
     btnLayout1->addWidget(btnFilter);
     btnLayout1->addWidget(btnClearFilter);
@@ -142,66 +263,140 @@ void MainWindow::refreshList()
 
     //qDebug() << "[MainWindow] refreshList: repo_->size() =" << repo_->size();
 
-    listWidget->clear();
+    // The query runs on the search worker against a snapshot. The rows on
+    // screen stay until its first results arrive, so there is no flicker.
+    // Exact name matches come from the index right away.
+    SearchQuery query = currentQuery();
+    std::vector<SearchHit> exact;
+    if (query.mode == SearchQuery::Mode::Name) {
+        for (std::size_t index : nameIndex_->find(query.text)) exact.push_back({index, 0});
+        query.skipExact = true;
+    }
+    queryId_ = searchEngine_->start(query, repo_->snapshot());
+    resultsStale_ = true;
+    exactHits_.clear();
+    // The old rows may point at shifted or removed records: unmap them
+    // now, so Edit/Remove/details find no selection until they are replaced
     displayedIndices_.clear();
+    tierSizes_.fill(0);
+    if (!exact.empty()) {
+        onSearchResults(queryId_, exact);
+        for (const SearchHit& hit : exact) exactHits_.insert(hit.index);
+    }
+}
 
+SearchQuery MainWindow::currentQuery() const
+{
+    SearchQuery query;
     if (searchActive_) {
-        QString target = searchText_.trimmed();
-        for (std::size_t i = 0; i < repo_->size(); ++i) {
-            auto art = repo_->get(i);
-            if (!art) continue;
-            QString name = QString::fromStdString(art->getName());
-            if (name.compare(target, Qt::CaseInsensitive) == 0) {
-                listWidget->addItem(name);
-                displayedIndices_.push_back(i);
-            }
-        }
-       /* qDebug() << "[MainWindow] refreshList: searchActive, displayedIndices_ size ="
-                 << displayedIndices_.size();*/
-    }
-    else {
-        for (std::size_t i = 0; i < repo_->size(); ++i) {
-            auto art = repo_->get(i);
-            if (!art) continue;
-
-            bool passes = true;
-            if (filterActive_) {
-                double price = art->getPrice();
-                passes = ( filterAbove_ ? (price >= filterPrice_)
-                                       : (price <= filterPrice_) );
-            }
-
-            if (passes) {
-                QString name = QString::fromStdString(art->getName());
-                listWidget->addItem(name);
-                displayedIndices_.push_back(i);
-            }
-        }
-        /*qDebug() << "[MainWindow] refreshList: filterActive =" << filterActive_
-                 << ", displayedIndices_ size =" << displayedIndices_.size();*/
+        query.mode = SearchQuery::Mode::Name;
+        query.text = searchText_;
+    } else if (filterActive_) {
+        query.mode  = SearchQuery::Mode::Price;
+        query.price = filterPrice_;
+        query.above = filterAbove_;
     }
+    return query;
+}
+
+void MainWindow::resetResults()
+{
+    listWidget->clear();
+    displayedIndices_.clear();
+    tierSizes_.fill(0);
+    galleryView->setIndices(displayedIndices_);
+    galleryDirty_ = false;
+    resultsStale_ = false;
 
+    thumbnails_->cancelPending();
+    pendingImagePath_.clear();
     imgLabel->clear();
     lblDetails->clear();
 }
 
+void MainWindow::onSearchResults(quint64 id, const std::vector<SearchHit>& hits)
+{
+    if (id != queryId_) return;
+    if (resultsStale_) resetResults();
+
+    // Group the chunk by rank; each group goes to the end of its tier
+    std::array<std::vector<std::size_t>, SearchQuery::kRanks> indices;
+    std::array<QStringList, SearchQuery::kRanks> names;
+    for (const SearchHit& hit : hits) {
+        if (!exactHits_.empty() && exactHits_.count(hit.index)) continue;
+        auto art = repo_->get(hit.index);
+        if (!art) continue;
+        indices[hit.rank].push_back(hit.index);
+        names[hit.rank] << QString::fromStdString(art->getName());
+    }
+
+    bool appendOnly = true;
+    std::vector<std::size_t> appended;
+    std::size_t row = 0;
+    for (int r = 0; r < SearchQuery::kRanks; ++r) {
+        row += tierSizes_[r];
+        if (indices[r].empty()) continue;
+        if (row != displayedIndices_.size()) appendOnly = false;
+
+        // displayedIndices_ first: inserting rows can move the current
+        // row, and onSelectionChanged reads the mapping
+        displayedIndices_.insert(displayedIndices_.begin() + row,
+                                 indices[r].begin(), indices[r].end());
+        listWidget->insertItems(static_cast<int>(row), names[r]);
+        appended.insert(appended.end(), indices[r].begin(), indices[r].end());
+        tierSizes_[r] += indices[r].size();
+        row += indices[r].size();
+    }
+
+    if (appendOnly) galleryView->appendIndices(appended);
+    else            galleryDirty_ = true;
+}
+
+void MainWindow::onSearchFinished(quint64 id)
+{
+    if (id != queryId_) return;
+    if (resultsStale_) resetResults();     // the query matched nothing
+    if (galleryDirty_) {
+        galleryView->setIndices(displayedIndices_);
+        galleryDirty_ = false;
+    }
+}
+
+void MainWindow::pruneThumbnailCache()
+{
+    QSet<QString> livePaths;
+    for (std::size_t i = 0; i < repo_->size(); ++i) {
+        auto art = repo_->get(i);
+        if (art && !art->getImagePath().isEmpty()) livePaths.insert(art->getImagePath());
+    }
+    thumbnails_->pruneDiskCache(livePaths);
+}
+
 void MainWindow::displayDetails(std::size_t repoIndex)
 {
     lblDetails->clear();
     imgLabel->clear();
+    similarList->clear();
+
+    // Whatever was being decoded for the previous selection is stale now
+    thumbnails_->cancelPending();
+    pendingImagePath_.clear();
 
     if (repoIndex >= repo_->size()) return;
     auto art = repo_->get(repoIndex);
     if (!art) return;
 
     QString path = art->getImagePath();
-    if (!path.isEmpty() && QFileInfo(path).exists()) {
-        QPixmap pm(path);
-        imgLabel->setPixmap(pm.scaled(
-            imgLabel->size(),
-            Qt::KeepAspectRatio,
-            Qt::SmoothTransformation
-            ));
+    if (!path.isEmpty()) {
+        QImage thumb;
+        if (thumbnails_->lookup(path, imgLabel->size(), &thumb)) {
+            imgLabel->setPixmap(QPixmap::fromImage(thumb));
+        } else {
+            // Placeholder until the worker pool hands back the thumbnail
+            imgLabel->setText(tr("Loading image…"));
+            pendingImagePath_ = path;
+            thumbnails_->request(path, imgLabel->size());
+        }
     }
 
     QString details = QString("Name: %1\nDescription: %2\nPrice: %3\nLocation: %4")
@@ -224,6 +419,34 @@ void MainWindow::displayDetails(std::size_t repoIndex)
     }
 
     lblDetails->setText(details);
+
+    for (const SimilarHit& hit : similarityIndex_->similar(repoIndex, 5)) {
+        auto other = repo_->get(hit.index);
+        if (!other) continue;
+        auto* item = new QListWidgetItem(
+            QString("%1  (%2)").arg(QString::fromStdString(other->getName()))
+                               .arg(other->getPrice()), similarList);
+        item->setData(Qt::UserRole, QVariant::fromValue<qulonglong>(hit.index));
+    }
+}
+
+void MainWindow::onSimilarActivated(QListWidgetItem* item)
+{
+    const auto repoIndex = static_cast<std::size_t>(item->data(Qt::UserRole).toULongLong());
+    auto it = std::find(displayedIndices_.begin(), displayedIndices_.end(), repoIndex);
+    if (it == displayedIndices_.end()) {
+        statusBar()->showMessage(tr("Not in the current list; clear the search or filter"), 3000);
+        return;
+    }
+    listWidget->setCurrentRow(static_cast<int>(it - displayedIndices_.begin()));
+}
+
+void MainWindow::setEditingEnabled(bool on)
+{
+    for (QPushButton* button : { btnAdd, btnEdit, btnRemove, btnAdjust, btnUndo, btnRedo,
+                                 btnDuplicates }) {
+        button->setEnabled(on);
+    }
 }
 
 void MainWindow::pushCommand(CommandPtr cmd)
@@ -231,25 +454,62 @@ void MainWindow::pushCommand(CommandPtr cmd)
     // 1) Execute the command
     cmd->execute();
 
-    // 2) Move it onto undoStack_
-    undoStack_.push_back(std::move(cmd));
+    // 2) Record it: clears redo, may merge into the previous step and
+    //    drops the oldest steps once the history is over budget
+    history_.push(std::move(cmd));
 
-    // 3) Clear redoStack_
-    redoStack_.clear();
-
-    // 4) Refresh UI
+    // 3) Refresh UI
     refreshList();
 }
 
 void MainWindow::onSelectionChanged(int row)
 {
     if (row < 0 || row >= static_cast<int>(displayedIndices_.size())) {
+        thumbnails_->cancelPending();
+        pendingImagePath_.clear();
         imgLabel->clear();
         lblDetails->clear();
+        similarList->clear();
         return;
     }
     std::size_t repoIndex = displayedIndices_[row];
     displayDetails(repoIndex);
+    schedulePrefetch();
+    galleryView->setCurrentRow(row);
+}
+
+void MainWindow::schedulePrefetch()
+{
+    const int rows = static_cast<int>(displayedIndices_.size());
+    if (rows == 0) return;
+
+    QStringList paths;
+    auto pathAt = [&](int row) {
+        auto art = repo_->get(displayedIndices_[row]);
+        if (art && !art->getImagePath().isEmpty()) paths << art->getImagePath();
+    };
+
+    // Neighbours of the selection, nearest first, next before previous
+    const int current = listWidget->currentRow();
+    if (current >= 0) {
+        for (int d = 1; d <= prefetcher_->radius(); ++d) {
+            if (current + d < rows) pathAt(current + d);
+            if (current - d >= 0)   pathAt(current - d);
+        }
+    }
+
+    // The page right below the viewport
+    QModelIndex first = listWidget->indexAt(QPoint(0, 0));
+    QModelIndex last  = listWidget->indexAt(QPoint(0, listWidget->viewport()->height() - 1));
+    if (first.isValid()) {
+        const int lastVisible = last.isValid() ? last.row() : rows - 1;
+        const int page = lastVisible - first.row() + 1;
+        for (int r = lastVisible + 1; r < rows && r <= lastVisible + page; ++r) {
+            pathAt(r);
+        }
+    }
+
+    prefetcher_->update(paths, imgLabel->size());
 }
 
 void MainWindow::onAdd()
@@ -264,6 +524,17 @@ void MainWindow::onAdd()
         this, "Name", "Enter name:", QLineEdit::Normal, {}, &ok);
     if (!ok) return;
 
+    // The Bloom filter answers "no such name" for most names without a lookup
+    if (nameIndex_->mightContain(name)) {
+        const std::size_t same = nameIndex_->find(name).size();
+        if (same > 0 && QMessageBox::question(
+                this, tr("Possible duplicate"),
+                tr("%n artwork(s) named \"%1\" already in the catalog. Add anyway?", "", int(same))
+                    .arg(name)) != QMessageBox::Yes) {
+            return;
+        }
+    }
+
     QString desc = QInputDialog::getText(
         this, "Description", "Enter description:", QLineEdit::Normal, {}, &ok);
     if (!ok) return;
@@ -375,36 +646,32 @@ void MainWindow::onEdit()
         QString::fromStdString(oldArtPtr->getLocation()), &ok);
     if (!ok) return;
 
-    std::shared_ptr<ArtObject> newArtPtr;
+    // Only the fields that actually changed go into the undo history
+    std::vector<FieldDelta> deltas;
+    auto textField = [&](ArtField field, const std::string& oldValue, const QString& newValue) {
+        std::string value = newValue.toStdString();
+        if (value != oldValue) deltas.push_back({field, oldValue, std::move(value)});
+    };
+    textField(ArtField::Name, oldArtPtr->getName(), newName);
+    textField(ArtField::Description, oldArtPtr->getDescription(), newDesc);
+    if (newPrice != oldArtPtr->getPrice()) {
+        deltas.push_back({ArtField::Price, oldArtPtr->getPrice(), newPrice});
+    }
+    textField(ArtField::Location, oldArtPtr->getLocation(), newLoc);
+
     if (auto pOld = std::dynamic_pointer_cast<Painting>(oldArtPtr)) {
         QString newCanvas = QInputDialog::getText(
             this, "Edit Canvas Type", "Enter new canvas type:", QLineEdit::Normal,
             QString::fromStdString(pOld->getCanvasType()), &ok);
         if (!ok) return;
-
-        newArtPtr = std::make_shared<Painting>(
-            newName.toStdString(),
-            newDesc.toStdString(),
-            newPrice,
-            newLoc.toStdString(),
-            newCanvas.toStdString(),
-            pOld->getImagePath()
-            );
+        textField(ArtField::CanvasType, pOld->getCanvasType(), newCanvas);
     }
     else if (auto sOld = std::dynamic_pointer_cast<Sculpture>(oldArtPtr)) {
         QString newMat = QInputDialog::getText(
             this, "Edit Material", "Enter new material:", QLineEdit::Normal,
             QString::fromStdString(sOld->getMaterial()), &ok);
         if (!ok) return;
-
-        newArtPtr = std::make_shared<Sculpture>(
-            newName.toStdString(),
-            newDesc.toStdString(),
-            newPrice,
-            newLoc.toStdString(),
-            newMat.toStdString(),
-            sOld->getImagePath()
-            );
+        textField(ArtField::Material, sOld->getMaterial(), newMat);
     }
     else if (auto dOld = std::dynamic_pointer_cast<DigitalArt>(oldArtPtr)) {
         QString newSoftware = QInputDialog::getText(
@@ -422,31 +689,20 @@ void MainWindow::onEdit()
             dOld->getResolutionY(), 0, 10000, 1, &ok);
         if (!ok) return;
 
-        newArtPtr = std::make_shared<DigitalArt>(
-            newName.toStdString(),
-            newDesc.toStdString(),
-            newPrice,
-            newLoc.toStdString(),
-            newSoftware.toStdString(),
-            newResX,
-            newResY,
-            dOld->getImagePath()
-            );
-    } else {
-        newArtPtr = std::make_shared<ArtObject>(
-            newName.toStdString(),
-            newDesc.toStdString(),
-            newPrice,
-            newLoc.toStdString(),
-            oldArtPtr->getImagePath()
-            );
+        textField(ArtField::Software, dOld->getSoftware(), newSoftware);
+        if (newResX != dOld->getResolutionX()) {
+            deltas.push_back({ArtField::ResolutionX, dOld->getResolutionX(), newResX});
+        }
+        if (newResY != dOld->getResolutionY()) {
+            deltas.push_back({ArtField::ResolutionY, dOld->getResolutionY(), newResY});
+        }
     }
+    if (deltas.empty()) return;
 
-    auto cmd = std::make_unique<EditCommand>(
+    auto cmd = std::make_unique<FieldEditCommand>(
         repo_,
         repoIndex,
-        oldArtPtr,
-        newArtPtr
+        std::move(deltas)
         );
     pushCommand(std::move(cmd));
 
@@ -456,18 +712,33 @@ void MainWindow::onEdit()
 
 void MainWindow::onRemove()
 {
-    int row = listWidget->currentRow();
-    if (row < 0 || row >= static_cast<int>(displayedIndices_.size())) return;
+    std::vector<std::size_t> repoIndices;
+    for (const QModelIndex& index : listWidget->selectionModel()->selectedRows()) {
+        const int row = index.row();
+        if (row >= 0 && row < static_cast<int>(displayedIndices_.size())) {
+            repoIndices.push_back(displayedIndices_[row]);
+        }
+    }
+    if (repoIndices.empty()) {
+        int row = listWidget->currentRow();
+        if (row < 0 || row >= static_cast<int>(displayedIndices_.size())) return;
+        repoIndices.push_back(displayedIndices_[row]);
+    }
 
-    if (QMessageBox::question(this, "Confirm Remove",
-                              "Are you sure you want to remove this item?",
+    const QString question = repoIndices.size() == 1
+        ? QString("Are you sure you want to remove this item?")
+        : QString("Are you sure you want to remove these %1 items?").arg(repoIndices.size());
+    if (QMessageBox::question(this, "Confirm Remove", question,
                               QMessageBox::Yes | QMessageBox::No)
         == QMessageBox::Yes)
     {
-        std::size_t repoIndex = displayedIndices_[row];
-        auto cmd = std::make_unique<RemoveCommand>(
-            repo_, repoIndex
-            );
+        // Several rows go in one pass and come back with one undo
+        CommandPtr cmd;
+        if (repoIndices.size() == 1) {
+            cmd = std::make_unique<RemoveCommand>(repo_, repoIndices.front());
+        } else {
+            cmd = std::make_unique<RemoveManyCommand>(repo_, std::move(repoIndices));
+        }
         pushCommand(std::move(cmd));
 
         filterActive_ = false;
@@ -475,6 +746,167 @@ void MainWindow::onRemove()
     }
 }
 
+void MainWindow::onAdjustPrices()
+{
+    std::set<std::string> locations;
+    for (std::size_t i = 0; i < repo_->size(); ++i) {
+        if (auto art = repo_->get(i)) locations.insert(art->getLocation());
+    }
+    if (locations.empty()) return;
+
+    QStringList choices;
+    for (const auto& loc : locations) choices << QString::fromStdString(loc);
+
+    bool ok;
+    QString location = QInputDialog::getItem(
+        this, tr("Adjust Prices"), tr("Location:"), choices, 0, false, &ok);
+    if (!ok) return;
+
+    double percent = QInputDialog::getDouble(
+        this, tr("Adjust Prices"), tr("Change in percent (e.g. 5 or -10):"),
+        0.0, -100.0, 1000.0, 2, &ok);
+    if (!ok || percent == 0.0) return;
+
+    // One price delta per work, executed and undone as a single unit
+    const std::string loc = location.toStdString();
+    const double factor = 1.0 + percent / 100.0;
+    auto batch = std::make_unique<CompositeCommand>(repo_);
+    for (std::size_t i = 0; i < repo_->size(); ++i) {
+        auto art = repo_->get(i);
+        if (!art || art->getLocation() != loc) continue;
+        batch->add(std::make_unique<FieldEditCommand>(
+            repo_, i, ArtField::Price, art->getPrice(), art->getPrice() * factor));
+    }
+    if (batch->empty()) return;
+
+    statusBar()->showMessage(tr("Adjusted %1 prices").arg(batch->size()), 3000);
+    pushCommand(std::move(batch));
+}
+
+void MainWindow::onImport()
+{
+    // Duplicates are checked against what is loaded, so wait for all of it
+    if (catalogLoader_->isRunning() || importer_->isRunning()) {
+        statusBar()->showMessage(tr("Still loading, try again in a moment"), 3000);
+        return;
+    }
+    const QString dir = QFileDialog::getExistingDirectory(
+        this, tr("Import catalog exports"), QFileInfo(catalogPath_).absolutePath());
+    if (dir.isEmpty()) return;
+
+    loadProgress->setRange(0, 0);
+    loadProgress->show();
+    importer_->start(dir, repo_->snapshot(), nameIndex_->bloomSnapshot());
+}
+
+void MainWindow::onImportBatch(const BulkImporter::Batch& batch)
+{
+    // One undo step per batch: a single step for the whole import would
+    // outgrow the undo budget and push out all earlier history, and its
+    // journal record would be encoded in one go on this thread
+    const std::size_t first = repo_->size();
+    repo_->addMany(batch);
+    auto cmd = std::make_unique<AddManyCommand>(repo_, batch, first);
+    cmd->markExecuted(true);
+    const std::size_t oversized = history_.oversizedCount();
+    history_.push(std::move(cmd));
+    if (history_.oversizedCount() != oversized) {
+        qWarning() << "[MainWindow] import batch of" << batch.size()
+                   << "records is over the undo budget; earlier undo steps were dropped";
+    }
+    searchEngine_->extend(std::make_shared<const ArtSnapshot>(batch), first);
+}
+
+void MainWindow::onImportFinished(const BulkImporter::Report& report)
+{
+    loadProgress->hide();
+    qInfo().noquote() << QString("[MainWindow] import: %1 files (%2 failed), %3 rows in %4 s "
+                                 "(%5 rows/s), %6 imported, %7 invalid, %8 duplicates")
+                             .arg(report.files).arg(report.failedFiles).arg(report.rows)
+                             .arg(report.seconds, 0, 'f', 2).arg(report.rowsPerSecond(), 0, 'f', 0)
+                             .arg(report.imported).arg(report.invalid).arg(report.duplicates);
+    statusBar()->showMessage(tr("Imported %1 of %2 rows (%3 rows/s); %4 duplicates, %5 invalid")
+                                 .arg(report.imported).arg(report.rows)
+                                 .arg(report.rowsPerSecond(), 0, 'f', 0)
+                                 .arg(report.duplicates).arg(report.invalid), 8000);
+}
+
+void MainWindow::onFindDuplicates()
+{
+    if (catalogLoader_->isRunning() || importer_->isRunning()) {
+        statusBar()->showMessage(tr("Still loading, try again in a moment"), 3000);
+        return;
+    }
+    if (!duplicateTask_.idle()) {
+        statusBar()->showMessage(tr("Already looking for duplicates"), 3000);
+        return;
+    }
+
+    // The search runs on a snapshot; edits made meanwhile are fine since
+    // the chosen records are looked up again by identity
+    auto cancelled = std::make_shared<std::atomic_bool>(false);
+    duplicateCancel_ = cancelled;
+    ArtSnapshotPtr items = repo_->snapshot();
+    loadProgress->setRange(0, 0);
+    loadProgress->show();
+    btnDuplicates->setEnabled(false);
+    statusBar()->showMessage(tr("Looking for duplicates among %1 artworks...").arg(items->size()));
+
+    duplicateTask_.submit(TaskScheduler::Priority::IndexBuild, [this, items, cancelled]() {
+        QElapsedTimer timer;
+        timer.start();
+        auto pairs = std::make_shared<std::vector<NearDuplicate>>(
+            NearDuplicateFinder::find(*items, NearDuplicateFinder::Options(), cancelled.get()));
+        const double seconds = timer.nsecsElapsed() / 1e9;
+        QMetaObject::invokeMethod(this, [this, items, pairs, cancelled, seconds]() {
+            if (cancelled->load()) return;
+            onDuplicatesFound(items, *pairs, seconds);
+        }, Qt::QueuedConnection);
+    }, cancelled);
+}
+
+void MainWindow::onDuplicatesFound(ArtSnapshotPtr items, const std::vector<NearDuplicate>& pairs,
+                                   double seconds)
+{
+    loadProgress->hide();
+    // Removals pushed before the journal is open would never be logged
+    btnDuplicates->setEnabled(!catalogLoader_->isRunning());
+    qInfo().noquote() << QString("[MainWindow] duplicates: %1 pairs among %2 artworks in %3 s")
+                             .arg(pairs.size()).arg(items->size()).arg(seconds, 0, 'f', 2);
+    if (pairs.empty()) {
+        statusBar()->showMessage(tr("No duplicates found"), 3000);
+        return;
+    }
+    statusBar()->clearMessage();
+
+    DuplicateReviewDialog dialog(items, pairs, this);
+    if (dialog.exec() != QDialog::Accepted) return;
+    const auto chosen = dialog.selected();
+    if (chosen.empty()) return;
+
+    // Indices may have moved since the snapshot; find the objects again
+    std::unordered_set<const ArtObject*> wanted;
+    for (const auto& art : chosen) wanted.insert(art.get());
+    std::vector<std::size_t> repoIndices;
+    const ArtSnapshotPtr current = repo_->snapshot();
+    for (std::size_t i = 0; i < current->size(); ++i) {
+        if (wanted.count(current->at(i).get())) repoIndices.push_back(i);
+    }
+    if (repoIndices.empty()) return;
+
+    statusBar()->showMessage(tr("Removed %1 duplicates").arg(repoIndices.size()), 3000);
+    CommandPtr cmd;
+    if (repoIndices.size() == 1) {
+        cmd = std::make_unique<RemoveCommand>(repo_, repoIndices.front());
+    } else {
+        cmd = std::make_unique<RemoveManyCommand>(repo_, std::move(repoIndices));
+    }
+    pushCommand(std::move(cmd));
+
+    filterActive_ = false;
+    searchActive_ = false;
+}
+
 void MainWindow::onChat()
 {
     chatDialog->show();
@@ -541,28 +973,81 @@ void MainWindow::onSearch()
 
 void MainWindow::onUndo()
 {
-    if (undoStack_.empty()) return;
+    if (!history_.undo()) return;
+    refreshList();
+}
 
-    CommandPtr cmd = std::move(undoStack_.back());
-    undoStack_.pop_back();
+void MainWindow::onRedo()
+{
+    if (!history_.redo()) return;
+    refreshList();
+}
 
-    cmd->undo();
-    redoStack_.push_back(std::move(cmd));
+void MainWindow::onThumbnailReady(const QString& path, const QSize& /*size*/, const QImage& image)
+{
+    // Ignore results for a selection the user has already moved away from
+    if (path != pendingImagePath_) return;
+    pendingImagePath_.clear();
+    imgLabel->setPixmap(QPixmap::fromImage(image));
+}
 
-    refreshList();
+void MainWindow::onThumbnailFailed(const QString& path, const QSize& /*size*/)
+{
+    if (path != pendingImagePath_) return;
+    pendingImagePath_.clear();
+    imgLabel->clear();
 }
 
-void MainWindow::onRedo()
+void MainWindow::onCatalogBatch(const CatalogLoader::Batch& batch)
 {
-    if (redoStack_.empty()) return;
+    // Loaded records are not undoable edits: add them directly. Only the
+    // new records are run through the current query, so the view never
+    // rescans the part that is already shown.
+    const std::size_t first = repo_->size();
+    repo_->addMany(batch);
+    searchEngine_->extend(std::make_shared<const ArtSnapshot>(batch), first);
+}
 
-    CommandPtr cmd = std::move(redoStack_.back());
-    redoStack_.pop_back();
+void MainWindow::onCatalogProgress(int percent)
+{
+    if (percent < 0) {
+        loadProgress->setRange(0, 0);   // busy indicator
+    } else {
+        loadProgress->setRange(0, 100);
+        loadProgress->setValue(percent);
+    }
+}
 
-    cmd->execute();
-    undoStack_.push_back(std::move(cmd));
+void MainWindow::onCatalogLoaded(bool ok)
+{
+    loadProgress->hide();
+    if (!ok) {
+        qWarning() << "[MainWindow] could not load catalog" << catalogPath_;
+        catalogLoadFailed_ = true;
+    }
+    statusBar()->showMessage(tr("%1 artworks loaded").arg(repo_->size()), 3000);
 
-    refreshList();
+    // Undo history from earlier sessions of this catalog
+    if (ok && !catalogPath_.isEmpty()
+        && journal_.open(catalogPath_, repo_, history_) == UndoJournal::State::Recovered) {
+        statusBar()->showMessage(tr("Recovered unsaved edits from the last session"), 5000);
+        refreshList();
+    }
+    setEditingEnabled(true);
+
+    // An incomplete repo would evict thumbnails of artworks it is missing
+    if (ok) pruneThumbnailCache();
+}
+
+void MainWindow::onToggleGallery(bool on)
+{
+    btnGallery->setText(on ? "List" : "Gallery");
+    if (on) {
+        viewStack->setCurrentWidget(galleryView);
+        galleryView->setCurrentRow(listWidget->currentRow());
+    } else {
+        viewStack->setCurrentWidget(listWidget);
+    }
 }
 
 void MainWindow::showEvent(QShowEvent *event)
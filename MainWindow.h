@@ -9,6 +9,9 @@
 #include <QLineEdit>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QStackedWidget>
+#include <QProgressBar>
+#include <QTimer>
 
 #include "ChatDialog.h"
 #include "ArtRepositoryInterface.h"
@@ -16,9 +19,24 @@
 #include "CsvRepository.h"
 #include "JsonRepository.h"
 #include "Command.h"
-
+#include "UndoHistory.h"
+#include "UndoJournal.h"
+#include "ThumbnailLoader.h"
+#include "ImagePrefetcher.h"
+#include "GalleryView.h"
+#include "CatalogLoader.h"
+#include "SearchEngine.h"
+#include "BulkImporter.h"
+#include "NameIndex.h"
+#include "NearDuplicateFinder.h"
+#include "SimilarityIndex.h"
+#include "CatalogRetriever.h"
+#include "TaskScheduler.h"
+
+#include <array>
 #include <vector>
 #include <memory>
+#include <unordered_set>
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -33,40 +51,72 @@ public:
 private:
     void setupUI();
     void refreshList();
+    SearchQuery currentQuery() const;
+    void resetResults();
     void displayDetails(std::size_t repoIndex);
+    void pruneThumbnailCache();
+    void schedulePrefetch();
     void pushCommand(CommandPtr cmd);
+    // Add/Edit/Remove/Adjust/Undo/Redo/Duplicates, off while the catalog loads
+    void setEditingEnabled(bool on);
 
 private slots:
     void onSelectionChanged(int row);
+    void onSimilarActivated(QListWidgetItem* item);
     void onAdd();
     void onEdit();
     void onRemove();
+    void onAdjustPrices();
+    void onImport();
+    void onFindDuplicates();
     void onChat();
     void onFilter();
     void onClearFilter();
     void onSearch();
     void onUndo();
     void onRedo();
+    void onThumbnailReady(const QString& path, const QSize& size, const QImage& image);
+    void onThumbnailFailed(const QString& path, const QSize& size);
+    void onToggleGallery(bool on);
+    void onCatalogBatch(const CatalogLoader::Batch& batch);
+    void onCatalogProgress(int percent);
+    void onCatalogLoaded(bool ok);
+    void onImportBatch(const BulkImporter::Batch& batch);
+    void onImportFinished(const BulkImporter::Report& report);
+    void onDuplicatesFound(ArtSnapshotPtr items, const std::vector<NearDuplicate>& pairs,
+                           double seconds);
+    void onSearchResults(quint64 id, const std::vector<SearchHit>& hits);
+    void onSearchFinished(quint64 id);
 
 private:
     QWidget*       central        = nullptr;
     QSplitter*     splitter       = nullptr;
 
-    // Left pane: search + list
+    // Left pane: search + list / gallery
     QWidget*       leftPane       = nullptr;
     QLineEdit*     searchEdit     = nullptr;
     QPushButton*   btnSearch      = nullptr;
+    QPushButton*   btnGallery     = nullptr;
+    QStackedWidget* viewStack     = nullptr;
     QListWidget*   listWidget     = nullptr;
+    GalleryView*   galleryView    = nullptr;
 
     // Right pane: image + details
     QWidget*       rightPane      = nullptr;
     QLabel*        imgLabel       = nullptr;
     QLabel*        lblDetails     = nullptr;
+    QLabel*        lblSimilar     = nullptr;
+    QListWidget*   similarList    = nullptr;
+
+    QProgressBar*  loadProgress   = nullptr;
 
     // Bottom row 1: CRUD / Filter / Clear Filter
     QPushButton*   btnAdd         = nullptr;
     QPushButton*   btnEdit        = nullptr;
     QPushButton*   btnRemove      = nullptr;
+    QPushButton*   btnAdjust      = nullptr;
+    QPushButton*   btnImport      = nullptr;
+    QPushButton*   btnDuplicates  = nullptr;
     QPushButton*   btnChat        = nullptr;
     QPushButton*   btnFilter      = nullptr;
     QPushButton*   btnClearFilter = nullptr;
@@ -77,8 +127,32 @@ private:
 
     ChatDialog*    chatDialog     = nullptr;
 
+    // Off-thread image decoding for the preview
+    std::shared_ptr<ThumbnailDiskCache> thumbnailDisk_;
+    ThumbnailLoader* thumbnails_  = nullptr;
+    ImagePrefetcher* prefetcher_  = nullptr;
+    QString          pendingImagePath_;
+
     // Now a shared_ptr instead of unique_ptr:
     std::shared_ptr<ArtRepositoryInterface> repo_;
+    // Exact-name lookups: duplicate checks and the exact search tier
+    std::unique_ptr<NameIndex>              nameIndex_;
+    // "Similar artworks" under the details
+    std::unique_ptr<SimilarityIndex>        similarityIndex_;
+    // Catalog records for the chat's questions, from similarityIndex_
+    std::unique_ptr<CatalogRetriever>       catalogRetriever_;
+
+    // Background load of the catalog file
+    CatalogLoader* catalogLoader_ = nullptr;
+    QString        catalogPath_;
+    bool           catalogLoadFailed_ = false;   // repo_ holds only part of it
+
+    // Bulk import of a directory of exports; one undo step per batch
+    BulkImporter*  importer_      = nullptr;
+
+    // Near-duplicate search over a snapshot, reviewed when it is done
+    TaskGroup      duplicateTask_{true};
+    std::shared_ptr<std::atomic_bool> duplicateCancel_;
 
     // Filter state
     bool                    filterActive_   = false;
@@ -89,12 +163,23 @@ private:
     bool                    searchActive_   = false;
     QString                 searchText_;
 
+    // Query evaluation off the GUI thread
+    SearchEngine*           searchEngine_   = nullptr;
+    QTimer*                 searchDebounce_ = nullptr;
+    quint64                 queryId_        = 0;
+    bool                    resultsStale_   = false;  // rows belong to an older query
+    bool                    galleryDirty_   = false;
+    // Exact matches shown straight from nameIndex_; the scan skips them
+    std::unordered_set<std::size_t> exactHits_;
+
     // Map from visible row → actual repo index
     std::vector<std::size_t> displayedIndices_;
+    // Rows per rank tier, best tier first
+    std::array<std::size_t, SearchQuery::kRanks> tierSizes_{};
 
-    // Command stacks for undo/redo
-    std::vector<CommandPtr>  undoStack_;
-    std::vector<CommandPtr>  redoStack_;
+    // Undo/redo, bounded by memory and mirrored to <catalog>.undo
+    UndoHistory              history_;
+    UndoJournal              journal_;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,16 @@
+#ifndef MIX64_H
+#define MIX64_H
+
+#include <cstdint>
+
+// SplitMix64's step and finalizer: every input bit affects every output
+// bit. Finishes hashes that are weak in their low bits (std::hash, FNV-1a)
+// and drives CatalogGenerator's random numbers.
+inline std::uint64_t mix64(std::uint64_t x) noexcept {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+#endif // MIX64_H
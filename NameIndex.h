@@ -0,0 +1,78 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ArtRepositoryInterface.h"
+#include "BloomFilter.h"
+
+// Exact-name lookup: normalized name → repository indices, kept up to
+// date through RepositoryObserver. Names are compared after Unicode
+// compatibility normalization (NFKC), case folding and whitespace
+// simplification, so "Mona  Lisa", "MONA LISA" and "ｍｏｎａ ｌｉｓａ"
+// are the same name.
+//
+// A Bloom filter over the names answers "definitely not present"
+// without touching the map; a copy of it can be handed to worker
+// threads (the bulk import checks rows against it in parallel).
+//
+// Removals shift the indices of everything after them. Inside a batch
+// they are collected and applied in one pass at the end, so removing k
+// records costs O(n log k) instead of O(n·k).
+//
+// GUI thread only, like the repository's mutating side.
+class NameIndex : public RepositoryObserver {
+public:
+    explicit NameIndex(std::shared_ptr<ArtRepositoryInterface> repo);
+    ~NameIndex() override;
+
+    NameIndex(const NameIndex&) = delete;
+    NameIndex& operator=(const NameIndex&) = delete;
+
+    // ── Keys (thread-safe) ──
+    static std::string normalize(const QString& name);
+    static std::string normalize(const std::string& utf8Name);
+    static std::uint64_t hashKey(const std::string& key) noexcept;
+
+    // ── Lookup ──
+    // false: no record has this name; true: probably one does
+    bool mightContain(const QString& name) const;
+    // Indices of the records with this name, ascending
+    std::vector<std::size_t> find(const QString& name) const;
+    std::size_t size() const noexcept { return count_; }
+
+    // Copy of the filter, for use off the GUI thread
+    std::shared_ptr<const BloomFilter> bloomSnapshot() const;
+
+    // ── RepositoryObserver ──
+    void itemAdded(std::size_t index, const ArtPtr& art) override;
+    void itemUpdated(std::size_t index, const ArtPtr& oldArt, const ArtPtr& newArt) override;
+    void itemRemoved(std::size_t index, const ArtPtr& art) override;
+    void itemsReset() override;
+    void repositoryChanged() override;
+
+private:
+    using Postings = std::vector<std::size_t>;   // ascending
+
+    void rebuild();
+    void rebuildBloom();
+    void flushRemovals();
+    void insertPosting(const std::string& key, std::size_t index);
+    void erasePosting(const std::string& key, std::size_t index);
+
+    std::shared_ptr<ArtRepositoryInterface>   repo_;
+    std::unordered_map<std::string, Postings> postings_;
+    BloomFilter              bloom_;
+    std::size_t              bloomCapacity_ = 0;
+    std::size_t              staleInBloom_  = 0;   // removed or renamed since rebuild
+    std::size_t              count_         = 0;
+    std::vector<std::size_t> pendingRemovals_;     // descending, not yet shifted
+};
+
+#endif // NAMEINDEX_H
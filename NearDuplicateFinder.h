@@ -0,0 +1,63 @@
+#ifndef NEARDUPLICATEFINDER_H
+#define NEARDUPLICATEFINDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "ArtSnapshot.h"
+
+class ArtObject;
+
+struct NearDuplicate {
+    std::size_t first;        // snapshot indices, first < second
+    std::size_t second;
+    double      similarity;   // Jaccard similarity of the shingle sets
+};
+
+struct NearDuplicateOptions {
+    double      threshold = 0.7;   // minimum Jaccard similarity reported
+    int         bands     = 16;
+    int         rows      = 4;     // values per band
+    // A bucket this big (e.g. a boilerplate description) only pairs
+    // each member with the next maxBucket - 1, not with all others
+    std::size_t maxBucket = 50;
+};
+
+// Finds records that are probably the same artwork entered twice with
+// slightly different names, descriptions or prices, without comparing
+// every pair.
+//
+// Each record's name and description are cut into overlapping
+// 4-character shingles. A MinHash signature of bands×rows values
+// summarizes the shingle set, and two records agree on any one value
+// with probability equal to their Jaccard similarity. LSH banding turns
+// each band of 'rows' values into a bucket key; records sharing a bucket
+// in any band become candidates. Candidates whose signatures clearly
+// disagree are dropped, the rest are verified on their exact shingle
+// sets. With the defaults, a pair at similarity 0.7 is found 99% of the
+// time, one at 0.3 becomes a candidate about 12% of the time.
+//
+// Signatures and verification run in parallel on the shared scheduler.
+// A signature takes one byte per value (64 bytes per record by default).
+class NearDuplicateFinder {
+public:
+    using Options = NearDuplicateOptions;
+
+    // Pairs of records of the same type at or above the threshold, most
+    // similar first. Stops early, with an empty or partial result, once
+    // 'cancelled' is set.
+    static std::vector<NearDuplicate> find(const ArtSnapshot& items,
+                                           const Options& options = Options(),
+                                           const std::atomic_bool* cancelled = nullptr);
+
+    // ── Building blocks (also used by the tests) ──
+    // Sorted, distinct shingle hashes of name + description
+    static std::vector<std::uint64_t> shingles(const ArtObject& art);
+    static std::vector<std::uint32_t> signature(const std::vector<std::uint64_t>& shingles,
+                                                int hashes);
+    static double jaccard(const std::vector<std::uint64_t>& a,
+                          const std::vector<std::uint64_t>& b) noexcept;
+};
+
+#endif // NEARDUPLICATEFINDER_H
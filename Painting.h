@@ -18,6 +18,7 @@ public:
 
     const std::string& getCanvasType() const noexcept;
     std::string getType() const noexcept override;
+    std::shared_ptr<ArtObject> clone() const override;
 
     void setCanvasType(const std::string& canvasType);
 
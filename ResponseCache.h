@@ -0,0 +1,76 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QUrl>
+
+#include <vector>
+
+#include "ChatContext.h"
+
+// Completed chat replies on disk, addressed by what was asked: the key is
+// a SHA-256 of the endpoint, the model and the normalized message list, so
+// the same question with the same history and catalog context is answered
+// locally. Normalization folds whitespace runs, Unicode forms and, in the
+// user's own messages, case ("Which  sculptures?" = "which sculptures?").
+//
+// One file per reply, <key>.txt, holding the reply text. Entries older
+// than the age limit are misses and are deleted; past the size limit the
+// least recently used ones go first.
+//
+// GUI thread only.
+class ResponseCache {
+public:
+    static constexpr qint64 kDefaultMaxBytes      = 16 * 1024 * 1024;
+    static constexpr qint64 kDefaultMaxAgeSeconds = 7 * 24 * 3600;
+
+    struct Stats {
+        quint64 hits    = 0;
+        quint64 misses  = 0;
+        quint64 evicted = 0;
+    };
+
+    explicit ResponseCache(const QString& dirPath,
+                           qint64 maxBytes = kDefaultMaxBytes,
+                           qint64 maxAgeSeconds = kDefaultMaxAgeSeconds);
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    // <cache dir>/chat
+    static QString defaultPath();
+
+    static QByteArray key(const QUrl& endpoint, const QString& model,
+                          const std::vector<ChatMessage>& messages);
+
+    bool lookup(const QByteArray& key, QString* text);
+    void insert(const QByteArray& key, const QString& text);
+
+    int entryCount() const noexcept { return index_.size(); }
+    qint64 totalBytes() const noexcept { return bytes_; }
+    const Stats& stats() const noexcept { return stats_; }
+
+private:
+    struct Entry {
+        qint64 size   = 0;
+        qint64 stored = 0;   // ms since epoch (file mtime)
+        quint64 used  = 0;   // useClock_ at the last insert or hit
+    };
+
+    QString pathFor(const QByteArray& key) const;
+    void scan();
+    void remove(const QByteArray& key);
+    void evict();
+
+    QString                         dir_;
+    qint64                          maxBytes_;
+    qint64                          maxAgeMs_;
+    qint64                          bytes_ = 0;
+    quint64                         useClock_ = 0;
+    QHash<QByteArray, Entry>        index_;
+    Stats                           stats_;
+};
+
+#endif // RESPONSECACHE_H
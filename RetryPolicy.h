@@ -0,0 +1,35 @@
+#ifndef RETRYPOLICY_H
+#define RETRYPOLICY_H
+
+#include <algorithm>
+#include <cmath>
+
+// When and how long to wait before trying a request again.
+//
+// Only overload and gateway answers are retried (429, 500, 502, 503,
+// 504), and failures that happened before any reply data arrived
+// (timeouts, dropped connections). A reply that has started streaming is
+// never retried: the user has already seen part of it.
+//
+// Delays grow exponentially with "full jitter": a uniform pick between 0
+// and min(maxDelayMs, baseDelayMs * 2^attempt), so clients that failed
+// together do not come back together. A server's Retry-After is a floor.
+struct RetryPolicy {
+    int    maxAttempts = 4;      // including the first
+    double baseDelayMs = 500;
+    double maxDelayMs  = 8000;
+
+    static bool retryableStatus(int httpStatus) noexcept {
+        return httpStatus == 429 || httpStatus == 500 || httpStatus == 502
+            || httpStatus == 503 || httpStatus == 504;
+    }
+
+    // 'attempt' counts from 1 (the attempt that just failed); 'unit' is
+    // uniform in [0, 1)
+    double delayMs(int attempt, double unit, double retryAfterMs = 0.0) const noexcept {
+        const double cap = std::min(maxDelayMs, baseDelayMs * std::ldexp(1.0, std::max(0, attempt - 1)));
+        return std::max(retryAfterMs, unit * cap);
+    }
+};
+
+#endif // RETRYPOLICY_H
@@ -17,6 +17,7 @@ public:
 
     const std::string& getMaterial() const noexcept;
     std::string getType() const noexcept override;
+    std::shared_ptr<ArtObject> clone() const override;
 
     void setMaterial(const std::string& material);
 
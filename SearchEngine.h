@@ -0,0 +1,80 @@
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "ArtSnapshot.h"
+#include "TaskScheduler.h"
+
+class ArtObject;
+
+// What the list shows: everything, a name search or a price filter.
+struct SearchQuery {
+    enum class Mode { All, Name, Price };
+
+    Mode    mode  = Mode::All;
+    QString text;                // Name: matched case-insensitively
+    double  price = 0.0;         // Price: threshold
+    bool    above = true;        // Price: >= threshold, else <=
+    // Name: exact matches were found elsewhere (NameIndex); report only
+    // prefixes and substrings
+    bool    skipExact = false;
+
+    // Rank of 'art' for this query (0 is best), or -1 if it does not
+    // match. Name search ranks exact matches, then prefixes, then
+    // substrings.
+    int rank(const ArtObject& art) const;
+    static constexpr int kRanks = 3;
+};
+
+struct SearchHit {
+    std::size_t index;   // repository index
+    int         rank;
+};
+
+// Evaluates SearchQuery against repository snapshots on a worker thread
+// and reports matches in chunks. Starting a new query cancels the one in
+// flight, so a stale scan never delivers anything.
+class SearchEngine : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SearchEngine(QObject* parent = nullptr);
+    ~SearchEngine() override;
+
+    // Scan all of 'snapshot'; returns the id results will carry.
+    quint64 start(const SearchQuery& query, ArtSnapshotPtr snapshot);
+
+    // Scan records appended after the current query started ('records'
+    // sit at repository indices baseIndex...). Results are reported
+    // under the current id, after those of the main scan. Exact matches
+    // are reported here even if the query skips them: the caller's
+    // index lookup predates these records.
+    void extend(ArtSnapshotPtr records, std::size_t baseIndex);
+
+    void cancel();
+    quint64 currentId() const noexcept;
+
+signals:
+    void resultsReady(quint64 id, const std::vector<SearchHit>& hits);
+    // Every scan started or extended for 'id' has reported.
+    void finished(quint64 id);
+
+private:
+    using Token = std::shared_ptr<std::atomic_bool>;
+
+    void submit(ArtSnapshotPtr records, std::size_t baseIndex, const SearchQuery& query);
+
+    TaskGroup   tasks_{true};   // scans of one query run, and report, in order
+    SearchQuery query_;
+    Token       token_;
+    quint64     id_      = 0;
+    int         pending_ = 0;   // scans of id_ that have not finished
+};
+
+#endif // SEARCHENGINE_H
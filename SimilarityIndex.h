@@ -0,0 +1,121 @@
+#ifndef SIMILARITYINDEX_H
+#define SIMILARITYINDEX_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ArtRepositoryInterface.h"
+
+enum class ArtKind : std::uint8_t { Other, Painting, Sculpture, DigitalArt };
+
+// Hard constraints for SimilarityIndex::search(); empty lists match all
+struct SimilarityFilter {
+    std::vector<ArtKind>       kinds;
+    std::vector<std::uint32_t> locations;   // ids from locationsIn()
+    double minPrice = 0.0;
+    double maxPrice = std::numeric_limits<double>::infinity();
+
+    bool empty() const noexcept {
+        return kinds.empty() && locations.empty() && minPrice <= 0.0
+            && maxPrice == std::numeric_limits<double>::infinity();
+    }
+};
+
+struct SimilarHit {
+    std::size_t index;   // repository index
+    float       score;   // higher is more similar, at most 1
+};
+
+// "Similar artworks": for one record, the k records closest to it by
+// text and price, kept up to date through RepositoryObserver.
+//
+// Words of the name (counted twice), description and material/canvas/
+// software are weighted by TF-IDF and hashed into kDims signed
+// dimensions. The vector is normalized and stored as kDims int8 values
+// plus a scale, so a million records take ~70 MB and a query streams
+// through them with an int8 dot-product kernel (SSE2, AVX2 when the CPU
+// has it, or NEON), keeping the best k in a bounded heap per slice of
+// records. The score is
+//   (1 - kPriceWeight) * cosine + kPriceWeight / (1 + |ln(1+p1) - ln(1+p2)|)
+//
+// Document frequencies are counted as records come and go; a record is
+// encoded with the frequencies of the moment. All vectors are encoded
+// again when the catalog has doubled or halved since the last time.
+//
+// Kind, location and price are kept alongside each vector, so search()
+// can filter on them in the same pass (the chat's catalog retrieval).
+//
+// Removals are deferred to the end of a batch, like NameIndex.
+// GUI thread only; queries use the shared scheduler's workers.
+class SimilarityIndex : public RepositoryObserver {
+public:
+    static constexpr std::size_t kDims        = 64;    // multiple of 16
+    static constexpr float       kPriceWeight = 0.15f;
+
+    explicit SimilarityIndex(std::shared_ptr<ArtRepositoryInterface> repo);
+    ~SimilarityIndex() override;
+
+    SimilarityIndex(const SimilarityIndex&) = delete;
+    SimilarityIndex& operator=(const SimilarityIndex&) = delete;
+
+    // Best 'k' other records for the record at 'index', best first
+    std::vector<SimilarHit> similar(std::size_t index, std::size_t k) const;
+    std::size_t size() const noexcept { return scales_.size(); }
+
+    // Best 'k' records for free text (e.g. a chat question) that pass
+    // 'filter', best first. Words no record contains are ignored; when
+    // none are left, matching records come in catalog order.
+    std::vector<SimilarHit> search(const std::string& text, const SimilarityFilter& filter,
+                                   std::size_t k) const;
+    // Catalog locations named in 'text': the whole location, or one of
+    // its words of at least 4 letters that is not generic ("vienna" or
+    // "albertina" for "Albertina, Vienna", but not "museum")
+    std::vector<std::uint32_t> locationsIn(const std::string& text) const;
+    const std::string& locationName(std::uint32_t id) const { return locationNames_.at(id); }
+
+    // ── Building blocks (also used by the tests) ──
+    // Lowercased words of the weighted fields, repeated by weight
+    static std::vector<std::string> terms(const ArtObject& art);
+    static ArtKind kindOf(const ArtObject& art) noexcept;
+    // Sum of a[i]*b[i], with the same kernel the queries use
+    static std::int32_t dot(const std::int8_t* a, const std::int8_t* b,
+                            std::size_t n) noexcept;
+
+    // ── RepositoryObserver ──
+    void itemAdded(std::size_t index, const ArtPtr& art) override;
+    void itemUpdated(std::size_t index, const ArtPtr& oldArt, const ArtPtr& newArt) override;
+    void itemRemoved(std::size_t index, const ArtPtr& art) override;
+    void itemsReset() override;
+    void repositoryChanged() override;
+
+private:
+    void rebuild();
+    void reencodeAll();
+    void encode(std::size_t index, const ArtObject* art);
+    void setAttributes(std::size_t index, const ArtObject* art);
+    std::vector<SimilarHit> scan(const std::int8_t* query, float queryScale, float queryPrice,
+                                 float priceWeight, const SimilarityFilter* filter,
+                                 std::size_t skip, std::size_t k) const;
+    void countTerms(const ArtObject& art, int delta);
+    void flushRemovals();
+
+    std::shared_ptr<ArtRepositoryInterface>      repo_;
+    std::unordered_map<std::uint64_t, std::uint32_t> documentFrequency_;   // by term hash
+    std::vector<std::int8_t> vectors_;      // kDims per record
+    std::vector<float>       scales_;       // cosine = scale_a * scale_b * dot
+    std::vector<float>       logPrices_;    // ln(1 + price)
+    std::vector<float>       prices_;
+    std::vector<ArtKind>     kinds_;
+    std::vector<std::uint32_t> locations_;  // ids into locationNames_
+    std::vector<std::string> locationNames_;   // lowercased, never shrinks
+    std::unordered_map<std::string, std::uint32_t> locationIds_;
+    std::size_t              documents_   = 0;   // records indexed, the N of idf
+    std::size_t              encodedAt_   = 0;   // documents_ at the last full encode
+    std::vector<std::size_t> pendingRemovals_;   // descending, not yet compacted
+};
+
+#endif // SIMILARITYINDEX_H
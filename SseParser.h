@@ -0,0 +1,106 @@
+#ifndef SSEPARSER_H
+#define SSEPARSER_H
+
+#include <string>
+#include <vector>
+
+// One server-sent event
+struct SseEvent {
+    std::string event;   // "" means the default "message"
+    std::string data;    // data lines joined with '\n'
+    std::string id;
+};
+
+// Incremental parser for a text/event-stream body, as the chat endpoint
+// sends when asked to stream. Bytes may be fed in any split (a network
+// read can end mid-line, even between '\r' and '\n'); complete events
+// come out in order. Comment lines (": keep-alive") are skipped.
+class SseParser {
+public:
+    std::vector<SseEvent> feed(const char* data, std::size_t size) {
+        std::vector<SseEvent> out;
+        for (std::size_t i = 0; i < size; ++i) {
+            const char c = data[i];
+            if (skipLineFeed_) {
+                skipLineFeed_ = false;
+                if (c == '\n') continue;
+            }
+            if (c == '\r' || c == '\n') {
+                skipLineFeed_ = (c == '\r');
+                processLine(out);
+                line_.clear();
+            } else {
+                line_ += c;
+            }
+        }
+        return out;
+    }
+
+    std::vector<SseEvent> feed(const std::string& data) {
+        return feed(data.data(), data.size());
+    }
+
+    // End of stream. An event cut off before its blank line is still
+    // delivered; the spec drops it, but some servers close right after
+    // the last data line.
+    std::vector<SseEvent> finish() {
+        std::vector<SseEvent> out;
+        if (!line_.empty()) processLine(out);
+        line_.clear();
+        processLine(out);   // as if the blank line had come
+        reset();
+        return out;
+    }
+
+    void reset() {
+        line_.clear();
+        current_ = SseEvent();
+        hasData_ = false;
+        skipLineFeed_ = false;
+        started_ = false;
+    }
+
+private:
+    void processLine(std::vector<SseEvent>& out) {
+        if (!started_) {
+            started_ = true;
+            if (line_.compare(0, 3, "\xEF\xBB\xBF") == 0) line_.erase(0, 3);
+        }
+        if (line_.empty()) {
+            // Blank line: dispatch
+            if (hasData_) {
+                if (!current_.data.empty() && current_.data.back() == '\n') current_.data.pop_back();
+                out.push_back(std::move(current_));
+            }
+            current_ = SseEvent();
+            hasData_ = false;
+            return;
+        }
+        if (line_[0] == ':') return;
+
+        const std::size_t colon = line_.find(':');
+        const std::string field = line_.substr(0, colon);
+        std::string value;
+        if (colon != std::string::npos) {
+            value = line_.substr(colon + 1);
+            if (!value.empty() && value[0] == ' ') value.erase(0, 1);
+        }
+        if (field == "data") {
+            current_.data += value;
+            current_.data += '\n';
+            hasData_ = true;
+        } else if (field == "event") {
+            current_.event = value;
+        } else if (field == "id") {
+            current_.id = value;
+        }
+    }
+
+    std::string line_;
+    SseEvent    current_;
+    bool        hasData_      = false;
+    bool        skipLineFeed_ = false;
+    bool        started_      = false;
+};
+
+#endif // SSEPARSER_H
@@ -0,0 +1,162 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Process-wide work-stealing thread pool shared by every background
+// feature (catalog loading, search, thumbnails, indexing, saving), so
+// they never add up to more threads than there are cores.
+//
+// Tasks carry a priority and always run highest priority first. Tasks
+// submitted from a worker go to that worker's own deques (LIFO, cache
+// warm); tasks from other threads go to a shared injection queue. Idle
+// workers steal the oldest task of the best priority from the others.
+//
+// A task submitted with a cancel token is skipped if the token is set
+// before it starts; long tasks should poll it themselves as well.
+// Owners that capture 'this' in tasks go through a TaskGroup, which can
+// cancel what is still queued and wait for the rest.
+class TaskScheduler {
+public:
+    enum class Priority {
+        Interactive = 0,   // queries the user is waiting on
+        Thumbnail,         // images on screen
+        Prefetch,          // images likely to be on screen next
+        IndexBuild,        // indexes over the catalog
+        Autosave,          // journal and file writes
+        Compaction,        // cache and file housekeeping
+    };
+    static constexpr int kPriorities = 6;
+
+    using Task        = std::function<void()>;
+    using CancelToken = std::shared_ptr<std::atomic_bool>;
+
+    struct PriorityStats {
+        std::size_t   queued    = 0;   // waiting right now
+        std::uint64_t submitted = 0;
+        std::uint64_t completed = 0;
+        std::uint64_t cancelled = 0;   // skipped before they started
+        std::uint64_t stolen    = 0;   // taken from another worker's deque
+        double        avgWaitMs = 0;   // queue latency, submit → start
+        double        maxWaitMs = 0;
+        double        avgRunMs  = 0;
+    };
+    using Stats = std::array<PriorityStats, kPriorities>;
+
+    // The shared instance, sized to the machine
+    static TaskScheduler& instance();
+
+    // 0 threads: one per hardware thread
+    explicit TaskScheduler(unsigned threads = 0);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    void submit(Priority priority, Task task, CancelToken token = nullptr);
+
+    // Run body(begin, end) over [0, n) in slices of 'grain', on the
+    // workers and the calling thread, and return when all slices are
+    // done. The caller works through slices itself, so this finishes
+    // even if no worker is free (and may be called from a task).
+    void parallelFor(Priority priority, std::size_t n, std::size_t grain,
+                     const std::function<void(std::size_t, std::size_t)>& body);
+
+    unsigned threadCount() const noexcept { return static_cast<unsigned>(workers_.size()); }
+    std::size_t queueDepth(Priority priority) const noexcept;
+    Stats stats() const;
+    // One line per priority that has seen any work
+    std::string statsSummary() const;
+
+    static const char* priorityName(Priority priority) noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Item {
+        Task              task;
+        CancelToken       token;
+        Priority          priority = Priority::Interactive;
+        Clock::time_point queuedAt;
+    };
+
+    struct Worker {
+        std::mutex                              mutex;
+        std::array<std::deque<Item>, kPriorities> queues;
+        std::thread                             thread;
+    };
+
+    struct Counters {
+        std::atomic<std::size_t>   queued{0};
+        std::atomic<std::uint64_t> submitted{0};
+        std::atomic<std::uint64_t> completed{0};
+        std::atomic<std::uint64_t> cancelled{0};
+        std::atomic<std::uint64_t> stolen{0};
+        std::atomic<std::uint64_t> waitUsTotal{0};
+        std::atomic<std::uint64_t> waitUsMax{0};
+        std::atomic<std::uint64_t> runUsTotal{0};
+    };
+
+    void run(std::size_t self);
+    bool take(std::size_t self, Item* out);
+    void execute(Item& item);
+
+    std::vector<std::unique_ptr<Worker>>        workers_;
+    std::mutex                                  injectMutex_;
+    std::array<std::deque<Item>, kPriorities>   inject_;
+    std::array<Counters, kPriorities>           counters_;
+
+    // Sleeping workers wait here until something is queued
+    std::mutex              sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<std::size_t> pending_{0};
+    bool                    stopping_ = false;
+};
+
+// Tasks submitted on behalf of one owner. cancel() skips everything the
+// group queued so far; wait() blocks until none of its tasks is queued
+// or running. The destructor does both, so a group declared as a member
+// keeps tasks from outliving the object they capture.
+//
+// A serial group runs its tasks one at a time in submission order, on
+// whichever worker is free (for work that must not overlap, like
+// appending to a file).
+class TaskGroup {
+public:
+    using Priority    = TaskScheduler::Priority;
+    using Task        = TaskScheduler::Task;
+    using CancelToken = TaskScheduler::CancelToken;
+
+    explicit TaskGroup(bool serial = false,
+                       TaskScheduler& scheduler = TaskScheduler::instance());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void submit(Priority priority, Task task, CancelToken token = nullptr);
+    void cancel();
+    void wait();
+    bool idle() const;
+
+private:
+    struct State;
+    static std::shared_ptr<void> makeTicket(const std::shared_ptr<State>& state);
+    static void pump(const std::shared_ptr<State>& state);
+
+    TaskScheduler&         scheduler_;
+    std::shared_ptr<State> state_;
+};
+
+#endif // TASKSCHEDULER_H
@@ -0,0 +1,95 @@
+#ifndef THUMBNAILDISKCACHE_H
+#define THUMBNAILDISKCACHE_H
+
+#include <QString>
+#include <QSize>
+#include <QImage>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+
+#include <vector>
+
+// Persistent cache of pre-scaled thumbnails packed into a single file.
+//
+// The file is a header followed by append-only records, each holding a
+// small fixed header and the raw ARGB32 pixels of one thumbnail. It is
+// memory-mapped, so a hit is a stat() of the source image plus one copy
+// out of the mapping; no image decoding is involved. As the file grows
+// only the new tail is mapped, in a window of its own.
+//
+// Records are keyed by (image path, requested size) and stamped with the
+// source file's mtime and byte size. A record whose stamp no longer
+// matches the file is treated as a miss and is replaced on the next
+// insert. Superseded and pruned records are garbage until compact().
+//
+// The layout uses native byte order: the cache is local to one machine.
+// All methods are thread-safe. compact() copies the live records without
+// holding the lock, so lookups and inserts only wait for the final swap.
+class ThumbnailDiskCache {
+public:
+    explicit ThumbnailDiskCache(const QString& filePath);
+    ~ThumbnailDiskCache();
+
+    ThumbnailDiskCache(const ThumbnailDiskCache&) = delete;
+    ThumbnailDiskCache& operator=(const ThumbnailDiskCache&) = delete;
+
+    // <cache dir>/thumbnails.bin
+    static QString defaultPath();
+
+    bool isOpen() const;
+    int entryCount() const;
+
+    // Returns true and fills *out if a fresh thumbnail for 'imagePath'
+    // at 'size' is stored.
+    bool lookup(const QString& imagePath, const QSize& size, QImage* out);
+
+    // Store 'image' as the thumbnail of 'imagePath' at 'size'.
+    void insert(const QString& imagePath, const QSize& size, const QImage& image);
+
+    // Evict every record whose image is not in 'livePaths' (artworks that
+    // were removed from the catalog) and rewrite the file if enough of it
+    // has become garbage.
+    void prune(const QSet<QString>& livePaths);
+
+private:
+    struct Entry {
+        quint64 stamp    = 0;   // hash of mtime + file size
+        quint64 pathHash = 0;
+        qint64  offset   = 0;   // of the record header
+        qint64  length   = 0;   // header + payload + padding
+        qint32  width    = 0;
+        qint32  height   = 0;
+        qint32  bytesPerLine = 0;
+    };
+
+    static quint64 slotHash(const QString& imagePath, const QSize& size);
+    static quint64 pathHash(const QString& imagePath);
+    static bool stampFor(const QString& imagePath, quint64* stamp);
+
+    // A mapped range of the file. Windows are contiguous and end on a
+    // record boundary, so a record never straddles two of them.
+    struct Window {
+        qint64 start = 0;
+        qint64 size  = 0;
+        uchar* data  = nullptr;
+    };
+
+    bool openFile();
+    void scan();
+    const uchar* mapped(qint64 offset, qint64 length);
+    void unmap();
+    bool compact(const QHash<quint64, Entry>& snapshot, qint64 snapshotEnd);
+
+    QString              filePath_;
+    QFile                file_;
+    std::vector<Window>  windows_;
+    qint64               mappedEnd_  = 0;
+    qint64               garbage_    = 0;   // bytes held by dead records
+    bool                 compacting_ = false;
+    QHash<quint64, Entry> index_;           // slot hash → newest record
+    mutable QMutex       mutex_;
+};
+
+#endif // THUMBNAILDISKCACHE_H
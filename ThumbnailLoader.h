@@ -0,0 +1,111 @@
+#ifndef THUMBNAILLOADER_H
+#define THUMBNAILLOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QImage>
+#include <QCache>
+#include <QHash>
+#include <QSet>
+
+#include <atomic>
+#include <memory>
+
+#include "TaskScheduler.h"
+
+class ThumbnailDiskCache;
+
+// Decodes and scales artwork images on the shared scheduler and keeps the
+// resulting thumbnails in a byte-bounded LRU cache.
+//
+// All public methods must be called from the GUI thread; results come
+// back through thumbnailReady()/thumbnailFailed() on the same thread.
+class ThumbnailLoader : public QObject {
+    Q_OBJECT
+
+public:
+    // Interactive requests are what the user is looking at; prefetches
+    // only run when no interactive decode is waiting.
+    enum class Priority { Prefetch = 0, Interactive = 1 };
+
+    // Counters for tuning the caches and the prefetcher.
+    struct Stats {
+        quint64 memoryHits     = 0;   // lookup() served from memory
+        quint64 diskHits       = 0;   // lookup() served from the disk cache
+        quint64 misses         = 0;   // lookup() had to wait for a decode
+        quint64 prefetchIssued = 0;   // prefetch decodes started
+        quint64 prefetchUsed   = 0;   // lookups answered by a prefetched thumbnail
+        quint64 prefetchWasted = 0;   // prefetched thumbnails dropped unused
+    };
+
+    explicit ThumbnailLoader(QObject* parent = nullptr);
+    ~ThumbnailLoader() override;
+
+    // Persistent second-level cache; may be null to disable it.
+    void setDiskCache(std::shared_ptr<ThumbnailDiskCache> disk);
+
+    // Returns true and fills *out if (path, size) is already cached in
+    // memory or on disk.
+    bool lookup(const QString& path, const QSize& size, QImage* out);
+
+    // Queue a decode of 'path' scaled to fit 'size'. A request that is
+    // already in flight for the same key is not duplicated; asking
+    // interactively for a queued prefetch promotes it.
+    void request(const QString& path, const QSize& size,
+                 Priority priority = Priority::Interactive);
+
+    // Replace the prefetch window with 'paths' (most wanted first).
+    // Prefetches outside the new window are cancelled, and no new ones
+    // are started once the window's thumbnails would exceed budgetBytes.
+    void prefetch(const QStringList& paths, const QSize& size, qint64 budgetBytes);
+
+    // Cancel every request of the given priority that has not delivered
+    // its result yet.
+    void cancelPending(Priority priority = Priority::Interactive);
+
+    // Cancel the interactive requests at 'size' whose path is not in
+    // 'paths', e.g. tiles that were scrolled out of view.
+    void retain(const QSet<QString>& paths, const QSize& size);
+
+    // Evict on-disk thumbnails of images no longer referenced by the
+    // catalog. Runs in the background at compaction priority.
+    void pruneDiskCache(const QSet<QString>& livePaths);
+
+    // ── Cache budget ──
+    void setCacheLimit(qint64 bytes);
+    qint64 cacheLimit() const noexcept;
+    qint64 cacheUsage() const noexcept;
+
+    const Stats& stats() const noexcept;
+
+signals:
+    void thumbnailReady(const QString& path, const QSize& size, const QImage& image);
+    void thumbnailFailed(const QString& path, const QSize& size);
+
+private:
+    struct Job {
+        std::atomic_bool cancelled{false};
+        std::atomic_bool started{false};
+        Priority         priority = Priority::Interactive;
+    };
+    using JobPtr = std::shared_ptr<Job>;
+
+    static QString cacheKey(const QString& path, const QSize& size);
+    static QImage decode(const QString& path, const QSize& size);
+
+    void start(const QString& key, const QString& path,
+               const QSize& size, Priority priority);
+    void deliver(const QString& key, const QString& path,
+                 const QSize& size, const JobPtr& job, const QImage& image);
+
+    TaskGroup               tasks_;
+    QCache<QString, QImage> cache_;      // cost = bytes of pixel data
+    QHash<QString, JobPtr>  inFlight_;   // key → pending decode
+    QHash<QString, qint64>  prefetched_; // window keys → estimated bytes, until used
+    std::shared_ptr<ThumbnailDiskCache> disk_;
+    Stats                   stats_;
+};
+
+#endif // THUMBNAILLOADER_H
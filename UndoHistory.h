@@ -0,0 +1,110 @@
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+#include "Command.h"
+
+// Undo/redo stacks with a memory budget.
+//
+// Every command is charged its memoryCost() when it is pushed. Once the
+// total goes over budget the oldest undo steps are dropped first, then
+// the redo steps furthest from the present; the newest undo step always
+// survives. A step over budget on its own is kept alone, at the cost of
+// every other step, and counted in oversizedCount() so the caller can
+// say so (or push smaller steps, as a bulk import does). A command
+// pushed right after another one may be merged into it (see
+// Command::mergeWith), e.g. repeated price tweaks of one record.
+//
+// A listener sees every change to the stacks (UndoJournal persists them);
+// an "older" loader supplies the previous session's steps on demand.
+class UndoHistory {
+public:
+    static constexpr std::size_t kDefaultBudget = 8 * 1024 * 1024;
+
+    class Listener {
+    public:
+        virtual ~Listener() = default;
+        // 'merged' means cmd was folded into the previous top entry
+        virtual void commandPushed(const Command& cmd, bool merged) = 0;
+        virtual void commandUndone() = 0;
+        virtual void commandRedone() = 0;
+        virtual void historyCleared() = 0;
+    };
+
+    // Fills 'undo' and 'redo' (bottom first) with steps that precede
+    // everything in this history, with their executed state already set
+    using OlderLoader = std::function<void(std::vector<CommandPtr>& undo,
+                                           std::vector<CommandPtr>& redo)>;
+
+    explicit UndoHistory(std::size_t budgetBytes = kDefaultBudget) noexcept
+        : budget_(budgetBytes) {}
+
+    UndoHistory(const UndoHistory&) = delete;
+    UndoHistory& operator=(const UndoHistory&) = delete;
+
+    // Record a command that has already been executed. Clears redo.
+    void push(CommandPtr cmd);
+
+    // Return false if there is nothing to undo/redo
+    bool undo();
+    bool redo();
+
+    bool canUndo() const noexcept { return !undo_.empty(); }
+    bool canRedo() const noexcept { return !redo_.empty(); }
+    std::size_t undoCount() const noexcept { return undo_.size(); }
+    std::size_t redoCount() const noexcept { return redo_.size(); }
+
+    // Stop the next push() from merging into the current top entry
+    void seal() noexcept { sealed_ = true; }
+    void clear() noexcept;
+
+    // ── Persistence hooks ──
+    void setListener(Listener* listener) noexcept { listener_ = listener; }
+
+    // Called at most once, the first time undo() runs out of steps (or
+    // redo() does before anything was pushed)
+    void setOlderLoader(OlderLoader loader) { olderLoader_ = std::move(loader); }
+    // Run the loader now, if it is still pending
+    void loadOlder();
+    bool hasPendingOlder() const noexcept { return static_cast<bool>(olderLoader_); }
+
+    // Replace both stacks; the listener is not told
+    void restore(std::vector<CommandPtr> undo, std::vector<CommandPtr> redo);
+
+    // Bottom first
+    std::vector<const Command*> undoCommands() const;
+    std::vector<const Command*> redoCommands() const;
+
+    // ── Budget ──
+    void setMemoryBudget(std::size_t bytes);
+    std::size_t memoryBudget() const noexcept { return budget_; }
+    std::size_t memoryUsage() const noexcept { return usage_; }
+    std::size_t droppedCount() const noexcept { return dropped_; }
+    // Pushes that were over the whole budget by themselves
+    std::size_t oversizedCount() const noexcept { return oversized_; }
+
+private:
+    struct Entry {
+        CommandPtr  cmd;
+        std::size_t cost = 0;
+    };
+
+    void trim();
+
+    std::deque<Entry> undo_;     // back = most recent
+    std::deque<Entry> redo_;     // back = next to redo
+    std::size_t budget_;
+    std::size_t usage_   = 0;
+    std::size_t dropped_ = 0;
+    std::size_t oversized_ = 0;
+    bool        sealed_  = true;
+    bool        pushed_  = false;   // anything pushed since construction
+    Listener*   listener_ = nullptr;
+    OlderLoader olderLoader_;
+};
+
+#endif // UNDOHISTORY_H
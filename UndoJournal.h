@@ -0,0 +1,109 @@
+#ifndef UNDOJOURNAL_H
+#define UNDOJOURNAL_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+
+#include <memory>
+#include <vector>
+
+#include "ArtRepositoryInterface.h"
+#include "TaskScheduler.h"
+#include "Command.h"
+#include "UndoHistory.h"
+
+// Append-only sidecar file (<catalog>.undo) that mirrors an UndoHistory,
+// so the previous session's steps can still be undone after a restart
+// or a crash.
+//
+// Each push/undo/redo becomes one small record. Records are encoded on
+// the GUI thread (commands are not thread-safe) and written in batches
+// in the background, so a command costs the GUI thread only the encode.
+//
+// Saving the catalog appends a checkpoint holding the file's size and
+// mtime. On open:
+//  - the file ends in a checkpoint that matches the catalog: the old
+//    history is only read when the user first undoes past this session;
+//  - records follow the last matching checkpoint (the app died before
+//    saving): they are replayed onto the repository, recovering the
+//    unsaved edits;
+//  - otherwise (first run, catalog changed elsewhere) it starts over.
+//
+// Record layout: u32 length, u8 op, payload (CBOR), u32 length again so
+// the last record can be found from the end. Native byte order: the
+// journal is local to one machine.
+class UndoJournal : public UndoHistory::Listener {
+public:
+    enum class State { Closed, Clean, Recovered, Reset };
+
+    UndoJournal();
+    ~UndoJournal() override;
+
+    UndoJournal(const UndoJournal&) = delete;
+    UndoJournal& operator=(const UndoJournal&) = delete;
+
+    // <catalog path>.undo
+    static QString pathFor(const QString& catalogPath);
+
+    // Attach to 'history' once 'catalogPath' has been loaded into 'repo'.
+    State open(const QString& catalogPath,
+               std::shared_ptr<ArtRepositoryInterface> repo,
+               UndoHistory& history);
+    State state() const noexcept { return state_; }
+
+    // The catalog was just saved. Records a checkpoint (rewriting the
+    // file from 'history' first if it has grown large) and waits until
+    // everything is on disk.
+    void checkpoint(UndoHistory& history);
+
+    // Block until every record handed over so far has been written.
+    void flush();
+
+    // ── UndoHistory::Listener ──
+    void commandPushed(const Command& cmd, bool merged) override;
+    void commandUndone() override;
+    void commandRedone() override;
+    void historyCleared() override;
+
+    // ── Command codec ──
+    static QByteArray encodeCommand(const Command& cmd);
+    static CommandPtr decodeCommand(const QByteArray& data,
+                                    const std::shared_ptr<ArtRepositoryInterface>& repo);
+
+private:
+    enum Op : quint8 { Push = 1, PushMerged, Undo, Redo, Clear, Checkpoint };
+
+    struct Record {
+        Op         op;
+        QByteArray payload;
+    };
+
+    static QByteArray fingerprint(const QString& catalogPath);
+    static QByteArray frame(Op op, const QByteArray& payload);
+
+    void append(Op op, const QByteArray& payload = QByteArray());
+    bool readRecords(qint64 end, std::vector<Record>* out);
+    bool readLastRecord(Record* out);
+    void reset();
+    bool rewrite(const UndoHistory& history);
+    void loadOlder(std::vector<CommandPtr>& undo, std::vector<CommandPtr>& redo);
+    void replay(const std::vector<Record>& records, std::size_t liveFrom,
+                std::vector<CommandPtr>& undo, std::vector<CommandPtr>& redo);
+
+    QString     path_;
+    QString     catalogPath_;
+    std::shared_ptr<ArtRepositoryInterface> repo_;
+    State       state_        = State::Closed;
+    qint64      sessionStart_ = 0;   // older records end here
+
+    // Writer side
+    TaskGroup   writer_{true};       // records must hit the file in order
+    QMutex      mutex_;
+    QByteArray  pending_;            // framed records not yet written
+    bool        writeQueued_  = false;
+    QFile       file_;               // only touched by the writer, or after flush()
+};
+
+#endif // UNDOJOURNAL_H
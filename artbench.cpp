@@ -0,0 +1,447 @@
+// art_bench: cost of the repositories, file formats, undoable commands
+// and list queries at several catalog sizes, written as JSON and checked
+// against a stored baseline.
+//
+//   art_bench [--sizes 1k,10k,100k] [--out results.json]
+//             [--baseline baseline.json] [--tolerance 0.15]
+//             [--min-time ms] [--filter text] [--seed N]
+//
+// Catalogs come from CatalogGenerator, so a seed always gives the same
+// records. Each benchmark repeats until it has run for --min-time and at
+// least three times, and reports the median time per operation: per
+// record for loads, saves and scans, per call otherwise.
+//
+// With --baseline, every benchmark more than --tolerance slower than in
+// the baseline is listed and the exit code is 1. Baselines are results
+// files: keep one per reference machine (--out), since timings from
+// different machines do not compare.
+
+#include "CatalogGenerator.h"
+#include "ArtRepository.h"
+#include "CsvRepository.h"
+#include "JsonRepository.h"
+#include "Command.h"
+#include "NameIndex.h"
+#include "SearchEngine.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock  = std::chrono::steady_clock;
+using ArtPtr = std::shared_ptr<ArtObject>;
+
+// Operations per repetition for the per-call benchmarks
+constexpr std::size_t kWrites  = 1000;
+constexpr std::size_t kReads   = 100000;
+constexpr std::size_t kRemoves = 100;   // from the middle: O(n) each
+
+class Stopwatch {
+public:
+    void start() { begin_ = Clock::now(); }
+    void stop() { total_ += Clock::now() - begin_; }
+    double ns() const { return std::chrono::duration<double, std::nano>(total_).count(); }
+
+private:
+    Clock::time_point begin_;
+    Clock::duration   total_{};
+};
+
+struct Result {
+    std::string   name;
+    std::uint64_t size       = 0;
+    std::string   unit;             // what one operation is: "record" or "call"
+    double        nsPerOp    = 0;   // median over the repetitions
+    double        minNsPerOp = 0;
+    int           reps       = 0;
+};
+
+struct Settings {
+    std::vector<std::uint64_t> sizes{1000, 10000, 100000};
+    double        minTimeMs = 300;
+    int           minReps   = 3;
+    std::string   filter;
+    std::uint64_t seed      = 1;
+    QString       out;
+    QString       baseline;
+    double        tolerance = 0.15;
+};
+
+class Suite {
+public:
+    explicit Suite(const Settings& settings) : settings_(settings) {}
+
+    bool wanted(const std::string& name) const {
+        return settings_.filter.empty() || name.find(settings_.filter) != std::string::npos;
+    }
+
+    // 'rep' times its operations with one stopwatch per name and returns
+    // how many it did
+    void run(std::uint64_t size, const std::vector<std::string>& names, const char* unit,
+             const std::function<std::uint64_t(std::vector<Stopwatch>&)>& rep) {
+        if (std::none_of(names.begin(), names.end(), [&](const std::string& n) { return wanted(n); })) {
+            return;
+        }
+        std::vector<std::vector<double>> samples(names.size());
+        const auto begin = Clock::now();
+        int reps = 0;
+        while (reps < settings_.minReps
+               || std::chrono::duration<double, std::milli>(Clock::now() - begin).count()
+                      < settings_.minTimeMs) {
+            std::vector<Stopwatch> watches(names.size());
+            const double ops = double(std::max<std::uint64_t>(1, rep(watches)));
+            for (std::size_t i = 0; i < names.size(); ++i) samples[i].push_back(watches[i].ns() / ops);
+            ++reps;
+        }
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            if (!wanted(names[i])) continue;
+            std::vector<double>& s = samples[i];
+            std::sort(s.begin(), s.end());
+            Result r;
+            r.name       = names[i];
+            r.size       = size;
+            r.unit       = unit;
+            r.nsPerOp    = s[s.size() / 2];
+            r.minNsPerOp = s.front();
+            r.reps       = reps;
+            std::printf("%-24s %9llu %12.1f ns/%-6s (min %.1f, %d reps)\n", r.name.c_str(),
+                        static_cast<unsigned long long>(size), r.nsPerOp, unit, r.minNsPerOp, reps);
+            std::fflush(stdout);
+            results_.push_back(r);
+        }
+    }
+
+    const std::vector<Result>& results() const noexcept { return results_; }
+
+private:
+    const Settings&     settings_;
+    std::vector<Result> results_;
+};
+
+// ── Benchmarks ──
+void benchFormats(Suite& suite, const std::vector<ArtPtr>& arts, const QString& dir)
+{
+    const std::uint64_t n = arts.size();
+    struct Format {
+        const char*                                              name;
+        std::function<std::unique_ptr<ArtRepositoryInterface>()> make;
+    };
+    const Format formats[] = {
+        {"csv",  []() { return std::make_unique<CsvRepository>(); }},
+        {"json", []() { return std::make_unique<JsonRepository>(); }},
+    };
+    for (const Format& format : formats) {
+        const std::string name = format.name;
+        const QString path = dir + "/catalog." + format.name;
+        auto source = format.make();
+        source->addMany(arts);
+        if (!source->saveToFile(path)) {
+            std::fprintf(stderr, "art_bench: cannot write %s\n", qPrintable(path));
+            continue;
+        }
+
+        suite.run(n, {name + ".save"}, "record", [&](std::vector<Stopwatch>& w) {
+            w[0].start();
+            source->saveToFile(path);
+            w[0].stop();
+            return n;
+        });
+        suite.run(n, {name + ".load"}, "record", [&](std::vector<Stopwatch>& w) {
+            auto repo = format.make();
+            w[0].start();
+            repo->loadFromFile(path);
+            w[0].stop();
+            return std::uint64_t(repo->size());
+        });
+    }
+}
+
+void benchRepository(Suite& suite, const std::vector<ArtPtr>& arts,
+                     const std::vector<ArtPtr>& fresh, std::uint64_t seed)
+{
+    const std::uint64_t n = arts.size();
+    auto repo = std::make_shared<ArtRepository>();
+    repo->addMany(arts);
+    std::mt19937_64 rng(seed);
+    std::vector<std::size_t> positions(kReads);
+    for (auto& p : positions) p = std::size_t(rng() % n);
+
+    suite.run(n, {"repo.add"}, "call", [&](std::vector<Stopwatch>& w) {
+        w[0].start();
+        for (const ArtPtr& art : fresh) repo->add(art);
+        w[0].stop();
+        std::vector<std::size_t> added(fresh.size());
+        for (std::size_t i = 0; i < added.size(); ++i) added[i] = n + i;
+        repo->removeMany(std::move(added));
+        return std::uint64_t(fresh.size());
+    });
+    suite.run(n, {"repo.get"}, "call", [&](std::vector<Stopwatch>& w) {
+        double sink = 0;
+        w[0].start();
+        for (std::size_t p : positions) sink += repo->get(p)->getPrice();
+        w[0].stop();
+        return std::uint64_t(positions.size() + (sink < 0 ? 1 : 0));
+    });
+    suite.run(n, {"repo.update"}, "call", [&](std::vector<Stopwatch>& w) {
+        w[0].start();
+        for (std::size_t i = 0; i < fresh.size(); ++i) repo->update(positions[i], fresh[i]);
+        w[0].stop();
+        for (std::size_t i = fresh.size(); i-- > 0;) repo->update(positions[i], arts[positions[i]]);
+        return std::uint64_t(fresh.size());
+    });
+    // Removed records go back at the end, which keeps the size
+    const std::size_t middle = std::size_t(n / 2);
+    const std::size_t removes = std::min<std::size_t>(kRemoves, n - middle);
+    suite.run(n, {"repo.remove_middle"}, "call", [&](std::vector<Stopwatch>& w) {
+        std::vector<ArtPtr> removed;
+        for (std::size_t i = 0; i < removes; ++i) removed.push_back(repo->get(middle + i));
+        w[0].start();
+        for (std::size_t i = 0; i < removes; ++i) repo->remove(middle);
+        w[0].stop();
+        repo->addMany(removed);
+        return std::uint64_t(removes);
+    });
+    suite.run(n, {"repo.remove_last"}, "call", [&](std::vector<Stopwatch>& w) {
+        std::vector<ArtPtr> removed;
+        for (std::size_t i = 0; i < removes; ++i) removed.push_back(repo->get(n - removes + i));
+        w[0].start();
+        for (std::size_t i = 0; i < removes; ++i) repo->remove(repo->size() - 1);
+        w[0].stop();
+        repo->addMany(removed);
+        return std::uint64_t(removes);
+    });
+
+    // ── Commands: execute all, then undo all in reverse ──
+    suite.run(n, {"command.add.execute", "command.add.undo"}, "call", [&](std::vector<Stopwatch>& w) {
+        std::vector<CommandPtr> commands;
+        for (const ArtPtr& art : fresh) commands.push_back(std::make_unique<AddCommand>(repo, art));
+        w[0].start();
+        for (auto& c : commands) c->execute();
+        w[0].stop();
+        w[1].start();
+        for (auto it = commands.rbegin(); it != commands.rend(); ++it) (*it)->undo();
+        w[1].stop();
+        return std::uint64_t(commands.size());
+    });
+    suite.run(n, {"command.remove.execute", "command.remove.undo"}, "call", [&](std::vector<Stopwatch>& w) {
+        std::vector<CommandPtr> commands;
+        for (std::size_t i = 0; i < removes; ++i) {
+            commands.push_back(std::make_unique<RemoveCommand>(repo, middle));
+        }
+        w[0].start();
+        for (auto& c : commands) c->execute();
+        w[0].stop();
+        w[1].start();
+        for (auto it = commands.rbegin(); it != commands.rend(); ++it) (*it)->undo();
+        w[1].stop();
+        return std::uint64_t(commands.size());
+    });
+    suite.run(n, {"command.edit.execute", "command.edit.undo"}, "call", [&](std::vector<Stopwatch>& w) {
+        std::vector<CommandPtr> commands;
+        for (std::size_t i = 0; i < fresh.size(); ++i) {
+            const std::size_t p = positions[i];
+            commands.push_back(std::make_unique<EditCommand>(repo, p, repo->get(p), fresh[i]));
+        }
+        w[0].start();
+        for (auto& c : commands) c->execute();
+        w[0].stop();
+        w[1].start();
+        for (auto it = commands.rbegin(); it != commands.rend(); ++it) (*it)->undo();
+        w[1].stop();
+        return std::uint64_t(commands.size());
+    });
+
+    // ── Queries: what refreshList() runs ──
+    // Name: exact matches from the index, then the scan for prefixes and
+    // substrings; price: one comparison per record
+    const NameIndex names(repo);
+    const ArtSnapshotPtr snapshot = repo->snapshot();
+    const QString word = QString::fromStdString(arts[positions[0]]->getName()).section(' ', 0, 0);
+    auto scan = [&](const SearchQuery& query, std::vector<Stopwatch>& w) {
+        std::size_t hits = 0;
+        w[0].start();
+        if (query.mode == SearchQuery::Mode::Name) hits += names.find(query.text).size();
+        for (std::size_t i = 0; i < snapshot->size(); ++i) {
+            if (query.rank(*snapshot->at(i)) >= 0) ++hits;
+        }
+        w[0].stop();
+        return std::uint64_t(snapshot->size() + (hits > snapshot->size() ? 1 : 0));
+    };
+    SearchQuery byName;
+    byName.mode      = SearchQuery::Mode::Name;
+    byName.text      = word;
+    byName.skipExact = true;
+    SearchQuery byPrice;
+    byPrice.mode  = SearchQuery::Mode::Price;
+    byPrice.price = 2500.0;
+    suite.run(n, {"query.name"}, "record", [&](std::vector<Stopwatch>& w) { return scan(byName, w); });
+    suite.run(n, {"query.price"}, "record", [&](std::vector<Stopwatch>& w) { return scan(byPrice, w); });
+}
+
+// ── Results and baseline ──
+QString keyOf(const QString& name, std::uint64_t size)
+{
+    return name + "@" + QString::number(size);
+}
+
+QJsonDocument toJson(const Settings& settings, const std::vector<Result>& results)
+{
+    QJsonArray list;
+    for (const Result& r : results) {
+        QJsonObject obj;
+        obj["name"]          = QString::fromStdString(r.name);
+        obj["size"]          = double(r.size);
+        obj["unit"]          = QString::fromStdString(r.unit);
+        obj["ns_per_op"]     = r.nsPerOp;
+        obj["min_ns_per_op"] = r.minNsPerOp;
+        obj["reps"]          = r.reps;
+        list.append(obj);
+    }
+    QJsonObject root;
+    root["version"]   = 1;
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["seed"]      = double(settings.seed);
+    root["qt"]        = qVersion();
+    root["threads"]   = int(std::thread::hardware_concurrency());
+#ifdef NDEBUG
+    root["build"]     = "release";
+#else
+    root["build"]     = "debug";
+#endif
+    root["results"]   = list;
+    return QJsonDocument(root);
+}
+
+// Number of regressions
+int compareWithBaseline(const Settings& settings, const std::vector<Result>& results)
+{
+    QFile file(settings.baseline);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "art_bench: cannot read baseline %s\n", qPrintable(settings.baseline));
+        return -1;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    std::map<QString, double> baseline;
+    for (const QJsonValue& v : root["results"].toArray()) {
+        const QJsonObject obj = v.toObject();
+        baseline[keyOf(obj["name"].toString(), std::uint64_t(obj["size"].toDouble()))] =
+            obj["ns_per_op"].toDouble();
+    }
+
+    std::printf("\nAgainst %s (%s, %s build):\n", qPrintable(settings.baseline),
+                qPrintable(root["timestamp"].toString()), qPrintable(root["build"].toString()));
+    int regressions = 0;
+    for (const Result& r : results) {
+        const auto it = baseline.find(keyOf(QString::fromStdString(r.name), r.size));
+        if (it == baseline.end() || it->second <= 0) {
+            std::printf("  %-24s %9llu  new\n", r.name.c_str(), static_cast<unsigned long long>(r.size));
+            continue;
+        }
+        const double change = r.nsPerOp / it->second - 1.0;
+        const char* verdict = change > settings.tolerance ? "REGRESSION"
+                            : change < -settings.tolerance ? "faster" : "";
+        if (change > settings.tolerance) ++regressions;
+        std::printf("  %-24s %9llu %+7.1f%%  %s\n", r.name.c_str(),
+                    static_cast<unsigned long long>(r.size), change * 100.0, verdict);
+    }
+    std::printf("%d regression(s) beyond %.0f%%\n", regressions, settings.tolerance * 100.0);
+    return regressions;
+}
+
+bool parseSizes(const char* text, std::vector<std::uint64_t>* sizes)
+{
+    sizes->clear();
+    for (const QString& part : QString(text).split(',', Qt::SkipEmptyParts)) {
+        QString digits = part.trimmed().toLower();
+        double scale = 1.0;
+        if (digits.endsWith('k')) scale = 1e3;
+        else if (digits.endsWith('m')) scale = 1e6;
+        if (scale > 1.0) digits.chop(1);
+        bool ok = false;
+        const double value = digits.toDouble(&ok) * scale;
+        if (!ok || value < 1) return false;
+        sizes->push_back(std::uint64_t(value + 0.5));
+    }
+    return !sizes->empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "art_bench: %s needs a value\n", option.c_str());
+            return 2;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (option == "--sizes")          ok = parseSizes(value, &settings.sizes);
+        else if (option == "--out")       settings.out = value;
+        else if (option == "--baseline")  settings.baseline = value;
+        else if (option == "--tolerance") ok = (settings.tolerance = std::atof(value)) > 0;
+        else if (option == "--min-time")  ok = (settings.minTimeMs = std::atof(value)) >= 0;
+        else if (option == "--filter")    settings.filter = value;
+        else if (option == "--seed")      settings.seed = std::strtoull(value, nullptr, 10);
+        else {
+            std::fprintf(stderr, "art_bench: unknown option %s\n", option.c_str());
+            return 2;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "art_bench: bad value '%s' for %s\n", value, option.c_str());
+            return 2;
+        }
+    }
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::fprintf(stderr, "art_bench: no temporary directory\n");
+        return 1;
+    }
+
+    CatalogSpec spec;
+    spec.seed = settings.seed;
+    const CatalogGenerator generator(spec);
+    Suite suite(settings);
+    std::printf("%-24s %9s %15s\n", "benchmark", "records", "median");
+    for (const std::uint64_t n : settings.sizes) {
+        const std::vector<ArtPtr> arts  = generator.arts(0, n);
+        const std::vector<ArtPtr> fresh = generator.arts(n, kWrites);
+        benchFormats(suite, arts, dir.path());
+        benchRepository(suite, arts, fresh, settings.seed);
+    }
+
+    if (!settings.out.isEmpty()) {
+        QFile file(settings.out);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "art_bench: cannot write %s\n", qPrintable(settings.out));
+            return 1;
+        }
+        file.write(toJson(settings, suite.results()).toJson(QJsonDocument::Indented));
+        std::printf("\nResults written to %s\n", qPrintable(settings.out));
+    }
+    if (!settings.baseline.isEmpty()) {
+        const int regressions = compareWithBaseline(settings, suite.results());
+        if (regressions != 0) return 1;   // also when the baseline is unreadable
+    }
+    return 0;
+}
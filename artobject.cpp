@@ -59,3 +59,7 @@ void ArtObject::setImagePath(const QString& imagePath) {
 std::string ArtObject::getType() const noexcept {
     return "ArtObject";
 }
+
+std::shared_ptr<ArtObject> ArtObject::clone() const {
+    return std::make_shared<ArtObject>(*this);
+}
@@ -1,19 +1,26 @@
 #include "ArtRepository.h"
 
+#include <algorithm>
+
 // ── In‐memory CRUD ──
 void ArtRepository::add(const ArtPtr& art) {
     items_.push_back(art);
+    notifyAdded(items_.size() - 1, art);
 }
 
 bool ArtRepository::update(std::size_t index, const ArtPtr& art) noexcept {
     if (index >= items_.size()) return false;
+    ArtPtr old = std::move(items_[index]);
     items_[index] = art;
+    notifyUpdated(index, old, art);
     return true;
 }
 
 bool ArtRepository::remove(std::size_t index) noexcept {
     if (index >= items_.size()) return false;
+    ArtPtr old = std::move(items_[index]);
     items_.erase(items_.begin() + index);
+    notifyRemoved(index, old);
     return true;
 }
 
@@ -28,4 +35,41 @@ std::size_t ArtRepository::size() const noexcept {
 
 void ArtRepository::clear() noexcept {
     items_.clear();
+    notifyReset();
+}
+
+// One compaction pass instead of one erase (and shift) per index
+std::size_t ArtRepository::removeMany(std::vector<std::size_t> indices) noexcept {
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    while (!indices.empty() && indices.back() >= items_.size()) indices.pop_back();
+    if (indices.empty()) return 0;
+
+    std::vector<ArtPtr> removed;
+    removed.reserve(indices.size());
+
+    std::size_t out = indices.front();
+    std::size_t next = 0;
+    for (std::size_t in = indices.front(); in < items_.size(); ++in) {
+        if (next < indices.size() && indices[next] == in) {
+            removed.push_back(std::move(items_[in]));
+            ++next;
+        } else {
+            items_[out++] = std::move(items_[in]);
+        }
+    }
+    items_.resize(out);
+
+    // Highest index first, so each reported index is valid as if the
+    // items had been removed one at a time
+    BatchScope batch(*this);
+    for (std::size_t i = indices.size(); i-- > 0; ) {
+        notifyRemoved(indices[i], removed[i]);
+    }
+    return indices.size();
+}
+
+void ArtRepository::replaceAll(std::vector<ArtPtr> items) noexcept {
+    items_ = std::move(items);
+    notifyReset();
 }
@@ -0,0 +1,436 @@
+#include "BulkImporter.h"
+#include "BoundedQueue.h"
+#include "CsvRepository.h"
+#include "JsonRepository.h"
+#include "DigitalArt.h"
+#include "NameIndex.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QDebug>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <mutex>
+#include <unordered_set>
+
+namespace {
+
+// Rows per chunk between the read and parse stages
+constexpr std::size_t kChunkRows   = 2048;
+// Rows per batch handed to the GUI thread
+constexpr std::size_t kCommitRows  = 16384;
+// Files read at the same time; parsing is what needs the cores
+constexpr std::size_t kReaders     = 2;
+
+// Bulk work: below anything the user is looking at
+constexpr auto kPriority = TaskScheduler::Priority::IndexBuild;
+
+using Batch = BulkImporter::Batch;
+
+struct RawChunk {
+    std::vector<QString>     lines;     // CSV rows
+    std::vector<QJsonObject> objects;   // JSON array elements
+};
+
+struct ParsedChunk {
+    Batch             rows;
+    std::vector<char> maybeExisting;   // per row: name might be in the catalog
+    quint64           invalid = 0;
+};
+
+struct FileReader {
+    QString     path;
+    bool        json   = false;
+    bool        opened = false;
+    QFile       file;
+    std::unique_ptr<QTextStream> in;    // CSV
+    QJsonArray  array;                  // JSON, parsed on the first read
+    qsizetype   next   = 0;
+};
+
+void trimLower(std::string& s)
+{
+    const auto first = s.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) { s.clear(); return; }
+    s = s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+    for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+} // namespace
+
+// ── Pipeline ──
+// Shared by every task of one import; outlives the importer's interest
+// in it (a cancelled import's tasks only wind down).
+struct BulkImporter::Pipeline {
+    Pipeline(BulkImporter* owner, TaskGroup& tasks, std::size_t slots)
+        : owner(owner), tasks(tasks), raw(slots), parsed(slots), slots(slots) {}
+
+    BulkImporter* owner;
+    TaskGroup&    tasks;
+    const TaskScheduler::CancelToken cancelled = std::make_shared<std::atomic_bool>(false);
+    QElapsedTimer clock;
+
+    std::vector<std::unique_ptr<FileReader>> files;
+    BoundedQueue<RawChunk>    raw;      // read → parse
+    BoundedQueue<ParsedChunk> parsed;   // parse → commit
+    const std::size_t         slots;    // chunks allowed in flight
+    std::atomic<std::size_t>  inFlight{0};
+
+    // Reader bookkeeping (rare: once per file or per park)
+    std::mutex               mutex;
+    std::size_t              nextFile = 0;
+    std::vector<FileReader*> parked;
+    std::atomic<std::size_t> filesLeft{0};
+
+    std::shared_ptr<const BloomFilter> existingNames;   // null: check every row
+
+    // Commit stage, only touched by the one commit task running
+    std::atomic_bool                committing{false};
+    ArtSnapshotPtr                  existing;
+    bool                            seeded   = false;   // existing keys are in 'seen'
+
+    bool                            finished = false;
+    std::unordered_set<std::string> seen;
+    Batch                           batch;
+
+    std::atomic<int>     failedFiles{0};
+    std::atomic<quint64> rows{0}, imported{0}, invalid{0}, duplicates{0};
+
+    Report report() const {
+        Report r;
+        r.files       = static_cast<int>(files.size());
+        r.failedFiles = failedFiles.load();
+        r.rows        = rows.load();
+        r.imported    = imported.load();
+        r.invalid     = invalid.load();
+        r.duplicates  = duplicates.load();
+        r.seconds     = clock.elapsed() / 1000.0;
+        return r;
+    }
+
+    void submit(std::function<void()> fn) { tasks.submit(kPriority, std::move(fn)); }
+
+    // ── Read stage ──
+    bool startNextFile(const std::shared_ptr<Pipeline>& self) {
+        FileReader* reader = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (nextFile < files.size()) reader = files[nextFile++].get();
+        }
+        if (!reader) return false;
+        submit([self, reader]() { self->readStep(self, reader); });
+        return true;
+    }
+
+    void readStep(const std::shared_ptr<Pipeline>& self, FileReader* reader) {
+        if (cancelled->load()) {
+            fileDone(self, reader);
+            return;
+        }
+        // Take a slot; without one, wait for the commit stage to free one
+        if (inFlight.fetch_add(1) >= slots) {
+            inFlight.fetch_sub(1);
+            park(self, reader);
+            return;
+        }
+
+        RawChunk chunk;
+        const bool more = readChunk(reader, &chunk);
+        const std::size_t n = chunk.lines.size() + chunk.objects.size();
+        if (n == 0) {
+            inFlight.fetch_sub(1);
+        } else {
+            rows += n;
+            raw.tryPush(std::move(chunk));   // cannot fail: slots <= capacity
+            submit([self]() { self->parseStep(self); });
+        }
+
+        if (more) submit([self, reader]() { self->readStep(self, reader); });
+        else      fileDone(self, reader);
+    }
+
+    // Fills 'out' with up to kChunkRows rows; false once the file is done
+    bool readChunk(FileReader* reader, RawChunk* out) {
+        if (!reader->opened) {
+            reader->opened = true;
+            reader->file.setFileName(reader->path);
+            QIODevice::OpenMode mode = QIODevice::ReadOnly;
+            if (!reader->json) mode |= QIODevice::Text;
+            if (!reader->file.open(mode)) {
+                qWarning() << "[BulkImporter] cannot open" << reader->path;
+                ++failedFiles;
+                return false;
+            }
+            if (reader->json) {
+                // No incremental JSON parser: parse once, then hand out slices
+                QJsonParseError err;
+                const QJsonDocument doc = QJsonDocument::fromJson(reader->file.readAll(), &err);
+                reader->file.close();
+                if (err.error != QJsonParseError::NoError || !doc.isArray()) {
+                    qWarning() << "[BulkImporter] not a JSON array:" << reader->path
+                               << err.errorString();
+                    ++failedFiles;
+                    return false;
+                }
+                reader->array = doc.array();
+            } else {
+                reader->in = std::make_unique<QTextStream>(&reader->file);
+                reader->in->readLine();   // header
+            }
+        }
+
+        if (reader->json) {
+            const qsizetype end = std::min<qsizetype>(reader->array.size(),
+                                                      reader->next + kChunkRows);
+            out->objects.reserve(end - reader->next);
+            for (; reader->next < end; ++reader->next) {
+                out->objects.push_back(reader->array.at(reader->next).toObject());
+            }
+            if (reader->next < reader->array.size()) return true;
+            reader->array = QJsonArray();
+            return false;
+        }
+
+        out->lines.reserve(kChunkRows);
+        while (out->lines.size() < kChunkRows && !reader->in->atEnd()) {
+            QString line = CsvRepository::readCsvRecord(*reader->in).trimmed();
+            if (!line.isEmpty()) out->lines.push_back(std::move(line));
+        }
+        if (!reader->in->atEnd()) return true;
+        reader->in.reset();
+        reader->file.close();
+        return false;
+    }
+
+    void park(const std::shared_ptr<Pipeline>& self, FileReader* reader) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            parked.push_back(reader);
+        }
+        // A slot may have been freed before we were on the list
+        if (inFlight.load() < slots) resumeParked(self);
+    }
+
+    void resumeParked(const std::shared_ptr<Pipeline>& self) {
+        FileReader* reader = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (parked.empty()) return;
+            reader = parked.back();
+            parked.pop_back();
+        }
+        submit([self, reader]() { self->readStep(self, reader); });
+    }
+
+    void fileDone(const std::shared_ptr<Pipeline>& self, FileReader* reader) {
+        reader->in.reset();
+        reader->file.close();
+        reader->array = QJsonArray();
+        filesLeft.fetch_sub(1);
+        startNextFile(self);
+        scheduleCommit(self);   // the last file may complete the import
+    }
+
+    // ── Parse stage ──
+    void parseStep(const std::shared_ptr<Pipeline>& self) {
+        RawChunk chunk;
+        if (!raw.tryPop(chunk)) return;
+
+        ParsedChunk out;
+        if (!cancelled->load()) {
+            out.rows.reserve(chunk.lines.size() + chunk.objects.size());
+            out.maybeExisting.reserve(out.rows.capacity());
+            auto accept = [&](ArtPtr art) {
+                if (!art || !isValid(*art)) {
+                    ++out.invalid;
+                    return;
+                }
+                const bool maybe = !existingNames || existingNames->mightContain(
+                    NameIndex::hashKey(NameIndex::normalize(art->getName())));
+                out.rows.push_back(std::move(art));
+                out.maybeExisting.push_back(maybe);
+            };
+            for (const QString& line : chunk.lines) {
+                accept(CsvRepository::fromCsvFields(CsvRepository::parseCsvLine(line)));
+            }
+            for (const QJsonObject& obj : chunk.objects) {
+                accept(JsonRepository::fromJson(obj));
+            }
+        }
+        parsed.tryPush(std::move(out));   // cannot fail either
+        scheduleCommit(self);
+    }
+
+    // ── Commit stage ──
+    void scheduleCommit(const std::shared_ptr<Pipeline>& self) {
+        if (!committing.exchange(true)) submit([self]() { self->commitStep(self); });
+    }
+
+    bool readingDone() const { return filesLeft.load() == 0 && inFlight.load() == 0; }
+
+    void commitStep(const std::shared_ptr<Pipeline>& self) {
+        for (;;) {
+            ParsedChunk chunk;
+            while (parsed.tryPop(chunk)) {
+                invalid += chunk.invalid;
+                if (!cancelled->load()) {
+                    for (std::size_t i = 0; i < chunk.rows.size(); ++i) {
+                        auto& art = chunk.rows[i];
+                        // Rows accepted so far had names the catalog does
+                        // not have, so seeding late cannot let one through
+                        if (chunk.maybeExisting[i] && !seeded) seedExisting();
+                        if (!seen.insert(dedupKey(*art)).second) {
+                            ++duplicates;
+                            continue;
+                        }
+                        batch.push_back(std::move(art));
+                        if (batch.size() >= kCommitRows) post(self);
+                    }
+                }
+                chunk = ParsedChunk();
+                inFlight.fetch_sub(1);
+                resumeParked(self);
+            }
+
+            if (!finished && readingDone()) {
+                finished = true;
+                post(self);
+                deliverFinished(self);
+            }
+
+            committing.store(false);
+            // Anything pushed (or finished) after our last look gets a
+            // commit task of its own, unless it is us
+            const bool more = !parsed.empty() || (!finished && readingDone());
+            if (!more || committing.exchange(true)) return;
+        }
+    }
+
+    void seedExisting() {
+        seeded = true;
+        if (!existing) return;
+        seen.reserve(seen.size() + existing->size() * 2);
+        for (const auto& art : *existing) if (art) seen.insert(dedupKey(*art));
+        existing.reset();
+    }
+
+    void post(const std::shared_ptr<Pipeline>& self) {
+        if (batch.empty() || cancelled->load()) return;
+        imported += batch.size();
+        auto shared = std::make_shared<Batch>(std::move(batch));
+        batch = Batch();
+        batch.reserve(kCommitRows);
+        const Report r = report();
+        BulkImporter* importer = owner;
+        QMetaObject::invokeMethod(importer, [importer, self, shared, r]() {
+            if (self->cancelled->load()) return;
+            emit importer->batchReady(*shared);
+            emit importer->progress(r);
+        }, Qt::QueuedConnection);
+    }
+
+    void deliverFinished(const std::shared_ptr<Pipeline>& self) {
+        const Report r = report();
+        BulkImporter* importer = owner;
+        QMetaObject::invokeMethod(importer, [importer, self, r]() {
+            if (self->cancelled->load()) return;
+            importer->running_ = false;
+            emit importer->finished(r);
+        }, Qt::QueuedConnection);
+    }
+};
+
+// ── BulkImporter ──
+BulkImporter::BulkImporter(QObject* parent)
+    : QObject(parent)
+{
+}
+
+BulkImporter::~BulkImporter()
+{
+    cancel();
+    tasks_.wait();
+}
+
+void BulkImporter::start(const QString& directory, ArtSnapshotPtr existing,
+                         std::shared_ptr<const BloomFilter> existingNames)
+{
+    cancel();
+
+    QDir dir(directory);
+    const QStringList names = dir.entryList({"*.csv", "*.json"},
+                                            QDir::Files | QDir::Readable, QDir::Name);
+
+    // Enough chunks in flight to keep every worker parsing
+    const std::size_t slots = 4 * std::size_t(TaskScheduler::instance().threadCount());
+    auto pipeline = std::make_shared<Pipeline>(this, tasks_, slots);
+    pipeline->existing = std::move(existing);
+    pipeline->existingNames = std::move(existingNames);
+    for (const QString& name : names) {
+        auto reader = std::make_unique<FileReader>();
+        reader->path = dir.filePath(name);
+        reader->json = name.endsWith(".json", Qt::CaseInsensitive);
+        pipeline->files.push_back(std::move(reader));
+    }
+    pipeline->filesLeft = pipeline->files.size();
+    pipeline->clock.start();
+
+    pipeline_ = pipeline;
+    running_  = true;
+
+    if (names.isEmpty()) {
+        pipeline->scheduleCommit(pipeline);   // reports an empty import
+        return;
+    }
+    for (std::size_t i = 0; i < kReaders; ++i) {
+        if (!pipeline->startNextFile(pipeline)) break;
+    }
+}
+
+void BulkImporter::cancel()
+{
+    if (pipeline_) pipeline_->cancelled->store(true);
+    pipeline_.reset();
+    tasks_.cancel();
+    running_ = false;
+}
+
+bool BulkImporter::isRunning() const noexcept
+{
+    return running_;
+}
+
+std::string BulkImporter::dedupKey(const ArtObject& art)
+{
+    std::string name = art.getName();
+    std::string location = art.getLocation();
+    trimLower(name);
+    trimLower(location);
+    std::string key = art.getType();
+    key.reserve(key.size() + name.size() + location.size() + 2);
+    key += '\x1f';
+    key += name;
+    key += '\x1f';
+    key += location;
+    return key;
+}
+
+bool BulkImporter::isValid(const ArtObject& art)
+{
+    if (art.getName().find_first_not_of(" \t\r\n") == std::string::npos) return false;
+    const double price = art.getPrice();
+    if (!std::isfinite(price) || price < 0) return false;
+    if (auto digital = dynamic_cast<const DigitalArt*>(&art)) {
+        if (digital->getResolutionX() <= 0 || digital->getResolutionY() <= 0) return false;
+    }
+    return true;
+}
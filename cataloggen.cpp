@@ -0,0 +1,164 @@
+// catalog_gen: writes a synthetic catalog for load and scale testing.
+//
+//   catalog_gen <records> <output.csv|output.json|-> [options]
+//
+// Records may carry a k or m suffix (10k, 1m, 10m). The format follows
+// the output's extension; with "-" (stdout) give --format. Options:
+//
+//   --format csv|json          --seed N
+//   --mix P,S,D                type weights (paintings, sculptures, digital)
+//   --median-price X           --price-spread SIGMA
+//   --name-words MIN-MAX       --description MIN-MAX (characters)
+//   --locations N              --location-skew S (0 = uniform)
+//   --unicode RATE             --quotes RATE        --newlines RATE
+//   --images RATE              --first INDEX (start of a shard)
+//
+// The same seed and options always give the same file; see
+// CatalogGenerator for what each option controls.
+
+#include "CatalogGenerator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: catalog_gen <records> <output.csv|output.json|-> [--format csv|json]\n"
+                 "         [--seed N] [--mix P,S,D] [--median-price X] [--price-spread S]\n"
+                 "         [--name-words MIN-MAX] [--description MIN-MAX] [--locations N]\n"
+                 "         [--location-skew S] [--unicode R] [--quotes R] [--newlines R]\n"
+                 "         [--images R] [--first INDEX]\n");
+}
+
+bool parseCount(const char* text, std::uint64_t* count)
+{
+    char* end = nullptr;
+    const double value = std::strtod(text, &end);
+    if (end == text || value < 0) return false;
+    double scale = 1.0;
+    if (*end == 'k' || *end == 'K') scale = 1e3;
+    else if (*end == 'm' || *end == 'M') scale = 1e6;
+    if (scale > 1.0) ++end;
+    if (*end != '\0') return false;
+    *count = std::uint64_t(value * scale + 0.5);
+    return true;
+}
+
+bool parseRange(const char* text, int* lo, int* hi)
+{
+    return std::sscanf(text, "%d-%d", lo, hi) == 2 && *lo >= 0 && *lo <= *hi;
+}
+
+bool parseRate(const char* text, double* rate)
+{
+    char* end = nullptr;
+    *rate = std::strtod(text, &end);
+    return end != text && *end == '\0' && *rate >= 0.0 && *rate <= 1.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+    std::uint64_t count = 0;
+    if (!parseCount(argv[1], &count)) {
+        std::fprintf(stderr, "catalog_gen: bad record count '%s'\n", argv[1]);
+        return 2;
+    }
+    const std::string output = argv[2];
+
+    CatalogSpec spec;
+    CatalogGenerator::Format format = CatalogGenerator::Format::Csv;
+    bool haveFormat = CatalogGenerator::formatFromName(output, &format);
+    std::uint64_t first = 0;
+
+    for (int i = 3; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "catalog_gen: %s needs a value\n", option.c_str());
+            return 2;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (option == "--format") {
+            ok = haveFormat = CatalogGenerator::formatFromName(value, &format);
+        } else if (option == "--seed") {
+            spec.seed = std::strtoull(value, nullptr, 10);
+        } else if (option == "--mix") {
+            ok = std::sscanf(value, "%lf,%lf,%lf", &spec.paintings, &spec.sculptures, &spec.digital) == 3;
+        } else if (option == "--median-price") {
+            spec.medianPrice = std::atof(value);
+            ok = spec.medianPrice > 0;
+        } else if (option == "--price-spread") {
+            spec.priceSpread = std::atof(value);
+        } else if (option == "--name-words") {
+            ok = parseRange(value, &spec.nameWordsMin, &spec.nameWordsMax);
+        } else if (option == "--description") {
+            ok = parseRange(value, &spec.descriptionMin, &spec.descriptionMax);
+        } else if (option == "--locations") {
+            ok = parseCount(value, &spec.locations) && spec.locations > 0;
+        } else if (option == "--location-skew") {
+            spec.locationSkew = std::atof(value);
+        } else if (option == "--unicode") {
+            ok = parseRate(value, &spec.unicodeRate);
+        } else if (option == "--quotes") {
+            ok = parseRate(value, &spec.quoteRate);
+        } else if (option == "--newlines") {
+            ok = parseRate(value, &spec.newlineRate);
+        } else if (option == "--images") {
+            ok = parseRate(value, &spec.imageRate);
+        } else if (option == "--first") {
+            ok = parseCount(value, &first);
+        } else {
+            std::fprintf(stderr, "catalog_gen: unknown option %s\n", option.c_str());
+            usage();
+            return 2;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "catalog_gen: bad value '%s' for %s\n", value, option.c_str());
+            return 2;
+        }
+    }
+    if (!haveFormat) {
+        std::fprintf(stderr, "catalog_gen: cannot tell the format of '%s'; use --format\n",
+                     output.c_str());
+        return 2;
+    }
+
+    const CatalogGenerator generator(spec);
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t bytes = 0;
+    if (output == "-") {
+        bytes = generator.write(std::cout, format, count, first);
+        std::cout.flush();
+    } else {
+        std::ofstream file(output, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::fprintf(stderr, "catalog_gen: cannot write %s\n", output.c_str());
+            return 1;
+        }
+        bytes = generator.write(file, format, count, first);
+        file.close();
+        if (!file) {
+            std::fprintf(stderr, "catalog_gen: writing %s failed\n", output.c_str());
+            return 1;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "%llu records, %.1f MB of %s in %.2f s (seed %llu)\n",
+                 static_cast<unsigned long long>(count), bytes / 1e6,
+                 CatalogGenerator::formatName(format), seconds,
+                 static_cast<unsigned long long>(spec.seed));
+    return 0;
+}
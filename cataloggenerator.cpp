@@ -0,0 +1,421 @@
+#include "CatalogGenerator.h"
+
+#include "Painting.h"
+#include "Sculpture.h"
+#include "DigitalArt.h"
+#include "Mix64.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// ── Vocabulary ──
+constexpr std::array<const char*, 40> kAdjectives = {
+    "Quiet", "Blue", "Golden", "Silent", "Red", "Northern", "Broken", "Distant",
+    "Bright", "Hidden", "Winter", "Summer", "Pale", "Dark", "Lost", "Early",
+    "Last", "Green", "Wild", "Gentle", "Burning", "Frozen", "Hollow", "Endless",
+    "Still", "Restless", "White", "Crimson", "Faded", "Sacred", "Lonely", "Electric",
+    "Velvet", "Amber", "Scarlet", "Iron", "Silver", "Evening", "Morning", "Open"};
+constexpr std::array<const char*, 48> kNouns = {
+    "Harbour", "Garden", "River", "Portrait", "Mountain", "Window", "Forest", "Horizon",
+    "Figure", "Landscape", "Study", "Bridge", "Field", "Sea", "City", "Storm",
+    "Light", "Shadow", "Dancer", "Tower", "Valley", "Orchard", "Village", "Lake",
+    "Cathedral", "Market", "Still Life", "Mother", "Child", "Horse", "Bird", "Rose",
+    "Moon", "Sun", "Road", "Wall", "Door", "Table", "Boat", "Island",
+    "Cloud", "Stone", "Fire", "Snow", "Rain", "Dawn", "Dusk", "Memory"};
+constexpr std::array<const char*, 6> kConnectors = {"of", "at", "in", "with", "and", "under"};
+constexpr std::array<const char*, 32> kFiller = {
+    "the", "a", "with", "in", "of", "and", "over", "through", "soft", "heavy",
+    "light", "colour", "texture", "brushwork", "surface", "form", "line", "tone",
+    "layered", "muted", "vivid", "study", "composition", "contrast", "depth", "edge",
+    "early", "late", "period", "artist", "collection", "series"};
+// Non-ASCII words from several scripts, UTF-8
+constexpr std::array<const char*, 16> kUnicode = {
+    "Café", "Überfahrt", "Łódź", "Ñandú", "Ἀθῆναι", "Мост", "Зима", "夜の港",
+    "山水", "바다", "ภูเขา", "שקיעה", "غروب", "Crème brûlée", "Smörgåsbord", "🌊"};
+
+constexpr std::array<const char*, 6> kCanvas = {
+    "Canvas", "Linen", "Wood panel", "Paper", "Copper", "Cardboard"};
+constexpr std::array<const char*, 8> kMaterials = {
+    "Bronze", "Marble", "Wood", "Clay", "Steel", "Glass", "Granite", "Plaster"};
+constexpr std::array<const char*, 7> kSoftware = {
+    "Photoshop", "Blender", "Procreate", "Krita", "Illustrator", "Houdini", "TouchDesigner"};
+constexpr std::array<std::array<int, 2>, 6> kResolutions = {{
+    {1920, 1080}, {2560, 1440}, {3840, 2160}, {4096, 4096}, {1080, 1350}, {7680, 4320}}};
+
+constexpr std::array<const char*, 12> kVenues = {
+    "National Gallery", "Museum of Art", "Kunsthalle", "Modern", "Storage",
+    "Private Collection", "Contemporary Art Centre", "Sculpture Park", "Fine Arts Museum",
+    "Photography Museum", "Design Museum", "Academy"};
+constexpr std::array<const char*, 40> kCities = {
+    "London", "Paris", "Vienna", "Berlin", "Madrid", "Rome", "Amsterdam", "Oslo",
+    "Stockholm", "Copenhagen", "Prague", "Budapest", "Warsaw", "Kraków", "Lisbon", "Dublin",
+    "Edinburgh", "Zürich", "Brussels", "Athens", "Istanbul", "New York", "Chicago", "Boston",
+    "Toronto", "Montréal", "Mexico City", "São Paulo", "Buenos Aires", "Tokyo", "Kyoto", "Seoul",
+    "Beijing", "Shanghai", "Singapore", "Mumbai", "Sydney", "Melbourne", "Cape Town", "Cairo"};
+
+// ── Randomness ──
+// SplitMix64, with ranges mapped by hand so every standard library
+// produces the same catalog
+class Rng {
+public:
+    explicit Rng(std::uint64_t seed) : state_(seed) {}
+
+    std::uint64_t next() {
+        state_ += 0x9E3779B97F4A7C15ull;
+        return mix64(state_);
+    }
+    double unit() { return double(next() >> 11) * 0x1.0p-53; }   // [0, 1)
+    bool chance(double p) { return unit() < p; }
+    int between(int lo, int hi) {   // inclusive
+        return hi <= lo ? lo : lo + int(next() % std::uint64_t(hi - lo + 1));
+    }
+    template <typename Array>
+    const char* pick(const Array& words) { return words[next() % words.size()]; }
+    double normal() {
+        const double u1 = 1.0 - unit();   // (0, 1]
+        const double u2 = unit();
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+std::string makeName(Rng& rng, const CatalogSpec& spec)
+{
+    int left = rng.between(std::max(1, spec.nameWordsMin), std::max(1, spec.nameWordsMax));
+    std::string name;
+    while (left > 0) {
+        if (!name.empty()) name += ' ';
+        if (left >= 2 && rng.chance(0.6)) {
+            name += rng.pick(kAdjectives);
+            name += ' ';
+            --left;
+        }
+        name += rng.pick(kNouns);
+        --left;
+        if (left >= 2) {
+            name += ' ';
+            name += rng.pick(kConnectors);
+            --left;
+        }
+    }
+    if (rng.chance(0.3)) name += " " + std::to_string(rng.between(2, 99));
+    return name;
+}
+
+std::string makeDescription(Rng& rng, const CatalogSpec& spec)
+{
+    const std::size_t target = std::size_t(rng.between(std::max(0, spec.descriptionMin),
+                                                       std::max(0, spec.descriptionMax)));
+    std::string text;
+    while (text.size() < target) {
+        if (!text.empty()) text += ' ';
+        std::string sentence = rng.chance(0.5) ? rng.pick(kAdjectives) : rng.pick(kNouns);
+        const int words = rng.between(5, 13);
+        for (int w = 0; w < words; ++w) {
+            sentence += ' ';
+            std::string word = rng.chance(0.3) ? rng.pick(kNouns) : rng.pick(kFiller);
+            std::transform(word.begin(), word.end(), word.begin(),
+                           [](unsigned char c) { return char(std::tolower(c)); });
+            sentence += word;
+        }
+        text += sentence + '.';
+    }
+    return text;
+}
+
+// A comma and a quoted phrase somewhere inside, after a word
+void addQuotes(Rng& rng, std::string& text)
+{
+    std::size_t space = text.find(' ', text.size() / 2);
+    while (space != std::string::npos
+           && (space == 0 || !std::isalpha(static_cast<unsigned char>(text[space - 1])))) {
+        space = text.find(' ', space + 1);
+    }
+    if (space == std::string::npos) {
+        text += ", \"" + std::string(rng.pick(kNouns)) + "\"";
+        return;
+    }
+    text.insert(space, ", \"" + std::string(rng.pick(kAdjectives)) + "\",");
+}
+
+void appendCsvField(std::string& out, const std::string& field)
+{
+    if (field.find_first_of(",\"\n") == std::string::npos) {
+        out += field;
+        return;
+    }
+    out += '"';
+    for (char c : field) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+void appendJsonString(std::string& out, const std::string& text)
+{
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escape[8];
+                std::snprintf(escape, sizeof escape, "\\u%04x", unsigned(c));
+                out += escape;
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+std::string priceText(double price)
+{
+    char text[32];
+    std::snprintf(text, sizeof text, "%.2f", price);
+    return text;
+}
+
+} // namespace
+
+CatalogGenerator::CatalogGenerator(CatalogSpec spec)
+    : spec_(spec)
+{
+    spec_.locations = std::max<std::uint64_t>(1, spec_.locations);
+    typeTotal_ = std::max(0.0, spec_.paintings) + std::max(0.0, spec_.sculptures)
+               + std::max(0.0, spec_.digital);
+    if (typeTotal_ <= 0.0) {
+        spec_.paintings = 1.0;
+        typeTotal_ = 1.0;
+    }
+    if (spec_.locationSkew > 0.0) {
+        locationCdf_.reserve(spec_.locations);
+        double total = 0.0;
+        for (std::uint64_t rank = 0; rank < spec_.locations; ++rank) {
+            total += 1.0 / std::pow(double(rank + 1), spec_.locationSkew);
+            locationCdf_.push_back(total);
+        }
+    }
+}
+
+// ── Records ──
+std::uint64_t CatalogGenerator::pickLocation(double unit) const
+{
+    if (locationCdf_.empty()) return std::uint64_t(unit * double(spec_.locations));
+    const auto it = std::upper_bound(locationCdf_.begin(), locationCdf_.end(),
+                                     unit * locationCdf_.back());
+    return std::min<std::uint64_t>(std::uint64_t(it - locationCdf_.begin()), spec_.locations - 1);
+}
+
+std::string CatalogGenerator::locationName(std::uint64_t rank) const
+{
+    // Every venue/city pair once before the annexes, the venues interleaved
+    // so the most frequent locations are not all the same kind
+    const std::uint64_t pairs = kVenues.size() * kCities.size();
+    const std::uint64_t venue = (rank / kCities.size() + rank) % kVenues.size();
+    std::string name = std::string(kVenues[venue]) + ' ' + kCities[rank % kCities.size()];
+    if (rank >= pairs) name += " Annex " + std::to_string(rank / pairs + 1);
+    return name;
+}
+
+CatalogGenerator::Record CatalogGenerator::record(std::uint64_t index) const
+{
+    Rng rng(mix64(spec_.seed) ^ mix64(index));
+    Record r;
+
+    const double type = rng.unit() * typeTotal_;
+    if (type < std::max(0.0, spec_.paintings)) {
+        r.type  = "Painting";
+        r.extra = rng.pick(kCanvas);
+    } else if (type < std::max(0.0, spec_.paintings) + std::max(0.0, spec_.sculptures)) {
+        r.type  = "Sculpture";
+        r.extra = rng.pick(kMaterials);
+    } else {
+        r.type  = "DigitalArt";
+        r.extra = rng.pick(kSoftware);
+        const auto& resolution = kResolutions[rng.next() % kResolutions.size()];
+        r.resolutionX = resolution[0];
+        r.resolutionY = resolution[1];
+    }
+
+    r.name        = makeName(rng, spec_);
+    r.description = makeDescription(rng, spec_);
+    const double price = spec_.medianPrice * std::exp(spec_.priceSpread * rng.normal());
+    r.price    = std::round(std::clamp(price, spec_.minPrice, spec_.maxPrice) * 100.0) / 100.0;
+    r.location = locationName(pickLocation(rng.unit()));
+
+    if (rng.chance(spec_.unicodeRate)) {
+        const std::string word = rng.pick(kUnicode);
+        if (rng.chance(0.5)) r.name = word + ' ' + r.name;
+        else r.description += ' ' + word + '.';
+    }
+    if (rng.chance(spec_.quoteRate)) {
+        addQuotes(rng, r.name);
+        addQuotes(rng, r.description);
+    }
+    if (rng.chance(spec_.newlineRate)) {
+        const std::size_t stop = r.description.find(". ");
+        if (stop != std::string::npos) r.description[stop + 1] = '\n';
+        else r.description += "\nUntitled.";
+    }
+    if (rng.chance(spec_.imageRate)) {
+        std::string kind = r.type;
+        std::transform(kind.begin(), kind.end(), kind.begin(),
+                       [](unsigned char c) { return char(std::tolower(c)); });
+        r.imagePath = "images/" + kind + "/" + std::to_string(index) + ".jpg";
+    }
+    return r;
+}
+
+std::shared_ptr<ArtObject> CatalogGenerator::art(std::uint64_t index) const
+{
+    const Record r = record(index);
+    const QString image = QString::fromStdString(r.imagePath);
+    if (r.type == "Painting") {
+        return std::make_shared<Painting>(r.name, r.description, r.price, r.location, r.extra, image);
+    }
+    if (r.type == "Sculpture") {
+        return std::make_shared<Sculpture>(r.name, r.description, r.price, r.location, r.extra, image);
+    }
+    return std::make_shared<DigitalArt>(r.name, r.description, r.price, r.location, r.extra,
+                                        r.resolutionX, r.resolutionY, image);
+}
+
+std::vector<std::shared_ptr<ArtObject>> CatalogGenerator::arts(std::uint64_t first,
+                                                               std::uint64_t count) const
+{
+    std::vector<std::shared_ptr<ArtObject>> items;
+    items.reserve(count);
+    for (std::uint64_t i = first; i < first + count; ++i) items.push_back(art(i));
+    return items;
+}
+
+// ── Formats ──
+std::string CatalogGenerator::csvRow(const Record& r)
+{
+    std::string row;
+    row.reserve(r.name.size() + r.description.size() + r.location.size() + 96);
+    appendCsvField(row, r.type);
+    row += ',';
+    appendCsvField(row, r.name);
+    row += ',';
+    appendCsvField(row, r.description);
+    row += ',';
+    row += priceText(r.price);
+    row += ',';
+    appendCsvField(row, r.location);
+    row += ',';
+    appendCsvField(row, r.extra);
+    row += ',';
+    if (r.type == "DigitalArt") {
+        row += std::to_string(r.resolutionX) + 'x' + std::to_string(r.resolutionY);
+    }
+    row += ',';
+    appendCsvField(row, r.imagePath);
+    row += '\n';
+    return row;
+}
+
+// The keys JsonRepository::toJson() writes
+std::string CatalogGenerator::jsonObject(const Record& r)
+{
+    std::string obj;
+    obj.reserve(r.name.size() + r.description.size() + r.location.size() + 192);
+    obj += "{\"type\":";
+    appendJsonString(obj, r.type);
+    obj += ",\"name\":";
+    appendJsonString(obj, r.name);
+    obj += ",\"description\":";
+    appendJsonString(obj, r.description);
+    obj += ",\"price\":" + priceText(r.price);
+    obj += ",\"location\":";
+    appendJsonString(obj, r.location);
+    obj += ",\"imagePath\":";
+    appendJsonString(obj, r.imagePath);
+    if (r.type == "Painting") {
+        obj += ",\"canvasType\":";
+        appendJsonString(obj, r.extra);
+    } else if (r.type == "Sculpture") {
+        obj += ",\"material\":";
+        appendJsonString(obj, r.extra);
+    } else {
+        obj += ",\"software\":";
+        appendJsonString(obj, r.extra);
+        obj += ",\"resolutionX\":" + std::to_string(r.resolutionX);
+        obj += ",\"resolutionY\":" + std::to_string(r.resolutionY);
+    }
+    obj += '}';
+    return obj;
+}
+
+std::uint64_t CatalogGenerator::write(std::ostream& out, Format format, std::uint64_t count,
+                                      std::uint64_t first) const
+{
+    constexpr std::size_t kFlushBytes = 1 << 20;
+    std::uint64_t written = 0;
+    std::string buffer;
+    buffer.reserve(kFlushBytes + 4096);
+    auto flush = [&]() {
+        out.write(buffer.data(), std::streamsize(buffer.size()));
+        written += buffer.size();
+        buffer.clear();
+    };
+
+    if (format == Format::Csv) {
+        buffer += "type,name,description,price,location,extra1,extra2,imagePath\n";
+    } else {
+        buffer += "[\n";
+    }
+    for (std::uint64_t i = first; i < first + count; ++i) {
+        const Record r = record(i);
+        if (format == Format::Csv) {
+            buffer += csvRow(r);
+        } else {
+            buffer += "  ";
+            buffer += jsonObject(r);
+            buffer += i + 1 < first + count ? ",\n" : "\n";
+        }
+        if (buffer.size() >= kFlushBytes) flush();
+    }
+    if (format == Format::Json) buffer += "]\n";
+    flush();
+    return written;
+}
+
+bool CatalogGenerator::formatFromName(const std::string& name, Format* format)
+{
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return char(std::tolower(c)); });
+    auto endsWith = [&](const std::string& suffix) {
+        return lower.size() >= suffix.size()
+            && lower.compare(lower.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (lower == "csv" || endsWith(".csv")) {
+        *format = Format::Csv;
+        return true;
+    }
+    if (lower == "json" || endsWith(".json")) {
+        *format = Format::Json;
+        return true;
+    }
+    return false;
+}
+
+const char* CatalogGenerator::formatName(Format format) noexcept
+{
+    return format == Format::Csv ? "csv" : "json";
+}
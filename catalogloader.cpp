@@ -0,0 +1,181 @@
+#include "CatalogLoader.h"
+#include "CsvRepository.h"
+#include "JsonRepository.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QDebug>
+
+#include <algorithm>
+
+namespace {
+
+// The first batch is small so the first rows show up immediately; later
+// ones grow to keep the per-batch overhead on the GUI thread low.
+constexpr std::size_t kFirstBatch = 256;
+constexpr std::size_t kMaxBatch   = 8192;
+// Never sit on parsed records for longer than this.
+constexpr qint64      kFlushMs    = 50;
+
+using Batch = CatalogLoader::Batch;
+using Sink  = std::function<void(Batch&&, int)>;
+
+class BatchBuilder {
+public:
+    explicit BatchBuilder(const Sink& sink) : sink_(sink) {
+        batch_.reserve(target_);
+        clock_.start();
+    }
+
+    void add(CatalogLoader::ArtPtr art, int percent) {
+        batch_.push_back(std::move(art));
+        if (batch_.size() >= target_ || clock_.elapsed() >= kFlushMs) flush(percent);
+    }
+
+    void flush(int percent) {
+        sink_(std::move(batch_), percent);
+        target_ = std::min(target_ * 2, kMaxBatch);
+        batch_ = Batch();
+        batch_.reserve(target_);
+        clock_.restart();
+    }
+
+private:
+    const Sink&   sink_;
+    Batch         batch_;
+    std::size_t   target_ = kFirstBatch;
+    QElapsedTimer clock_;
+};
+
+int percentOf(qint64 done, qint64 total) {
+    if (total <= 0) return 100;
+    return static_cast<int>(std::min<qint64>(100, done * 100 / total));
+}
+
+} // namespace
+
+CatalogLoader::CatalogLoader(QObject* parent)
+    : QObject(parent)
+{
+}
+
+CatalogLoader::~CatalogLoader()
+{
+    cancel();
+    tasks_.wait();
+}
+
+void CatalogLoader::start(const QString& filePath)
+{
+    cancel();
+
+    auto cancelled = std::make_shared<std::atomic_bool>(false);
+    cancelled_ = cancelled;
+    running_   = true;
+
+    const bool json = filePath.endsWith(".json", Qt::CaseInsensitive);
+    tasks_.submit(TaskScheduler::Priority::Interactive, [this, filePath, cancelled, json]() {
+        // Hand each batch to the GUI thread; stale loads deliver nothing
+        Sink sink = [this, cancelled](Batch&& batch, int percent) {
+            auto shared = std::make_shared<Batch>(std::move(batch));
+            QMetaObject::invokeMethod(this, [this, cancelled, shared, percent]() {
+                if (cancelled->load()) return;
+                if (!shared->empty()) emit batchLoaded(*shared);
+                emit progress(percent);
+            }, Qt::QueuedConnection);
+        };
+
+        const bool ok = json ? readJson(filePath, sink, *cancelled)
+                             : readCsv(filePath, sink, *cancelled);
+
+        QMetaObject::invokeMethod(this, [this, cancelled, ok]() {
+            if (cancelled->load()) return;
+            running_ = false;
+            emit finished(ok);
+        }, Qt::QueuedConnection);
+    }, cancelled);
+}
+
+void CatalogLoader::cancel()
+{
+    if (cancelled_) cancelled_->store(true);
+    cancelled_.reset();
+    running_ = false;
+}
+
+bool CatalogLoader::isRunning() const noexcept
+{
+    return running_;
+}
+
+// ── Worker side ──
+bool CatalogLoader::readCsv(const QString& filePath, const Sink& sink,
+                            const std::atomic_bool& cancelled)
+{
+    QFile file(filePath);
+    if (!file.exists()) return false;
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Cannot open CSV file for reading:" << filePath;
+        return false;
+    }
+    const qint64 total = file.size();
+    QTextStream in(&file);
+
+    // Skip header
+    in.readLine();
+
+    BatchBuilder batch(sink);
+    while (!in.atEnd()) {
+        if (cancelled.load()) return false;
+        QString line = CsvRepository::readCsvRecord(in).trimmed();
+        if (line.isEmpty()) continue;
+
+        if (auto art = CsvRepository::fromCsvFields(CsvRepository::parseCsvLine(line))) {
+            batch.add(art, percentOf(file.pos(), total));
+        }
+    }
+    batch.flush(100);
+    return true;
+}
+
+bool CatalogLoader::readJson(const QString& filePath, const Sink& sink,
+                             const std::atomic_bool& cancelled)
+{
+    QFile file(filePath);
+    if (!file.exists()) return false;
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open JSON file for reading:" << filePath;
+        return false;
+    }
+
+    // QJsonDocument has no incremental parser: the document is parsed in
+    // one go, and records are streamed out while converting the array.
+    sink(Batch(), -1);
+    QByteArray raw = file.readAll();
+    file.close();
+
+    QJsonParseError err;
+    QJsonDocument doc = QJsonDocument::fromJson(raw, &err);
+    raw.clear();
+    if (err.error != QJsonParseError::NoError) {
+        qWarning() << "JSON parse error:" << err.errorString();
+        return false;
+    }
+    if (!doc.isArray()) return false;
+
+    const QJsonArray array = doc.array();
+    const qsizetype total = array.size();
+    BatchBuilder batch(sink);
+    for (qsizetype i = 0; i < total; ++i) {
+        if (cancelled.load()) return false;
+        if (auto art = JsonRepository::fromJson(array.at(i).toObject())) {
+            batch.add(art, percentOf(i + 1, total));
+        }
+    }
+    batch.flush(100);
+    return true;
+}
@@ -0,0 +1,175 @@
+#include "CatalogRetriever.h"
+#include "ArtObject.h"
+#include "Painting.h"
+#include "Sculpture.h"
+#include "DigitalArt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// Lowercased words, keeping the characters prices are written with
+std::vector<std::string> questionWords(const std::string& question)
+{
+    std::vector<std::string> words;
+    std::string word;
+    auto flush = [&]() {
+        while (!word.empty() && (word.back() == '.' || word.back() == ',' || word.back() == '?'
+                                 || word.back() == '!')) {
+            word.pop_back();
+        }
+        if (!word.empty()) words.push_back(word);
+        word.clear();
+    };
+    for (char ch : question) {
+        const auto c = static_cast<unsigned char>(ch);
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') flush();
+        else if (c == '<' || c == '>') { flush(); words.emplace_back(1, ch); }
+        else word += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : ch;
+    }
+    flush();
+    return words;
+}
+
+bool oneOf(const std::string& word, std::initializer_list<const char*> options)
+{
+    for (const char* option : options) if (word == option) return true;
+    return false;
+}
+
+std::string clip(const std::string& text, std::size_t chars)
+{
+    if (text.size() <= chars) return text;
+    std::size_t cut = chars;
+    while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) --cut;   // UTF-8
+    return text.substr(0, cut) + "...";
+}
+
+std::string describe(const ArtObject& art)
+{
+    std::string line = "\"" + clip(art.getName(), 80) + "\", " + art.getType();
+    if (auto p = dynamic_cast<const Painting*>(&art)) {
+        if (!p->getCanvasType().empty()) line += " (" + clip(p->getCanvasType(), 30) + ")";
+    } else if (auto s = dynamic_cast<const Sculpture*>(&art)) {
+        if (!s->getMaterial().empty()) line += " (" + clip(s->getMaterial(), 30) + ")";
+    } else if (auto d = dynamic_cast<const DigitalArt*>(&art)) {
+        if (!d->getSoftware().empty()) line += " (" + clip(d->getSoftware(), 30) + ")";
+    }
+    char price[32];
+    std::snprintf(price, sizeof price, "%.2f", art.getPrice());
+    line += "; " + clip(art.getLocation(), 60) + "; price " + price;
+    if (!art.getDescription().empty()) line += "; " + clip(art.getDescription(), CatalogRetriever::kDescriptionChars);
+    return line;
+}
+
+} // namespace
+
+CatalogRetriever::CatalogRetriever(std::shared_ptr<ArtRepositoryInterface> repo,
+                                   const SimilarityIndex& index)
+    : repo_(std::move(repo)), index_(index)
+{
+}
+
+// ── Question parsing ──
+bool CatalogRetriever::parsePrice(const std::string& word, double* value)
+{
+    std::string digits;
+    double multiplier = 1.0;
+    for (std::size_t i = 0; i < word.size(); ++i) {
+        const char c = word[i];
+        if ((c >= '0' && c <= '9') || c == '.') digits += c;
+        else if (c == ',' || c == '$' || c == '\xE2' || c == '\x82' || c == '\xAC') continue;   // "€"
+        else if ((c == 'k' || c == 'm') && i + 1 == word.size() && !digits.empty()) {
+            multiplier = (c == 'k') ? 1e3 : 1e6;
+        } else {
+            return false;
+        }
+    }
+    if (digits.empty() || digits == ".") return false;
+    *value = std::strtod(digits.c_str(), nullptr) * multiplier;
+    return true;
+}
+
+SimilarityFilter CatalogRetriever::parseFilter(const std::string& question)
+{
+    SimilarityFilter filter;
+    const auto words = questionWords(question);
+    auto addKind = [&](ArtKind kind) {
+        if (std::find(filter.kinds.begin(), filter.kinds.end(), kind) == filter.kinds.end()) {
+            filter.kinds.push_back(kind);
+        }
+    };
+    // The number after a bound word, skipping "than" / "to" / "of"
+    auto numberAfter = [&](std::size_t i, double* value) {
+        for (std::size_t j = i + 1; j < words.size() && j <= i + 3; ++j) {
+            if (parsePrice(words[j], value)) return true;
+            if (!oneOf(words[j], {"than", "to", "of", "=", "about"})) return false;
+        }
+        return false;
+    };
+
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        const std::string& w = words[i];
+        double value = 0.0;
+        if (oneOf(w, {"painting", "paintings"}))                          addKind(ArtKind::Painting);
+        else if (oneOf(w, {"sculpture", "sculptures", "statue", "statues"})) addKind(ArtKind::Sculpture);
+        else if (oneOf(w, {"digital"}))                                   addKind(ArtKind::DigitalArt);
+        else if (oneOf(w, {"under", "below", "less", "cheaper", "max", "maximum", "<", "within"})
+                 && numberAfter(i, &value)) {
+            filter.maxPrice = std::min(filter.maxPrice, value);
+        } else if (oneOf(w, {"over", "above", "more", "least", "min", "minimum", ">"})
+                   && numberAfter(i, &value)) {
+            filter.minPrice = std::max(filter.minPrice, value);
+        } else if (w == "between" && numberAfter(i, &value)) {
+            double high = 0.0;
+            for (std::size_t j = i + 2; j < words.size() && j <= i + 4; ++j) {
+                if ((words[j] == "and" || words[j] == "to") && numberAfter(j, &high)) {
+                    filter.minPrice = std::min(value, high);
+                    filter.maxPrice = std::max(value, high);
+                    break;
+                }
+            }
+        }
+    }
+    return filter;
+}
+
+// ── Retrieval ──
+CatalogRetriever::Result CatalogRetriever::retrieve(const std::string& question, std::size_t k) const
+{
+    const auto started = std::chrono::steady_clock::now();
+    Result result;
+    result.filter = parseFilter(question);
+    result.filter.locations = index_.locationsIn(question);
+
+    std::vector<SimilarHit> hits = index_.search(question, result.filter, k);
+    // Unfiltered hits without any word in common are noise ("hello")
+    if (result.filter.empty()) {
+        hits.erase(std::remove_if(hits.begin(), hits.end(),
+                                  [](const SimilarHit& h) { return h.score <= 0.05f; }),
+                   hits.end());
+    }
+
+    if (!hits.empty() || !result.filter.empty()) {
+        std::string block = hits.empty()
+            ? std::string("No catalog records match the question.")
+            : "Catalog records relevant to the question, best first (" + std::to_string(hits.size())
+              + " shown; name, type, location, price, description):";
+        std::size_t n = 0;
+        for (const SimilarHit& hit : hits) {
+            auto art = repo_->get(hit.index);
+            if (!art) continue;
+            block += "\n" + std::to_string(++n) + ". " + describe(*art);
+        }
+        block += "\nAnswer from these records; say so if they do not answer the question.";
+        result.context = std::move(block);
+        result.records = n;
+    }
+    result.milliseconds = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - started).count();
+    return result;
+}
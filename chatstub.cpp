@@ -0,0 +1,218 @@
+// chat_stub: a local chat completion endpoint that misbehaves on purpose,
+// for trying ChatDialog / ChatTransport offline.
+//
+//   chat_stub [--port 8089] [--script ok,503,hang,...] [--fail-rate 0.3]
+//             [--seed 1] [--delay-ms 40] [--retry-after 1]
+//
+//   ART_CHAT_ENDPOINT=http://127.0.0.1:8089/v1/chat/completions project1
+//
+// Each request gets the next fault from --script; once the script is used
+// up, a fault is drawn at random with probability --fail-rate. Faults:
+//   ok      streams "Stub reply to: <question>" a word at a time
+//           (or one JSON body when the request has "stream": false)
+//   429     Too Many Requests with Retry-After
+//   503     Service Unavailable
+//   hang    reads the request and never answers (connect timeout)
+//   stall   sends the headers and one word, then nothing (read timeout)
+//   drop    sends the headers and one word, then closes the connection
+//   slow    like ok, with a tenfold delay between words
+// Connections are kept alive, so clients can reuse them; each request is
+// logged with its connection number.
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <cstdio>
+#include <random>
+
+namespace {
+
+struct Config {
+    quint16     port       = 8089;
+    QStringList script;
+    double      failRate   = 0.0;
+    unsigned    seed       = 1;
+    int         delayMs    = 40;
+    int         retryAfter = 1;   // seconds
+};
+
+struct Connection {
+    int        number   = 0;
+    int        requests = 0;
+    QByteArray buffer;
+    bool       busy     = false;   // answering; later requests wait
+};
+
+QByteArray chunk(const QByteArray& data)
+{
+    return QByteArray::number(data.size(), 16) + "\r\n" + data + "\r\n";
+}
+
+QByteArray event(const QString& word)
+{
+    QJsonObject delta{{"content", word}};
+    QJsonObject choice{{"index", 0}, {"delta", delta}};
+    QJsonObject body{{"choices", QJsonArray{choice}}};
+    return "data: " + QJsonDocument(body).toJson(QJsonDocument::Compact) + "\n\n";
+}
+
+class StubServer {
+public:
+    explicit StubServer(const Config& config) : config_(config), random_(config.seed) {}
+
+    bool listen() {
+        QObject::connect(&server_, &QTcpServer::newConnection, [this]() {
+            while (QTcpSocket* socket = server_.nextPendingConnection()) accept(socket);
+        });
+        return server_.listen(QHostAddress::LocalHost, config_.port);
+    }
+
+private:
+    void accept(QTcpSocket* socket) {
+        auto* conn = new Connection;
+        conn->number = ++connections_;
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket, conn]() {
+            conn->buffer += socket->readAll();
+            serve(socket, conn);
+        });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, [socket, conn]() {
+            delete conn;
+            socket->deleteLater();
+        });
+    }
+
+    // One complete request from the buffer, if there is one
+    void serve(QTcpSocket* socket, Connection* conn) {
+        if (conn->busy) return;
+        const int headerEnd = conn->buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) return;
+        qsizetype length = 0;
+        for (const QByteArray& line : conn->buffer.left(headerEnd).split('\n')) {
+            if (line.toLower().startsWith("content-length:")) length = line.mid(15).trimmed().toLongLong();
+        }
+        if (conn->buffer.size() < headerEnd + 4 + length) return;
+        const QByteArray body = conn->buffer.mid(headerEnd + 4, length);
+        conn->buffer.remove(0, headerEnd + 4 + length);
+
+        const QJsonObject request = QJsonDocument::fromJson(body).object();
+        const bool stream = request["stream"].toBool(true);
+        QString question;
+        for (const QJsonValue& m : request["messages"].toArray()) {
+            if (m.toObject()["role"].toString() == "user") question = m.toObject()["content"].toString();
+        }
+
+        const QString fault = nextFault();
+        ++conn->requests;
+        std::printf("#%d  connection %d (request %d on it)  %s  -> %s\n", ++requests_, conn->number,
+                    conn->requests, stream ? "stream" : "json", qPrintable(fault));
+        std::fflush(stdout);
+
+        if (fault == "429" || fault == "503") {
+            const QByteArray status = fault == "429" ? "429 Too Many Requests" : "503 Service Unavailable";
+            const QByteArray error = R"({"error":{"message":"stub says )" + fault.toUtf8() + R"("}})";
+            socket->write("HTTP/1.1 " + status + "\r\nContent-Type: application/json\r\n"
+                          "Retry-After: " + QByteArray::number(config_.retryAfter) + "\r\n"
+                          "Content-Length: " + QByteArray::number(error.size()) + "\r\n\r\n" + error);
+            serve(socket, conn);
+            return;
+        }
+        if (fault == "hang") {
+            conn->busy = true;   // until the client gives up
+            return;
+        }
+
+        QStringList words = ("Stub reply to: " + question).split(' ', Qt::SkipEmptyParts);
+        if (!stream && fault == "ok") {
+            QJsonObject message{{"role", "assistant"}, {"content", words.join(' ')}};
+            const QByteArray json = QJsonDocument(QJsonObject{
+                {"choices", QJsonArray{QJsonObject{{"index", 0}, {"message", message}}}}})
+                                        .toJson(QJsonDocument::Compact);
+            socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                          "Content-Length: " + QByteArray::number(json.size()) + "\r\n\r\n" + json);
+            serve(socket, conn);
+            return;
+        }
+
+        socket->write("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                      "Cache-Control: no-cache\r\nTransfer-Encoding: chunked\r\n\r\n");
+        conn->busy = true;
+        if (fault == "stall" || fault == "drop") words = words.mid(0, 1);
+        streamWords(socket, conn, words, 0, fault);
+    }
+
+    void streamWords(QTcpSocket* socket, Connection* conn, const QStringList& words, int next,
+                     const QString& fault) {
+        if (next < words.size()) {
+            socket->write(chunk(event(next ? " " + words[next] : words[next])));
+            const int delay = fault == "slow" ? config_.delayMs * 10 : config_.delayMs;
+            QPointer<QTcpSocket> guard(socket);
+            QTimer::singleShot(delay, socket, [=]() {
+                // 'conn' goes with the connection
+                if (guard && guard->state() == QAbstractSocket::ConnectedState) {
+                    streamWords(socket, conn, words, next + 1, fault);
+                }
+            });
+            return;
+        }
+        if (fault == "stall") return;   // busy for good
+        if (fault == "drop") {
+            socket->abort();
+            return;
+        }
+        socket->write(chunk("data: [DONE]\n\n") + "0\r\n\r\n");
+        conn->busy = false;
+        serve(socket, conn);
+    }
+
+    QString nextFault() {
+        if (scriptPos_ < config_.script.size()) return config_.script[scriptPos_++];
+        if (std::uniform_real_distribution<double>(0.0, 1.0)(random_) >= config_.failRate) return "ok";
+        static const char* const kFaults[] = {"429", "503", "hang", "stall", "drop", "slow"};
+        return kFaults[std::uniform_int_distribution<int>(0, 5)(random_)];
+    }
+
+    Config       config_;
+    QTcpServer   server_;
+    std::mt19937 random_;
+    int          scriptPos_   = 0;
+    int          connections_ = 0;
+    int          requests_    = 0;
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    Config config;
+    const QStringList args = app.arguments();
+    for (int i = 1; i + 1 < args.size(); i += 2) {
+        const QString& flag = args[i];
+        const QString& value = args[i + 1];
+        if (flag == "--port")             config.port = quint16(value.toUInt());
+        else if (flag == "--script")      config.script = value.split(',', Qt::SkipEmptyParts);
+        else if (flag == "--fail-rate")   config.failRate = value.toDouble();
+        else if (flag == "--seed")        config.seed = value.toUInt();
+        else if (flag == "--delay-ms")    config.delayMs = value.toInt();
+        else if (flag == "--retry-after") config.retryAfter = value.toInt();
+        else {
+            std::fprintf(stderr, "unknown option %s\n", qPrintable(flag));
+            return 2;
+        }
+    }
+
+    StubServer server(config);
+    if (!server.listen()) {
+        std::fprintf(stderr, "cannot listen on port %u\n", unsigned(config.port));
+        return 1;
+    }
+    std::printf("chat_stub on http://127.0.0.1:%u/v1/chat/completions\n", unsigned(config.port));
+    std::fflush(stdout);
+    return app.exec();
+}
@@ -0,0 +1,346 @@
+#include "ChatTranscript.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QContextMenuEvent>
+#include <QFontMetrics>
+#include <QMenu>
+#include <QPainter>
+#include <QScrollBar>
+#include <QTextOption>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Space around each message and between the text and the viewport edge
+constexpr int kMessageGap = 6;
+constexpr int kSideMargin = 6;
+
+// Lines 'text' would wrap to at 'perLine' characters, after a 'prefix'
+// of that many on the first line
+int estimateLines(const QString& text, int prefix, int perLine)
+{
+    int lines = 0;
+    int length = prefix;
+    for (QChar c : text) {
+        if (c == '\n') {
+            lines += std::max(1, (length + perLine - 1) / perLine);
+            length = 0;
+        } else {
+            ++length;
+        }
+    }
+    return lines + std::max(1, (length + perLine - 1) / perLine);
+}
+}
+
+// ── ChatTranscriptModel ──
+ChatTranscriptModel::ChatTranscriptModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int ChatTranscriptModel::append(const QString& speaker, const QString& text)
+{
+    const int row = rowCount();
+    beginInsertRows(QModelIndex(), row, row);
+    messages_.push_back({speaker, text});
+    endInsertRows();
+    return row;
+}
+
+void ChatTranscriptModel::appendText(int row, const QString& text)
+{
+    if (text.isEmpty() || row < 0 || row >= rowCount()) return;
+    messages_[std::size_t(row)].text += text;
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, {TextRole});
+}
+
+void ChatTranscriptModel::clear()
+{
+    beginResetModel();
+    messages_.clear();
+    endResetModel();
+}
+
+int ChatTranscriptModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(messages_.size());
+}
+
+QVariant ChatTranscriptModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) return {};
+    const Message& m = messages_[std::size_t(index.row())];
+    switch (role) {
+    case Qt::DisplayRole: return m.speaker + ": " + m.text;
+    case SpeakerRole:     return m.speaker;
+    case TextRole:        return m.text;
+    default:              return {};
+    }
+}
+
+// ── ChatTranscriptView ──
+ChatTranscriptView::ChatTranscriptView(QWidget* parent)
+    : QAbstractScrollArea(parent), layouts_(kCachedLayouts)
+{
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(20);
+    viewport()->setBackgroundRole(QPalette::Base);
+    viewport()->setAutoFillBackground(true);
+}
+
+void ChatTranscriptView::setModel(ChatTranscriptModel* model)
+{
+    if (model_) model_->disconnect(this);
+    model_ = model;
+    if (model_) {
+        connect(model_, &QAbstractItemModel::rowsInserted, this, &ChatTranscriptView::onRowsInserted);
+        connect(model_, &QAbstractItemModel::dataChanged, this, &ChatTranscriptView::onDataChanged);
+        connect(model_, &QAbstractItemModel::modelReset, this, &ChatTranscriptView::onModelReset);
+    }
+    onModelReset();
+}
+
+int ChatTranscriptView::textWidth() const
+{
+    return std::max(20, viewport()->width() - 2 * kSideMargin);
+}
+
+qint64 ChatTranscriptView::contentHeight() const
+{
+    return tops_.empty() ? 0 : tops_.back() + heights_.back();
+}
+
+// ── Layout ──
+QTextLayout* ChatTranscriptView::layoutFor(int row) const
+{
+    if (QTextLayout* cached = layouts_.object(row)) return cached;
+
+    const QString speaker = model_->speakerAt(row) + ": ";
+    QString text = speaker + model_->textAt(row);
+    text.replace('\n', QChar::LineSeparator);
+
+    auto* layout = new QTextLayout(text, font());
+    QTextCharFormat bold;
+    bold.setFontWeight(QFont::Bold);
+    QTextLayout::FormatRange range;
+    range.start  = 0;
+    range.length = speaker.size();
+    range.format = bold;
+    layout->setFormats({range});
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    layout->setTextOption(option);
+
+    const qreal width = textWidth();
+    qreal y = 0;
+    layout->beginLayout();
+    for (QTextLine line = layout->createLine(); line.isValid(); line = layout->createLine()) {
+        line.setLineWidth(width);
+        line.setPosition(QPointF(0, y));
+        y += line.height();
+    }
+    layout->endLayout();
+
+    layouts_.insert(row, layout);
+    ++layoutsBuilt_;
+    return layout;
+}
+
+int ChatTranscriptView::measure(int row) const
+{
+    return int(std::ceil(layoutFor(row)->boundingRect().height())) + kMessageGap;
+}
+
+// Width changed: every height is stale. They become estimates from the
+// text length, and only the rows on screen are laid out. Keeps the
+// message at the top of the view in place.
+void ChatTranscriptView::relayoutAll()
+{
+    const int anchor = rowAt(0);
+    const bool follow = atBottom();
+    layouts_.clear();
+    layoutWidth_ = textWidth();
+
+    const QFontMetrics metrics(font());
+    const int perLine = std::max(1, layoutWidth_ / std::max(1, metrics.averageCharWidth()));
+    qint64 top = 0;
+    for (std::size_t row = 0; row < heights_.size(); ++row) {
+        const int prefix = int(model_->speakerAt(int(row)).size()) + 2;   // "Speaker: "
+        heights_[row] = estimateLines(model_->textAt(int(row)), prefix, perLine) * metrics.height()
+                      + kMessageGap;
+        measured_[row] = false;
+        tops_[row] = top;
+        top += heights_[row];
+    }
+    updateScrollRange(follow);
+    if (!follow && anchor >= 0) verticalScrollBar()->setValue(int(tops_[std::size_t(anchor)]));
+    measureVisible();   // the value may not have moved
+    viewport()->update();
+}
+
+// Lay out the rows on screen that only have an estimated height and fix
+// up the tops after them. A change in a row that starts above the view
+// is scrolled away, so what is on screen stays put. True if any height
+// changed.
+bool ChatTranscriptView::measureVisible()
+{
+    const int first = rowAt(0);
+    if (first < 0) return false;
+    const bool follow = atBottom();
+    const qint64 offset = verticalScrollBar()->value();
+    const qint64 page = viewport()->height();
+    qint64 delta = 0;   // height gained so far
+    qint64 above = 0;   // ...by rows that start above the view
+    std::size_t row = std::size_t(first);
+    for (; row < tops_.size(); ++row) {
+        tops_[row] += delta;
+        if (tops_[row] >= offset + above + page) break;
+        if (measured_[row]) continue;
+        const int height = measure(int(row));
+        const int change = height - heights_[row];
+        heights_[row] = height;
+        measured_[row] = true;
+        delta += change;
+        if (tops_[row] < offset + above) above += change;
+    }
+    if (delta == 0) return false;
+    for (++row; row < tops_.size(); ++row) tops_[row] += delta;
+
+    updateScrollRange(follow);   // following: new rows at the top are measured next
+    if (!follow && above != 0) verticalScrollBar()->setValue(int(offset + above));
+    return true;
+}
+
+void ChatTranscriptView::updateScrollRange(bool follow)
+{
+    QScrollBar* bar = verticalScrollBar();
+    bar->setPageStep(viewport()->height());
+    bar->setRange(0, int(std::max<qint64>(0, contentHeight() - viewport()->height())));
+    if (follow) bar->setValue(bar->maximum());
+}
+
+bool ChatTranscriptView::atBottom() const
+{
+    return verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+}
+
+void ChatTranscriptView::scrollToBottom()
+{
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+int ChatTranscriptView::rowAt(int y) const
+{
+    if (tops_.empty()) return -1;
+    const qint64 content = qint64(y) + verticalScrollBar()->value();
+    if (content < 0 || content >= contentHeight()) return -1;
+    const auto it = std::upper_bound(tops_.begin(), tops_.end(), content);
+    return int(it - tops_.begin()) - 1;
+}
+
+// ── Model changes ──
+void ChatTranscriptView::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid()) return;
+    if (first != int(heights_.size())) {
+        onModelReset();   // only appends are expected
+        return;
+    }
+    const bool follow = atBottom();
+    for (int row = first; row <= last; ++row) {
+        const qint64 top = contentHeight();
+        heights_.push_back(measure(row));
+        measured_.push_back(true);
+        tops_.push_back(top);
+    }
+    updateScrollRange(follow);
+    viewport()->update();
+}
+
+void ChatTranscriptView::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    const bool follow = atBottom();
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        layouts_.remove(row);
+        const int height = measure(row);
+        const int delta = height - heights_[std::size_t(row)];
+        heights_[std::size_t(row)] = height;
+        measured_[std::size_t(row)] = true;
+        // Usually the last message (the reply being streamed): nothing follows
+        if (delta != 0) {
+            for (std::size_t next = std::size_t(row) + 1; next < tops_.size(); ++next) tops_[next] += delta;
+        }
+    }
+    updateScrollRange(follow);
+    viewport()->update();
+}
+
+void ChatTranscriptView::onModelReset()
+{
+    layouts_.clear();
+    heights_.clear();
+    measured_.clear();
+    tops_.clear();
+    layoutWidth_ = textWidth();
+    const int rows = model_ ? model_->rowCount() : 0;
+    if (rows > 0) onRowsInserted(QModelIndex(), 0, rows - 1);
+    updateScrollRange(true);
+    viewport()->update();
+}
+
+// ── Events ──
+void ChatTranscriptView::paintEvent(QPaintEvent*)
+{
+    if (!model_ || tops_.empty()) return;
+    QPainter painter(viewport());
+    painter.setPen(palette().color(QPalette::Text));
+
+    const int offset = verticalScrollBar()->value();
+    const int height = viewport()->height();
+    int row = std::max(0, rowAt(0));
+    for (; row < int(tops_.size()) && tops_[std::size_t(row)] < qint64(offset) + height; ++row) {
+        const qreal y = qreal(tops_[std::size_t(row)] - offset) + kMessageGap / 2.0;
+        layoutFor(row)->draw(&painter, QPointF(kSideMargin, y));
+    }
+}
+
+void ChatTranscriptView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    if (textWidth() != layoutWidth_) {
+        relayoutAll();
+    } else {
+        updateScrollRange(atBottom());
+        measureVisible();   // a taller view may show estimated rows
+    }
+}
+
+void ChatTranscriptView::scrollContentsBy(int /*dx*/, int /*dy*/)
+{
+    measureVisible();
+    viewport()->update();
+}
+
+void ChatTranscriptView::contextMenuEvent(QContextMenuEvent* event)
+{
+    if (!model_) return;
+    const int row = rowAt(event->pos().y());   // delivered from the viewport
+    QMenu menu(this);
+    QAction* copyOne = menu.addAction("Copy message");
+    copyOne->setEnabled(row >= 0);
+    QAction* copyAll = menu.addAction("Copy transcript");
+    QAction* chosen = menu.exec(event->globalPos());
+    if (chosen == copyOne && row >= 0) {
+        QApplication::clipboard()->setText(model_->textAt(row));
+    } else if (chosen == copyAll) {
+        QStringList lines;
+        for (int i = 0; i < model_->rowCount(); ++i) {
+            lines << model_->speakerAt(i) + ": " + model_->textAt(i);
+        }
+        QApplication::clipboard()->setText(lines.join("\n\n"));
+    }
+}
@@ -0,0 +1,289 @@
+#include "ChatTransport.h"
+
+#include <QTimer>
+#include <QUrl>
+#include <QDebug>
+#if QT_CONFIG(ssl)
+#include <QSslConfiguration>
+#endif
+
+namespace {
+
+constexpr int    kMaxErrorBody     = 4096;
+constexpr double kMaxRetryAfterMs  = 60000;   // longer than that: give up instead
+
+int envInt(const char* name, int fallback)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok && value > 0 ? value : fallback;
+}
+
+bool retryableNetworkError(QNetworkReply::NetworkError error)
+{
+    switch (error) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+ChatTransport::ChatTransport(QObject* parent)
+    : QObject(parent),
+    manager_(new QNetworkAccessManager(this)),
+    options_(optionsFromEnvironment()),
+    random_(std::random_device{}())
+{
+}
+
+ChatTransport::~ChatTransport()
+{
+    for (auto& entry : pending_) {
+        QNetworkReply* r = entry.second.reply;
+        if (!r) continue;
+        r->disconnect(this);
+        r->abort();
+        r->deleteLater();
+    }
+}
+
+ChatTransport::Options ChatTransport::optionsFromEnvironment()
+{
+    Options options;
+    options.connectTimeoutMs  = envInt("ART_CHAT_CONNECT_TIMEOUT_MS", options.connectTimeoutMs);
+    options.readTimeoutMs     = envInt("ART_CHAT_READ_TIMEOUT_MS", options.readTimeoutMs);
+    options.retry.maxAttempts = envInt("ART_CHAT_MAX_ATTEMPTS", options.retry.maxAttempts);
+    return options;
+}
+
+const char* ChatTransport::outcomeName(Outcome outcome) noexcept
+{
+    switch (outcome) {
+    case Outcome::Ok:           return "ok";
+    case Outcome::HttpError:    return "http error";
+    case Outcome::Timeout:      return "timeout";
+    case Outcome::NetworkError: return "network error";
+    case Outcome::Cancelled:    return "cancelled";
+    }
+    return "?";
+}
+
+// ── Requests ──
+quint64 ChatTransport::post(QNetworkRequest request, const QByteArray& body)
+{
+    const quint64 id = nextId_++;
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+
+    Pending& p = pending_[id];
+    p.request = request;
+    p.body    = body;
+    p.timer   = new QTimer(this);
+    p.timer->setSingleShot(true);
+    connect(p.timer, &QTimer::timeout, this, [this, id]() { onTimeout(id); });
+    p.total.start();
+    startAttempt(id);
+    return id;
+}
+
+void ChatTransport::abort(quint64 id)
+{
+    auto it = pending_.find(id);
+    if (it == pending_.end()) return;
+    Pending& p = it->second;
+    p.cancelled = true;
+    if (p.reply) {
+        p.reply->abort();   // onAttemptFinished() reports it
+        return;
+    }
+    // Between attempts
+    Result result;
+    result.id       = id;
+    result.outcome  = Outcome::Cancelled;
+    result.attempts = p.attempts;
+    result.error    = "cancelled";
+    complete(id, result);
+}
+
+void ChatTransport::warmUp(const QUrl& endpoint)
+{
+    if (endpoint.scheme() == "https") {
+#if QT_CONFIG(ssl)
+        QSslConfiguration ssl = QSslConfiguration::defaultConfiguration();
+        ssl.setAllowedNextProtocols({QSslConfiguration::ALPNProtocolHTTP2,
+                                     QSslConfiguration::NextProtocolHttp1_1});
+        manager_->connectToHostEncrypted(endpoint.host(), quint16(endpoint.port(443)), ssl);
+#endif
+    } else if (endpoint.scheme() == "http") {
+        manager_->connectToHost(endpoint.host(), quint16(endpoint.port(80)));
+    }
+}
+
+// ── Attempts ──
+void ChatTransport::startAttempt(quint64 id)
+{
+    Pending& p = pending_.at(id);
+    ++p.attempts;
+    p.headers  = false;
+    p.timedOut = false;
+    p.firstByteMs = -1;
+    p.errorBody.clear();
+    p.attempt.start();
+
+    QNetworkReply* reply = manager_->post(p.request, p.body);
+    p.reply = reply;
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, id, reply]() { onHeaders(id, reply); });
+    connect(reply, &QNetworkReply::readyRead, this, [this, id, reply]() { takeData(id, reply); });
+    connect(reply, &QNetworkReply::finished, this, [this, id, reply]() { onAttemptFinished(id, reply); });
+    p.timer->start(options_.connectTimeoutMs);
+}
+
+void ChatTransport::onHeaders(quint64 id, QNetworkReply* reply)
+{
+    auto it = pending_.find(id);
+    if (it == pending_.end() || it->second.reply != reply) return;
+    Pending& p = it->second;
+    p.headers = true;
+    if (p.firstByteMs < 0) p.firstByteMs = p.total.elapsed();
+    p.timer->start(options_.readTimeoutMs);
+}
+
+// False if the request is gone (the receiver aborted it)
+bool ChatTransport::takeData(quint64 id, QNetworkReply* reply)
+{
+    auto it = pending_.find(id);
+    if (it == pending_.end() || it->second.reply != reply) return false;
+    Pending& p = it->second;
+    const QByteArray data = reply->readAll();
+    if (data.isEmpty()) return true;
+    p.headers = true;
+    if (p.firstByteMs < 0) p.firstByteMs = p.total.elapsed();
+    p.timer->start(options_.readTimeoutMs);
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status >= 400) {
+        p.errorBody += data.left(kMaxErrorBody - p.errorBody.size());
+        return true;
+    }
+    p.delivered = true;
+    p.bytesReceived += data.size();
+    const bool eventStream = reply->header(QNetworkRequest::ContentTypeHeader).toString()
+                                 .startsWith("text/event-stream", Qt::CaseInsensitive);
+    emit dataReceived(id, data, eventStream);
+    return pending_.count(id) != 0;
+}
+
+void ChatTransport::onTimeout(quint64 id)
+{
+    auto it = pending_.find(id);
+    if (it == pending_.end() || !it->second.reply) return;
+    it->second.timedOut = true;
+    it->second.reply->abort();
+}
+
+void ChatTransport::onAttemptFinished(quint64 id, QNetworkReply* reply)
+{
+    if (!takeData(id, reply)) {
+        reply->deleteLater();
+        return;
+    }
+    Pending& p = pending_.at(id);
+    p.timer->stop();
+    p.reply = nullptr;
+    reply->deleteLater();
+
+    Result result;
+    result.id            = id;
+    result.attempts      = p.attempts;
+    result.firstByteMs   = p.firstByteMs;
+    result.bytesReceived = p.bytesReceived;
+    result.httpStatus    = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    result.http2         = reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool();
+    if (p.cancelled) {
+        result.outcome = Outcome::Cancelled;
+        result.error   = "cancelled";
+    } else if (p.timedOut) {
+        result.outcome = Outcome::Timeout;
+        result.error   = p.headers
+            ? QString("no data for %1 s").arg(options_.readTimeoutMs / 1000.0)
+            : QString("no response within %1 s").arg(options_.connectTimeoutMs / 1000.0);
+    } else if (result.httpStatus >= 400) {
+        result.outcome = Outcome::HttpError;
+        result.error   = QString("HTTP %1").arg(result.httpStatus);
+    } else if (reply->error() != QNetworkReply::NoError) {
+        result.outcome = Outcome::NetworkError;
+        result.error   = reply->errorString();
+    }
+    latency_[std::size_t(result.outcome)].record(double(p.attempt.nsecsElapsed()) / 1e6);
+    if (result.outcome == Outcome::Ok && result.http2) ++http2Replies_;
+
+    // Again, unless the user has seen part of this reply
+    bool retry = false;
+    double retryAfterMs = 0.0;
+    if (!p.delivered && p.attempts < options_.retry.maxAttempts) {
+        switch (result.outcome) {
+        case Outcome::Timeout:
+            retry = true;
+            break;
+        case Outcome::NetworkError:
+            retry = retryableNetworkError(reply->error());
+            break;
+        case Outcome::HttpError: {
+            retry = RetryPolicy::retryableStatus(result.httpStatus);
+            bool ok = false;
+            const double seconds = reply->rawHeader("Retry-After").trimmed().toDouble(&ok);
+            if (ok) retryAfterMs = seconds * 1000.0;
+            if (retryAfterMs > kMaxRetryAfterMs) retry = false;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    if (!retry) {
+        result.errorBody = p.errorBody;
+        complete(id, result);
+        return;
+    }
+
+    const double unit = std::uniform_real_distribution<double>(0.0, 1.0)(random_);
+    const int delay = int(options_.retry.delayMs(p.attempts, unit, retryAfterMs));
+    ++retries_;
+    qInfo().noquote() << QString("[ChatTransport] request %1 attempt %2: %3, retrying in %4 ms")
+                             .arg(id).arg(p.attempts).arg(result.error).arg(delay);
+    emit retrying(id, p.attempts + 1, delay, result.error);
+    QTimer::singleShot(delay, this, [this, id]() {
+        auto it = pending_.find(id);
+        if (it != pending_.end() && !it->second.cancelled && !it->second.reply) startAttempt(id);
+    });
+}
+
+void ChatTransport::complete(quint64 id, Result result)
+{
+    auto it = pending_.find(id);
+    if (it == pending_.end()) return;
+    result.elapsedMs = it->second.total.elapsed();
+    it->second.timer->deleteLater();
+    pending_.erase(it);
+    emit finished(result);
+}
+
+QString ChatTransport::statsSummary() const
+{
+    QString out;
+    for (std::size_t i = 0; i < kOutcomes; ++i) {
+        if (latency_[i].count() == 0) continue;
+        out += QString("  %1: %2\n").arg(outcomeName(Outcome(i)), -13)
+                   .arg(QString::fromStdString(latency_[i].summary()));
+    }
+    out += QString("  %1 retries, %2 replies over HTTP/2").arg(retries_).arg(http2Replies_);
+    return out;
+}
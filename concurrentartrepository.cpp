@@ -0,0 +1,183 @@
+#include "ConcurrentArtRepository.h"
+
+#include <algorithm>
+
+using Chunk    = ArtSnapshot::Chunk;
+using ChunkPtr = ArtSnapshot::ChunkPtr;
+
+ConcurrentArtRepository::ConcurrentArtRepository()
+    : head_(std::make_shared<const ArtSnapshot>())
+    , published_(head_)
+{
+}
+
+void ConcurrentArtRepository::publish(ArtSnapshotPtr next) noexcept
+{
+    head_ = next;
+    std::atomic_store_explicit(&published_, std::move(next), std::memory_order_release);
+}
+
+ArtSnapshotPtr ConcurrentArtRepository::snapshot() const
+{
+    return std::atomic_load_explicit(&published_, std::memory_order_acquire);
+}
+
+ArtSnapshotPtr ConcurrentArtRepository::rebuild(const ArtSnapshot& base, std::size_t keepChunks,
+                                                std::vector<ArtPtr> tail)
+{
+    std::vector<ChunkPtr> chunks(base.chunks().begin(), base.chunks().begin() + keepChunks);
+    const std::size_t size = keepChunks * ArtSnapshot::kChunkSize + tail.size();
+    for (std::size_t i = 0; i < tail.size(); i += ArtSnapshot::kChunkSize) {
+        const std::size_t end = std::min(tail.size(), i + ArtSnapshot::kChunkSize);
+        chunks.push_back(std::make_shared<const Chunk>(
+            std::make_move_iterator(tail.begin() + i),
+            std::make_move_iterator(tail.begin() + end)));
+    }
+    return std::make_shared<const ArtSnapshot>(std::move(chunks), size);
+}
+
+// ── In-memory CRUD ──
+void ConcurrentArtRepository::add(const ArtPtr& art)
+{
+    std::size_t index;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        const ArtSnapshot& cur = *head_;
+        std::vector<ChunkPtr> chunks = cur.chunks();
+        index = cur.size();
+
+        if (index % ArtSnapshot::kChunkSize == 0) {
+            // Last chunk is full (or there is none): start a new one
+            auto chunk = std::make_shared<Chunk>();
+            chunk->reserve(ArtSnapshot::kChunkSize);
+            chunk->push_back(art);
+            chunks.push_back(std::move(chunk));
+        } else {
+            auto chunk = std::make_shared<Chunk>(*chunks.back());
+            chunk->push_back(art);
+            chunks.back() = std::move(chunk);
+        }
+        publish(std::make_shared<const ArtSnapshot>(std::move(chunks), index + 1));
+    }
+    notifyAdded(index, art);
+}
+
+// One new version for the whole batch: fill up the last chunk, then
+// append fresh ones
+void ConcurrentArtRepository::addMany(const std::vector<ArtPtr>& arts)
+{
+    if (arts.empty()) return;
+    std::size_t first;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        const ArtSnapshot& cur = *head_;
+        first = cur.size();
+        const std::size_t keep = first >> ArtSnapshot::kChunkShift;
+
+        std::vector<ArtPtr> tail;
+        tail.reserve(first - keep * ArtSnapshot::kChunkSize + arts.size());
+        for (std::size_t i = keep * ArtSnapshot::kChunkSize; i < first; ++i) {
+            tail.push_back(cur.at(i));
+        }
+        tail.insert(tail.end(), arts.begin(), arts.end());
+        publish(rebuild(cur, keep, std::move(tail)));
+    }
+
+    BatchScope batch(*this);
+    for (std::size_t i = 0; i < arts.size(); ++i) {
+        notifyAdded(first + i, arts[i]);
+    }
+}
+
+bool ConcurrentArtRepository::update(std::size_t index, const ArtPtr& art) noexcept
+{
+    ArtPtr old;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        const ArtSnapshot& cur = *head_;
+        if (index >= cur.size()) return false;
+        old = cur.at(index);
+
+        std::vector<ChunkPtr> chunks = cur.chunks();
+        const std::size_t c = index >> ArtSnapshot::kChunkShift;
+        auto chunk = std::make_shared<Chunk>(*chunks[c]);
+        (*chunk)[index & ArtSnapshot::kChunkMask] = art;
+        chunks[c] = std::move(chunk);
+        publish(std::make_shared<const ArtSnapshot>(std::move(chunks), cur.size()));
+    }
+    notifyUpdated(index, old, art);
+    return true;
+}
+
+bool ConcurrentArtRepository::remove(std::size_t index) noexcept
+{
+    return removeMany({index}) == 1;
+}
+
+ConcurrentArtRepository::ArtPtr ConcurrentArtRepository::get(std::size_t index) const noexcept
+{
+    if (index >= head_->size()) return nullptr;
+    return head_->at(index);
+}
+
+std::size_t ConcurrentArtRepository::size() const noexcept
+{
+    return head_->size();
+}
+
+void ConcurrentArtRepository::clear() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        publish(std::make_shared<const ArtSnapshot>());
+    }
+    notifyReset();
+}
+
+// Everything before the first removed index keeps its chunks; the rest
+// is re-chunked in one pass
+std::size_t ConcurrentArtRepository::removeMany(std::vector<std::size_t> indices) noexcept
+{
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    std::vector<ArtPtr> removed;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        const ArtSnapshot& cur = *head_;
+        while (!indices.empty() && indices.back() >= cur.size()) indices.pop_back();
+        if (indices.empty()) return 0;
+
+        const std::size_t keep = indices.front() >> ArtSnapshot::kChunkShift;
+        std::vector<ArtPtr> tail;
+        tail.reserve(cur.size() - keep * ArtSnapshot::kChunkSize - indices.size());
+        removed.reserve(indices.size());
+
+        std::size_t next = 0;
+        for (std::size_t i = keep * ArtSnapshot::kChunkSize; i < cur.size(); ++i) {
+            if (next < indices.size() && indices[next] == i) {
+                removed.push_back(cur.at(i));
+                ++next;
+            } else {
+                tail.push_back(cur.at(i));
+            }
+        }
+        publish(rebuild(cur, keep, std::move(tail)));
+    }
+
+    // Highest index first, as if removed one at a time
+    BatchScope batch(*this);
+    for (std::size_t i = indices.size(); i-- > 0; ) {
+        notifyRemoved(indices[i], removed[i]);
+    }
+    return indices.size();
+}
+
+void ConcurrentArtRepository::replaceAll(std::vector<ArtPtr> items) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        publish(std::make_shared<const ArtSnapshot>(std::move(items)));
+    }
+    notifyReset();
+}
@@ -2,36 +2,6 @@
 #include <QFileInfo>
 #include <QDebug>
 
-// ── In‐memory CRUD ──
-void CsvRepository::add(const ArtPtr& art) {
-    items_.push_back(art);
-}
-
-bool CsvRepository::update(std::size_t index, const ArtPtr& art) noexcept {
-    if (index >= items_.size()) return false;
-    items_[index] = art;
-    return true;
-}
-
-bool CsvRepository::remove(std::size_t index) noexcept {
-    if (index >= items_.size()) return false;
-    items_.erase(items_.begin() + index);
-    return true;
-}
-
-ArtRepositoryInterface::ArtPtr CsvRepository::get(std::size_t index) const noexcept {
-    if (index >= items_.size()) return nullptr;
-    return items_[index];
-}
-
-std::size_t CsvRepository::size() const noexcept {
-    return items_.size();
-}
-
-void CsvRepository::clear() noexcept {
-    items_.clear();
-}
-
 // ── Persistence: SAVE ──
 bool CsvRepository::saveToFile(const QString& filePath) const {
     QFile file(filePath);
@@ -56,7 +26,7 @@ bool CsvRepository::saveToFile(const QString& filePath) const {
         return copy;
     };
 
-    for (auto& art : items_) {
+    for (const auto& art : *snapshot()) {
         QString type    = QString::fromStdString(art->getType());
         QString name    = QString::fromStdString(art->getName());
         QString desc    = QString::fromStdString(art->getDescription());
@@ -102,73 +72,92 @@ bool CsvRepository::loadFromFile(const QString& filePath) {
         return false;
     }
     QTextStream in(&file);
-    items_.clear();
+    std::vector<ArtPtr> items;
 
     // Skip header
     QString header = in.readLine();
 
     while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
+        QString line = readCsvRecord(in).trimmed();
         if (line.isEmpty()) continue;
 
-        QStringList fields = parseCsvLine(line);
-        if (fields.size() < 8) continue;  // bad row
-
-        QString type    = fields[0];
-        QString name    = fields[1];
-        QString desc    = fields[2];
-        double price    = fields[3].toDouble();
-        QString loc     = fields[4];
-        QString extra1  = fields[5];
-        QString extra2  = fields[6];
-        QString imgPath = fields[7];
-
-        if (type == "Painting") {
-            auto p = std::make_shared<Painting>(
-                name.toStdString(),
-                desc.toStdString(),
-                price,
-                loc.toStdString(),
-                extra1.toStdString(),  // canvasType
-                imgPath                 // imagePath
-                );
-            items_.push_back(p);
-        }
-        else if (type == "Sculpture") {
-            auto s = std::make_shared<Sculpture>(
-                name.toStdString(),
-                desc.toStdString(),
-                price,
-                loc.toStdString(),
-                extra1.toStdString(),  // material
-                imgPath
-                );
-            items_.push_back(s);
-        }
-        else if (type == "DigitalArt") {
-            QStringList dims = extra2.split('x');
-            int resX = dims.value(0).toInt();
-            int resY = dims.value(1).toInt();
-            auto d = std::make_shared<DigitalArt>(
-                name.toStdString(),
-                desc.toStdString(),
-                price,
-                loc.toStdString(),
-                extra1.toStdString(),  // software
-                resX,
-                resY,
-                imgPath
-                );
-            items_.push_back(d);
+        if (auto art = fromCsvFields(parseCsvLine(line))) {
+            items.push_back(art);
         }
     }
 
     file.close();
+    replaceAll(std::move(items));
     return true;
 }
 
+// ── CSV row → art object ──
+ArtRepositoryInterface::ArtPtr CsvRepository::fromCsvFields(const QStringList& fields) {
+    if (fields.size() < 8) return nullptr;  // bad row
+
+    QString type    = fields[0];
+    QString name    = fields[1];
+    QString desc    = fields[2];
+    double price    = fields[3].toDouble();
+    QString loc     = fields[4];
+    QString extra1  = fields[5];
+    QString extra2  = fields[6];
+    QString imgPath = fields[7];
+
+    if (type == "Painting") {
+        return std::make_shared<Painting>(
+            name.toStdString(),
+            desc.toStdString(),
+            price,
+            loc.toStdString(),
+            extra1.toStdString(),  // canvasType
+            imgPath                 // imagePath
+            );
+    }
+    else if (type == "Sculpture") {
+        return std::make_shared<Sculpture>(
+            name.toStdString(),
+            desc.toStdString(),
+            price,
+            loc.toStdString(),
+            extra1.toStdString(),  // material
+            imgPath
+            );
+    }
+    else if (type == "DigitalArt") {
+        QStringList dims = extra2.split('x');
+        int resX = dims.value(0).toInt();
+        int resY = dims.value(1).toInt();
+        return std::make_shared<DigitalArt>(
+            name.toStdString(),
+            desc.toStdString(),
+            price,
+            loc.toStdString(),
+            extra1.toStdString(),  // software
+            resX,
+            resY,
+            imgPath
+            );
+    }
+    return nullptr;
+}
+
+// ── CSV record reader ──
+QString CsvRepository::readCsvRecord(QTextStream& in) {
+    QString record = in.readLine();
+    // An odd number of quotes so far: a quoted field goes on to the next line
+    qsizetype quotes = record.count('"');
+    while (quotes % 2 != 0 && !in.atEnd()) {
+        const QString next = in.readLine();
+        quotes += next.count('"');
+        record += '\n';
+        record += next;
+    }
+    return record;
+}
+
 // ── CSV line parser ──
-QStringList CsvRepository::parseCsvLine(const QString& line) const {
+QStringList CsvRepository::parseCsvLine(const QString& line) {
     QStringList output;
     QString current;
     bool inQuotes = false;
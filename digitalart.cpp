@@ -47,3 +47,7 @@ void DigitalArt::setResolution(int resolutionX, int resolutionY) {
 std::string DigitalArt::getType() const noexcept {
     return "DigitalArt";
 }
+
+std::shared_ptr<ArtObject> DigitalArt::clone() const {
+    return std::make_shared<DigitalArt>(*this);
+}
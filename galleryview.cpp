@@ -0,0 +1,285 @@
+#include "GalleryView.h"
+#include "ThumbnailLoader.h"
+#include "ArtObject.h"
+
+#include <QPainter>
+#include <QScrollBar>
+#include <QSignalBlocker>
+#include <QItemSelectionModel>
+#include <QSet>
+
+#include <algorithm>
+
+namespace {
+// Decoded thumbnails the grid may keep in memory (~500 tiles of 128 px).
+constexpr qint64 kDefaultGalleryBudget = 32LL * 1024 * 1024;
+// Padding around the thumbnail inside a tile.
+constexpr int kTileMargin = 6;
+}
+
+// ── GalleryModel ──
+GalleryModel::GalleryModel(std::shared_ptr<ArtRepositoryInterface> repo,
+                           ThumbnailLoader* loader,
+                           QObject* parent)
+    : QAbstractListModel(parent), repo_(std::move(repo)), loader_(loader)
+{
+    connect(loader_, &ThumbnailLoader::thumbnailReady,
+            this, &GalleryModel::onThumbnailReady);
+}
+
+void GalleryModel::setIndices(const std::vector<std::size_t>& indices)
+{
+    beginResetModel();
+    indices_ = indices;
+    waiting_.clear();
+    endResetModel();
+}
+
+void GalleryModel::appendIndices(const std::vector<std::size_t>& indices)
+{
+    if (indices.empty()) return;
+    const int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(indices.size()) - 1);
+    indices_.insert(indices_.end(), indices.begin(), indices.end());
+    endInsertRows();
+}
+
+std::size_t GalleryModel::repoIndexAt(int row) const noexcept
+{
+    return indices_[static_cast<std::size_t>(row)];
+}
+
+void GalleryModel::setTileSize(const QSize& size)
+{
+    if (size == tileSize_) return;
+    beginResetModel();
+    tileSize_ = size;
+    waiting_.clear();
+    endResetModel();
+}
+
+QSize GalleryModel::tileSize() const noexcept
+{
+    return tileSize_;
+}
+
+int GalleryModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(indices_.size());
+}
+
+QString GalleryModel::imagePathAt(int row) const
+{
+    auto art = repo_->get(indices_[static_cast<std::size_t>(row)]);
+    return art ? art->getImagePath() : QString();
+}
+
+QVariant GalleryModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) return {};
+    auto art = repo_->get(indices_[static_cast<std::size_t>(index.row())]);
+    if (!art) return {};
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString::fromStdString(art->getName());
+    case Qt::ToolTipRole:
+        return QString("%1\n%2").arg(QString::fromStdString(art->getName()))
+                                .arg(art->getPrice());
+    case Qt::DecorationRole: {
+        const QString path = art->getImagePath();
+        if (path.isEmpty()) return {};
+        QImage thumb;
+        if (loader_->lookup(path, tileSize_, &thumb)) return thumb;
+        // Only tiles being painted get here, so loading is viewport-driven
+        loader_->request(path, tileSize_);
+        if (!waiting_.contains(path, index.row())) waiting_.insert(path, index.row());
+        return {};
+    }
+    default:
+        return {};
+    }
+}
+
+void GalleryModel::setViewport(int first, int last)
+{
+    if (indices_.empty() || first < 0 || last < first) return;
+    const int count = rowCount();
+    last = std::min(last, count - 1);
+
+    QSet<QString> visible;
+    for (int row = first; row <= last; ++row) {
+        const QString path = imagePathAt(row);
+        if (!path.isEmpty()) visible.insert(path);
+    }
+    loader_->retain(visible, tileSize_);
+
+    for (auto it = waiting_.begin(); it != waiting_.end(); ) {
+        if (it.value() < first || it.value() > last) it = waiting_.erase(it);
+        else ++it;
+    }
+
+    // Decode the next screenful ahead of the scroll
+    QStringList ahead;
+    const int page = last - first + 1;
+    for (int row = last + 1; row < count && row <= last + page; ++row) {
+        ahead << imagePathAt(row);
+    }
+    loader_->prefetch(ahead, tileSize_, loader_->cacheLimit() / 4);
+}
+
+void GalleryModel::onThumbnailReady(const QString& path, const QSize& size, const QImage& /*image*/)
+{
+    if (size != tileSize_) return;
+    const QList<int> rows = waiting_.values(path);
+    waiting_.remove(path);
+    for (int row : rows) {
+        if (row >= rowCount()) continue;
+        const QModelIndex idx = index(row);
+        emit dataChanged(idx, idx, {Qt::DecorationRole});
+    }
+}
+
+// ── GalleryDelegate ──
+GalleryDelegate::GalleryDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void GalleryDelegate::setTileSize(const QSize& size)
+{
+    tileSize_ = size;
+}
+
+void GalleryDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
+                            const QModelIndex& index) const
+{
+    painter->save();
+
+    const bool selected = option.state.testFlag(QStyle::State_Selected);
+    if (selected) painter->fillRect(option.rect, option.palette.highlight());
+
+    const QRect imageRect(option.rect.x() + (option.rect.width() - tileSize_.width()) / 2,
+                          option.rect.y() + kTileMargin,
+                          tileSize_.width(), tileSize_.height());
+
+    // drawImage straight from the cached QImage: no QPixmap/QIcon
+    // conversion per paint, which matters without a GPU.
+    const QImage thumb = qvariant_cast<QImage>(index.data(Qt::DecorationRole));
+    if (!thumb.isNull()) {
+        QRect target(QPoint(), thumb.size());
+        target.moveCenter(imageRect.center());
+        painter->drawImage(target.topLeft(), thumb);
+    } else {
+        painter->fillRect(imageRect, option.palette.alternateBase());
+    }
+
+    const QRect textRect(option.rect.x() + kTileMargin / 2,
+                         imageRect.bottom() + kTileMargin / 2,
+                         option.rect.width() - kTileMargin,
+                         option.fontMetrics.height());
+    const QString name = option.fontMetrics.elidedText(
+        index.data(Qt::DisplayRole).toString(), Qt::ElideRight, textRect.width());
+    painter->setPen(selected ? option.palette.highlightedText().color()
+                             : option.palette.text().color());
+    painter->drawText(textRect, Qt::AlignHCenter | Qt::AlignVCenter, name);
+
+    painter->restore();
+}
+
+QSize GalleryDelegate::sizeHint(const QStyleOptionViewItem& option,
+                                const QModelIndex& /*index*/) const
+{
+    return QSize(tileSize_.width() + 2 * kTileMargin,
+                 tileSize_.height() + option.fontMetrics.height() + 2 * kTileMargin);
+}
+
+// ── GalleryView ──
+GalleryView::GalleryView(std::shared_ptr<ArtRepositoryInterface> repo,
+                         std::shared_ptr<ThumbnailDiskCache> disk,
+                         QWidget* parent)
+    : QListView(parent)
+    , loader_(new ThumbnailLoader(this))
+    , model_(new GalleryModel(std::move(repo), loader_, this))
+    , delegate_(new GalleryDelegate(this))
+{
+    loader_->setDiskCache(std::move(disk));
+    loader_->setCacheLimit(kDefaultGalleryBudget);
+
+    delegate_->setTileSize(model_->tileSize());
+    setModel(model_);
+    setItemDelegate(delegate_);
+
+    setViewMode(QListView::IconMode);
+    setMovement(QListView::Static);        // IconMode defaults to Free
+    setResizeMode(QListView::Adjust);
+    setWrapping(true);
+    setSelectionMode(QAbstractItemView::SingleSelection);
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+
+    // Every tile has the same size: layout never asks the delegate per
+    // row, which keeps tens of thousands of rows cheap to scroll.
+    setUniformItemSizes(true);
+    setGridSize(QSize(model_->tileSize().width() + 2 * kTileMargin,
+                      model_->tileSize().height() + fontMetrics().height() + 2 * kTileMargin));
+
+    viewportTimer_.setSingleShot(true);
+    viewportTimer_.setInterval(50);
+    connect(&viewportTimer_, &QTimer::timeout, this, &GalleryView::updateViewport);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged,
+            &viewportTimer_, qOverload<>(&QTimer::start));
+
+    connect(selectionModel(), &QItemSelectionModel::currentChanged,
+            this, [this](const QModelIndex& current, const QModelIndex&) {
+                emit currentRowChanged(current.isValid() ? current.row() : -1);
+            });
+}
+
+void GalleryView::setIndices(const std::vector<std::size_t>& indices)
+{
+    model_->setIndices(indices);
+    viewportTimer_.start();
+}
+
+void GalleryView::appendIndices(const std::vector<std::size_t>& indices)
+{
+    model_->appendIndices(indices);
+    viewportTimer_.start();
+}
+
+void GalleryView::setCurrentRow(int row)
+{
+    // Mirrors the list selection; must not echo back as a user change
+    const QSignalBlocker block(this);
+    if (row < 0 || row >= model_->rowCount()) {
+        clearSelection();
+        return;
+    }
+    const QModelIndex idx = model_->index(row);
+    setCurrentIndex(idx);
+    scrollTo(idx);
+}
+
+void GalleryView::setMemoryBudget(qint64 bytes)
+{
+    loader_->setCacheLimit(bytes);
+}
+
+void GalleryView::resizeEvent(QResizeEvent* event)
+{
+    QListView::resizeEvent(event);
+    viewportTimer_.start();
+}
+
+void GalleryView::updateViewport()
+{
+    const QSize grid = gridSize();
+    if (grid.isEmpty() || model_->rowCount() == 0) return;
+
+    const int perLine  = std::max(1, viewport()->width() / grid.width());
+    const int topLine  = verticalOffset() / grid.height();
+    const int lines    = viewport()->height() / grid.height() + 2;
+    const int first    = topLine * perLine;
+    const int last     = first + lines * perLine - 1;
+    model_->setViewport(first, last);
+}
@@ -0,0 +1,59 @@
+#include "ImagePrefetcher.h"
+#include "ThumbnailLoader.h"
+
+namespace {
+// Idle time after the last keystroke before prefetching resumes.
+constexpr int kBackoffMs = 400;
+}
+
+ImagePrefetcher::ImagePrefetcher(ThumbnailLoader* loader, QObject* parent)
+    : QObject(parent), loader_(loader)
+{
+    resumeTimer_.setSingleShot(true);
+    resumeTimer_.setInterval(kBackoffMs);
+    connect(&resumeTimer_, &QTimer::timeout, this, &ImagePrefetcher::apply);
+}
+
+void ImagePrefetcher::setRadius(int rows) noexcept
+{
+    radius_ = rows < 0 ? 0 : rows;
+}
+
+int ImagePrefetcher::radius() const noexcept
+{
+    return radius_;
+}
+
+void ImagePrefetcher::setBudget(qint64 bytes) noexcept
+{
+    budget_ = bytes;
+}
+
+void ImagePrefetcher::update(const QStringList& paths, const QSize& size)
+{
+    paths_ = paths;
+    size_  = size;
+    if (resumeTimer_.isActive()) return;   // backing off: apply() runs later
+    apply();
+}
+
+void ImagePrefetcher::backOff()
+{
+    loader_->cancelPending(ThumbnailLoader::Priority::Prefetch);
+    resumeTimer_.start();
+}
+
+void ImagePrefetcher::apply()
+{
+    if (radius_ == 0 || paths_.isEmpty()) return;
+    loader_->prefetch(paths_, size_, budget_);
+}
+
+QString ImagePrefetcher::statsSummary() const
+{
+    const ThumbnailLoader::Stats& s = loader_->stats();
+    return QString("memory hits %1, disk hits %2, misses %3, "
+                   "prefetched %4 (used %5, wasted %6)")
+        .arg(s.memoryHits).arg(s.diskHits).arg(s.misses)
+        .arg(s.prefetchIssued).arg(s.prefetchUsed).arg(s.prefetchWasted);
+}
@@ -0,0 +1,169 @@
+#include "NameIndex.h"
+#include "ArtObject.h"
+#include "Mix64.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+// The filter is sized for twice the records it holds, and rebuilt when
+// it fills up or a good part of its names are gone
+constexpr std::size_t kMinBloomCapacity = 1024;
+constexpr double      kBloomFalsePositive = 0.01;
+}
+
+NameIndex::NameIndex(std::shared_ptr<ArtRepositoryInterface> repo)
+    : repo_(std::move(repo))
+{
+    rebuild();
+    repo_->addObserver(this);
+}
+
+NameIndex::~NameIndex()
+{
+    repo_->removeObserver(this);
+}
+
+// ── Keys ──
+std::string NameIndex::normalize(const QString& name)
+{
+    return name.normalized(QString::NormalizationForm_KC)
+               .toCaseFolded()
+               .simplified()
+               .toStdString();
+}
+
+std::string NameIndex::normalize(const std::string& utf8Name)
+{
+    return normalize(QString::fromStdString(utf8Name));
+}
+
+std::uint64_t NameIndex::hashKey(const std::string& key) noexcept
+{
+    return mix64(std::hash<std::string>{}(key));
+}
+
+// ── Lookup ──
+bool NameIndex::mightContain(const QString& name) const
+{
+    return bloom_.mightContain(hashKey(normalize(name)));
+}
+
+std::vector<std::size_t> NameIndex::find(const QString& name) const
+{
+    const std::string key = normalize(name);
+    if (!bloom_.mightContain(hashKey(key))) return {};
+    auto it = postings_.find(key);
+    if (it == postings_.end()) return {};
+    return it->second;
+}
+
+std::shared_ptr<const BloomFilter> NameIndex::bloomSnapshot() const
+{
+    return std::make_shared<const BloomFilter>(bloom_);
+}
+
+// ── Maintenance ──
+void NameIndex::rebuild()
+{
+    postings_.clear();
+    pendingRemovals_.clear();
+    count_ = repo_->size();
+    const ArtSnapshotPtr items = repo_->snapshot();
+    postings_.reserve(items->size());
+    std::size_t index = 0;
+    for (const auto& art : *items) {
+        if (art) postings_[normalize(art->getName())].push_back(index);
+        ++index;
+    }
+    rebuildBloom();
+}
+
+void NameIndex::rebuildBloom()
+{
+    bloomCapacity_ = std::max(kMinBloomCapacity, 2 * count_);
+    bloom_ = BloomFilter(bloomCapacity_, kBloomFalsePositive);
+    for (const auto& entry : postings_) bloom_.insert(hashKey(entry.first));
+    staleInBloom_ = 0;
+}
+
+void NameIndex::insertPosting(const std::string& key, std::size_t index)
+{
+    Postings& list = postings_[key];
+    if (list.empty() || list.back() < index) list.push_back(index);
+    else list.insert(std::lower_bound(list.begin(), list.end(), index), index);
+    bloom_.insert(hashKey(key));
+}
+
+void NameIndex::erasePosting(const std::string& key, std::size_t index)
+{
+    auto it = postings_.find(key);
+    if (it == postings_.end()) return;
+    Postings& list = it->second;
+    auto pos = std::lower_bound(list.begin(), list.end(), index);
+    if (pos != list.end() && *pos == index) list.erase(pos);
+    if (list.empty()) postings_.erase(it);
+}
+
+void NameIndex::flushRemovals()
+{
+    if (pendingRemovals_.empty()) return;
+    std::vector<std::size_t> removed(pendingRemovals_.rbegin(), pendingRemovals_.rend());
+    pendingRemovals_.clear();
+
+    // Every index drops by the number of removals below it
+    for (auto& entry : postings_) {
+        for (std::size_t& index : entry.second) {
+            index -= std::lower_bound(removed.begin(), removed.end(), index) - removed.begin();
+        }
+    }
+}
+
+void NameIndex::itemAdded(std::size_t index, const ArtPtr& art)
+{
+    flushRemovals();
+    if (index < count_) {
+        // Inserted in the middle (repositories append today)
+        for (auto& entry : postings_) {
+            for (std::size_t& i : entry.second) if (i >= index) ++i;
+        }
+    }
+    ++count_;
+    if (art) insertPosting(normalize(art->getName()), index);
+    if (count_ > bloomCapacity_) rebuildBloom();
+}
+
+void NameIndex::itemUpdated(std::size_t index, const ArtPtr& oldArt, const ArtPtr& newArt)
+{
+    flushRemovals();
+    const std::string oldKey = oldArt ? normalize(oldArt->getName()) : std::string();
+    const std::string newKey = newArt ? normalize(newArt->getName()) : std::string();
+    if (oldArt && newArt && oldKey == newKey) return;   // e.g. a price edit
+    if (oldArt) {
+        erasePosting(oldKey, index);
+        ++staleInBloom_;
+    }
+    if (newArt) insertPosting(newKey, index);
+}
+
+void NameIndex::itemRemoved(std::size_t index, const ArtPtr& art)
+{
+    // Pending removals must all lie above this one for the deferred
+    // shift to be right; anything else is applied first
+    if (!pendingRemovals_.empty() && pendingRemovals_.back() <= index) flushRemovals();
+    if (art) erasePosting(normalize(art->getName()), index);
+    pendingRemovals_.push_back(index);
+    if (count_ > 0) --count_;
+    ++staleInBloom_;
+}
+
+void NameIndex::itemsReset()
+{
+    rebuild();
+}
+
+void NameIndex::repositoryChanged()
+{
+    flushRemovals();
+    if (staleInBloom_ > bloomCapacity_ / 2) rebuildBloom();
+}
@@ -0,0 +1,264 @@
+#include "NearDuplicateFinder.h"
+#include "ArtObject.h"
+#include "TaskScheduler.h"
+#include "Mix64.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace {
+
+constexpr std::size_t kShingle = 4;
+constexpr std::size_t kGrain   = 4096;   // records per parallel slice
+
+// Candidates whose estimated similarity is this far below the threshold
+// are dropped without rebuilding their shingles (about 3.5 standard
+// deviations of a 64-value estimate)
+constexpr double kEstimateMargin = 0.2;
+
+std::uint64_t fnv1a(const char* data, std::size_t size) noexcept
+{
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// Lowercase ASCII, any run of ASCII punctuation/space becomes one space;
+// UTF-8 bytes are kept as they are
+std::string normalizeText(const std::string& name, const std::string& description)
+{
+    std::string out;
+    out.reserve(name.size() + description.size() + 1);
+    bool space = true;
+    auto append = [&](const std::string& s) {
+        for (char ch : s) {
+            const auto c = static_cast<unsigned char>(ch);
+            if (c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')) {
+                out += ch;
+                space = false;
+            } else if (c >= 'A' && c <= 'Z') {
+                out += static_cast<char>(c - 'A' + 'a');
+                space = false;
+            } else if (!space) {
+                out += ' ';
+                space = true;
+            }
+        }
+        if (!space) {
+            out += ' ';
+            space = true;
+        }
+    };
+    append(name);
+    append(description);
+    if (!out.empty()) out.pop_back();
+    return out;
+}
+
+// Multiply-shift family: hash i of x is the top half of a_i*x + b_i
+struct Permutations {
+    explicit Permutations(int count) {
+        for (int i = 0; i < count; ++i) {
+            a.push_back(mix64(2 * i + 1) | 1);
+            b.push_back(mix64(2 * i + 2));
+        }
+    }
+    std::vector<std::uint64_t> a, b;
+};
+
+const Permutations& permutations(int count)
+{
+    static std::mutex mutex;
+    static std::vector<std::unique_ptr<Permutations>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& p : cache) if (int(p->a.size()) == count) return *p;
+    cache.push_back(std::make_unique<Permutations>(count));
+    return *cache.back();
+}
+
+struct BandEntry {
+    std::uint32_t key;
+    std::uint32_t record;
+    bool operator<(const BandEntry& o) const noexcept {
+        return key != o.key ? key < o.key : record < o.record;
+    }
+};
+
+std::uint64_t pairKey(std::uint32_t a, std::uint32_t b) noexcept
+{
+    if (a > b) std::swap(a, b);
+    return (std::uint64_t(a) << 32) | b;
+}
+
+} // namespace
+
+// ── Building blocks ──
+std::vector<std::uint64_t> NearDuplicateFinder::shingles(const ArtObject& art)
+{
+    const std::string text = normalizeText(art.getName(), art.getDescription());
+    std::vector<std::uint64_t> out;
+    if (text.empty()) return out;
+    if (text.size() <= kShingle) {
+        out.push_back(mix64(fnv1a(text.data(), text.size())));
+        return out;
+    }
+    out.reserve(text.size() - kShingle + 1);
+    for (std::size_t i = 0; i + kShingle <= text.size(); ++i) {
+        out.push_back(mix64(fnv1a(text.data() + i, kShingle)));
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+std::vector<std::uint32_t> NearDuplicateFinder::signature(const std::vector<std::uint64_t>& shingles,
+                                                          int hashes)
+{
+    const Permutations& p = permutations(hashes);
+    std::vector<std::uint32_t> sig(hashes, std::numeric_limits<std::uint32_t>::max());
+    for (std::uint64_t x : shingles) {
+        for (int i = 0; i < hashes; ++i) {
+            const auto h = static_cast<std::uint32_t>((p.a[i] * x + p.b[i]) >> 32);
+            if (h < sig[i]) sig[i] = h;
+        }
+    }
+    return sig;
+}
+
+double NearDuplicateFinder::jaccard(const std::vector<std::uint64_t>& a,
+                                    const std::vector<std::uint64_t>& b) noexcept
+{
+    if (a.empty() && b.empty()) return 1.0;
+    std::size_t common = 0, i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (a[i] < b[j])      ++i;
+        else if (b[j] < a[i]) ++j;
+        else { ++common; ++i; ++j; }
+    }
+    return double(common) / double(a.size() + b.size() - common);
+}
+
+// ── Search ──
+std::vector<NearDuplicate> NearDuplicateFinder::find(const ArtSnapshot& items,
+                                                     const Options& options,
+                                                     const std::atomic_bool* cancelled)
+{
+    using Priority = TaskScheduler::Priority;
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    auto stop = [cancelled]() { return cancelled && cancelled->load(); };
+
+    const std::size_t n = std::min<std::size_t>(items.size(),
+                                                std::numeric_limits<std::uint32_t>::max());
+    const int bands = std::max(1, options.bands);
+    const int rows  = std::max(1, options.rows);
+
+    // Only the low byte of each minimum is kept ("b-bit MinHash"): two
+    // unrelated values still agree 1 time in 256, which is corrected
+    // for in the estimate, and a band of 4 rows is one 32-bit key
+    const int hashes = bands * rows;
+    std::vector<std::uint8_t> sigs(n * hashes);
+    std::vector<char> hasText(n, 0);
+
+    // 1) Signatures
+    scheduler.parallelFor(Priority::IndexBuild, n, kGrain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t r = begin; r < end && !stop(); ++r) {
+            const auto& art = items.at(r);
+            if (!art) continue;
+            const auto sh = shingles(*art);
+            if (sh.empty()) continue;
+            const auto sig = signature(sh, hashes);
+            for (int i = 0; i < hashes; ++i) sigs[r * hashes + i] = std::uint8_t(sig[i]);
+            hasText[r] = 1;
+        }
+    });
+    if (stop()) return {};
+
+    auto bandKey = [&](std::size_t r, std::size_t b) {
+        const std::uint8_t* v = &sigs[r * hashes + b * rows];
+        std::uint64_t h = 0;
+        for (int i = 0; i < rows; ++i) h = (h << 8) | v[i];
+        return rows <= 4 ? std::uint32_t(h) : std::uint32_t(mix64(h));
+    };
+
+    // 2) Buckets per band: sort (key, record) and pair up equal keys
+    std::vector<std::vector<std::uint64_t>> bandPairs(bands);
+    const std::size_t maxBucket = std::max<std::size_t>(2, options.maxBucket);
+    scheduler.parallelFor(Priority::IndexBuild, bands, 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t b = begin; b < end && !stop(); ++b) {
+            std::vector<BandEntry> entries;
+            entries.reserve(n);
+            for (std::size_t r = 0; r < n; ++r) {
+                if (hasText[r]) entries.push_back({bandKey(r, b), static_cast<std::uint32_t>(r)});
+            }
+            std::sort(entries.begin(), entries.end());
+
+            auto& out = bandPairs[b];
+            for (std::size_t i = 0; i < entries.size(); ) {
+                std::size_t j = i + 1;
+                while (j < entries.size() && entries[j].key == entries[i].key) ++j;
+                for (std::size_t x = i; x < j; ++x) {
+                    const std::size_t last = std::min(j, x + maxBucket);
+                    for (std::size_t y = x + 1; y < last; ++y) {
+                        out.push_back(pairKey(entries[x].record, entries[y].record));
+                    }
+                }
+                i = j;
+            }
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        }
+    });
+    if (stop()) return {};
+
+    std::vector<std::uint64_t> candidates;
+    for (auto& pairs : bandPairs) {
+        candidates.insert(candidates.end(), pairs.begin(), pairs.end());
+        pairs = std::vector<std::uint64_t>();
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // 3) Verify candidates on their exact shingle sets
+    std::vector<NearDuplicate> found;
+    std::mutex foundMutex;
+    scheduler.parallelFor(Priority::IndexBuild, candidates.size(), kGrain,
+                          [&](std::size_t begin, std::size_t end) {
+        std::vector<NearDuplicate> local;
+        // Candidates are sorted by first record: reuse its shingles
+        std::size_t cachedFor = std::numeric_limits<std::size_t>::max();
+        std::vector<std::uint64_t> cached;
+        for (std::size_t c = begin; c < end && !stop(); ++c) {
+            const std::size_t a = candidates[c] >> 32;
+            const std::size_t b = candidates[c] & 0xffffffffu;
+            const auto& artA = items.at(a);
+            const auto& artB = items.at(b);
+            std::size_t agree = 0;
+            for (int i = 0; i < hashes; ++i) {
+                agree += sigs[a * hashes + i] == sigs[b * hashes + i];
+            }
+            const double estimate = (double(agree) / hashes - 1.0 / 256) / (1.0 - 1.0 / 256);
+            if (estimate < options.threshold - kEstimateMargin) continue;
+            if (artA->getType() != artB->getType()) continue;
+            if (a != cachedFor) {
+                cached = shingles(*artA);
+                cachedFor = a;
+            }
+            const double similarity = jaccard(cached, shingles(*artB));
+            if (similarity >= options.threshold) local.push_back({a, b, similarity});
+        }
+        std::lock_guard<std::mutex> lock(foundMutex);
+        found.insert(found.end(), local.begin(), local.end());
+    });
+
+    std::sort(found.begin(), found.end(), [](const NearDuplicate& x, const NearDuplicate& y) {
+        if (x.similarity != y.similarity) return x.similarity > y.similarity;
+        return x.first != y.first ? x.first < y.first : x.second < y.second;
+    });
+    return found;
+}
@@ -27,3 +27,7 @@ void Painting::setCanvasType(const std::string& canvasType) {
 std::string Painting::getType() const noexcept {
     return "Painting";
 }
+
+std::shared_ptr<ArtObject> Painting::clone() const {
+    return std::make_shared<Painting>(*this);
+}
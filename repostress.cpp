@@ -0,0 +1,146 @@
+// repo_stress: read throughput of ConcurrentArtRepository snapshots while
+// a writer keeps editing, for 1, 2, 4, ... reader threads.
+//
+//   repo_stress [items] [milliseconds per step]
+//
+// Each reader repeatedly takes a snapshot and scans a 4096-item window of
+// it (reading names and prices). The writer stands in for the GUI thread:
+// it updates, appends and removes records as fast as it can, and its
+// latency per mutation is reported alongside, since readers must never
+// make the writer wait.
+
+#include "ConcurrentArtRepository.h"
+#include "Painting.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kWindow = 4096;
+
+struct StepResult {
+    double itemsPerSec  = 0;
+    double writesPerSec = 0;
+    double writeP50us   = 0;
+    double writeP99us   = 0;
+};
+
+StepResult runStep(ConcurrentArtRepository& repo, unsigned readers, int millis)
+{
+    std::atomic_bool go{false}, stop{false};
+    std::vector<unsigned long long> scanned(readers, 0);
+    std::vector<std::thread> threads;
+
+    for (unsigned r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            std::mt19937_64 rng(r + 1);
+            unsigned long long items = 0;
+            double sink = 0;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            while (!stop.load(std::memory_order_relaxed)) {
+                ArtSnapshotPtr snap = repo.snapshot();
+                const std::size_t n = snap->size();
+                if (n == 0) continue;
+                const std::size_t first = rng() % n;
+                const std::size_t last  = std::min(n, first + kWindow);
+                for (std::size_t i = first; i < last; ++i) {
+                    const auto& art = snap->at(i);
+                    sink += art->getPrice() + static_cast<double>(art->getName().size());
+                }
+                items += last - first;
+            }
+            scanned[r] = items + (sink < 0 ? 1 : 0);   // keep the loop alive
+        });
+    }
+
+    // Writer: a mix of edits, appends and removals, timing each one
+    std::vector<double> latencies;
+    latencies.reserve(1 << 20);
+    std::mt19937_64 rng(42);
+    auto proto = std::make_shared<Painting>("new", "written by the stress writer",
+                                            1.0, "Storage", "Canvas", "");
+
+    go.store(true, std::memory_order_release);
+    const auto start = Clock::now();
+    const auto deadline = start + std::chrono::milliseconds(millis);
+    while (Clock::now() < deadline) {
+        const std::size_t n = repo.size();
+        const int op = static_cast<int>(rng() % 8);
+        const auto t0 = Clock::now();
+        if (op < 6 && n > 0) {
+            const std::size_t i = rng() % n;
+            auto art = repo.get(i)->clone();
+            art->setPrice(art->getPrice() + 1.0);
+            repo.update(i, art);
+        } else if (op == 6 || n == 0) {
+            repo.add(proto->clone());
+        } else {
+            repo.remove(n - 1 - rng() % std::min<std::size_t>(n, 64));
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    stop.store(true);
+    for (auto& t : threads) t.join();
+
+    StepResult result;
+    unsigned long long total = 0;
+    for (auto items : scanned) total += items;
+    result.itemsPerSec  = total / seconds;
+    result.writesPerSec = latencies.size() / seconds;
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        result.writeP50us = latencies[latencies.size() / 2];
+        result.writeP99us = latencies[latencies.size() * 99 / 100];
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::size_t items = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const int millis = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    ConcurrentArtRepository repo;
+    std::vector<std::shared_ptr<ArtObject>> batch;
+    batch.reserve(items);
+    for (std::size_t i = 0; i < items; ++i) {
+        batch.push_back(std::make_shared<Painting>(
+            "Work " + std::to_string(i), "stress", double(i % 1000),
+            "Room " + std::to_string(i % 50), "Canvas", ""));
+    }
+    repo.addMany(batch);
+    batch.clear();
+
+    std::printf("%zu items, %d ms per step, %u hardware threads\n", items, millis, cores);
+    std::printf("%8s %16s %9s %12s %12s %12s\n",
+                "readers", "items read/s", "speedup", "writes/s", "write p50us", "write p99us");
+
+    // Powers of two below 'cores', then 'cores' itself
+    std::vector<unsigned> steps;
+    for (unsigned readers = 1; readers < cores; readers *= 2) steps.push_back(readers);
+    steps.push_back(cores);
+
+    double base = 0;
+    for (const unsigned readers : steps) {
+        const StepResult r = runStep(repo, readers, millis);
+        if (base == 0) base = r.itemsPerSec;
+        std::printf("%8u %16.0f %8.2fx %12.0f %12.2f %12.2f\n",
+                    readers, r.itemsPerSec, r.itemsPerSec / base,
+                    r.writesPerSec, r.writeP50us, r.writeP99us);
+    }
+    return 0;
+}
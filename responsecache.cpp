@@ -0,0 +1,172 @@
+#include "ResponseCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+namespace {
+
+QString normalized(const std::string& text, bool foldCase)
+{
+    const QString s = QString::fromStdString(text)
+                          .normalized(QString::NormalizationForm_C)
+                          .simplified();
+    return foldCase ? s.toCaseFolded() : s;
+}
+
+// Length-prefixed, so no two message lists hash the same input
+void appendField(QByteArray& out, const QByteArray& field)
+{
+    out += QByteArray::number(field.size());
+    out += ':';
+    out += field;
+}
+
+bool isKey(const QString& name)
+{
+    if (name.size() != 64) return false;
+    for (QChar c : name) {
+        const auto u = c.unicode();
+        if (!((u >= '0' && u <= '9') || (u >= 'a' && u <= 'f'))) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ResponseCache::ResponseCache(const QString& dirPath, qint64 maxBytes, qint64 maxAgeSeconds)
+    : dir_(dirPath), maxBytes_(maxBytes), maxAgeMs_(maxAgeSeconds * 1000)
+{
+    if (!QDir().mkpath(dir_)) {
+        qWarning() << "[ResponseCache] cannot create" << dir_;
+        return;
+    }
+    scan();
+}
+
+QString ResponseCache::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/chat";
+}
+
+// ── Keys ──
+QByteArray ResponseCache::key(const QUrl& endpoint, const QString& model,
+                              const std::vector<ChatMessage>& messages)
+{
+    QByteArray input("chat-v1");
+    appendField(input, endpoint.toString(QUrl::RemoveUserInfo).toUtf8());
+    appendField(input, model.toUtf8());
+    for (const ChatMessage& m : messages) {
+        appendField(input, QByteArray::fromStdString(m.role));
+        appendField(input, normalized(m.content, m.role == "user").toUtf8());
+    }
+    return QCryptographicHash::hash(input, QCryptographicHash::Sha256).toHex();
+}
+
+QString ResponseCache::pathFor(const QByteArray& key) const
+{
+    return dir_ + '/' + QString::fromLatin1(key) + ".txt";
+}
+
+// ── Lookup / insert ──
+bool ResponseCache::lookup(const QByteArray& key, QString* text)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return false;
+    }
+    if (now - it->stored > maxAgeMs_) {
+        remove(key);
+        ++stats_.evicted;
+        ++stats_.misses;
+        return false;
+    }
+
+    QFile file(pathFor(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        remove(key);   // deleted behind our back
+        ++stats_.misses;
+        return false;
+    }
+    if (text) *text = QString::fromUtf8(file.readAll());
+    it->used = ++useClock_;
+    ++stats_.hits;
+    return true;
+}
+
+void ResponseCache::insert(const QByteArray& key, const QString& text)
+{
+    const QByteArray data = text.toUtf8();
+    if (data.isEmpty() || data.size() > maxBytes_) return;
+
+    QSaveFile file(pathFor(key));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "[ResponseCache] cannot write" << file.fileName();
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto old = index_.find(key);
+    if (old != index_.end()) bytes_ -= old->size;
+    Entry e;
+    e.size   = data.size();
+    e.stored = now;
+    e.used   = ++useClock_;
+    index_.insert(key, e);
+    bytes_ += e.size;
+    evict();
+}
+
+// ── Files ──
+void ResponseCache::scan()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    // Oldest first, so they are also the first to be evicted
+    const QFileInfoList files = QDir(dir_).entryInfoList({"*.txt"}, QDir::Files,
+                                                         QDir::Time | QDir::Reversed);
+    for (const QFileInfo& info : files) {
+        if (!isKey(info.completeBaseName())) continue;
+        const qint64 stored = info.lastModified().toMSecsSinceEpoch();
+        if (now - stored > maxAgeMs_) {
+            QFile::remove(info.filePath());
+            ++stats_.evicted;
+            continue;
+        }
+        Entry e;
+        e.size   = info.size();
+        e.stored = stored;
+        e.used   = ++useClock_;
+        index_.insert(info.completeBaseName().toLatin1(), e);
+        bytes_ += e.size;
+    }
+    evict();
+}
+
+void ResponseCache::remove(const QByteArray& key)
+{
+    auto it = index_.find(key);
+    if (it == index_.end()) return;
+    QFile::remove(pathFor(key));
+    bytes_ -= it->size;
+    index_.erase(it);
+}
+
+void ResponseCache::evict()
+{
+    while (bytes_ > maxBytes_ && !index_.isEmpty()) {
+        auto victim = index_.begin();
+        for (auto it = index_.begin(); it != index_.end(); ++it) {
+            if (it->used < victim->used) victim = it;
+        }
+        const QByteArray key = victim.key();
+        remove(key);
+        ++stats_.evicted;
+    }
+}
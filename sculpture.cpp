@@ -28,3 +28,7 @@ void Sculpture::setMaterial(const std::string& material) {
 std::string Sculpture::getType() const noexcept {
     return "Sculpture";
 }
+
+std::shared_ptr<ArtObject> Sculpture::clone() const {
+    return std::make_shared<Sculpture>(*this);
+}
@@ -0,0 +1,121 @@
+#include "SearchEngine.h"
+#include "ArtObject.h"
+
+#include <QElapsedTimer>
+#include <QMetaObject>
+
+namespace {
+// Report at least this often while scanning, so the first matches
+// reach the view within a frame or two.
+constexpr qint64      kChunkMs      = 16;
+constexpr std::size_t kCheckEvery   = 1024;   // records between clock/cancel checks
+}
+
+// ── SearchQuery ──
+int SearchQuery::rank(const ArtObject& art) const
+{
+    switch (mode) {
+    case Mode::All:
+        return 0;
+    case Mode::Price: {
+        double p = art.getPrice();
+        return (above ? p >= price : p <= price) ? 0 : -1;
+    }
+    case Mode::Name: {
+        QString name = QString::fromStdString(art.getName());
+        if (name.compare(text, Qt::CaseInsensitive) == 0) return skipExact ? -1 : 0;
+        if (name.startsWith(text, Qt::CaseInsensitive))   return 1;
+        if (name.contains(text, Qt::CaseInsensitive))     return 2;
+        return -1;
+    }
+    }
+    return -1;
+}
+
+// ── SearchEngine ──
+SearchEngine::SearchEngine(QObject* parent)
+    : QObject(parent)
+{
+}
+
+SearchEngine::~SearchEngine()
+{
+    cancel();
+    tasks_.cancel();
+    tasks_.wait();
+}
+
+quint64 SearchEngine::start(const SearchQuery& query, ArtSnapshotPtr snapshot)
+{
+    cancel();
+    tasks_.cancel();   // drop scans of older queries that never started
+
+    query_ = query;
+    query_.text = query.text.trimmed();
+    token_ = std::make_shared<std::atomic_bool>(false);
+    ++id_;
+    pending_ = 0;
+
+    submit(std::move(snapshot), 0, query_);
+    return id_;
+}
+
+void SearchEngine::extend(ArtSnapshotPtr records, std::size_t baseIndex)
+{
+    if (!token_ || token_->load()) return;
+    SearchQuery query = query_;
+    query.skipExact = false;
+    submit(std::move(records), baseIndex, query);
+}
+
+void SearchEngine::cancel()
+{
+    if (token_) token_->store(true);
+}
+
+quint64 SearchEngine::currentId() const noexcept
+{
+    return id_;
+}
+
+void SearchEngine::submit(ArtSnapshotPtr records, std::size_t baseIndex,
+                          const SearchQuery& query)
+{
+    ++pending_;
+    const quint64     id    = id_;
+    const Token       token = token_;
+
+    tasks_.submit(TaskScheduler::Priority::Interactive,
+                  [this, id, token, query, records, baseIndex]() {
+        auto report = [this, id, token](std::vector<SearchHit>&& hits, bool last) {
+            auto shared = std::make_shared<std::vector<SearchHit>>(std::move(hits));
+            QMetaObject::invokeMethod(this, [this, id, token, shared, last]() {
+                if (token->load() || id != id_) return;
+                if (!shared->empty()) emit resultsReady(id, *shared);
+                if (last && --pending_ == 0) emit finished(id);
+            }, Qt::QueuedConnection);
+        };
+
+        std::vector<SearchHit> hits;
+        QElapsedTimer clock;
+        clock.start();
+
+        const std::size_t n = records ? records->size() : 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % kCheckEvery == 0 && i > 0) {
+                if (token->load()) return;
+                if (!hits.empty() && clock.elapsed() >= kChunkMs) {
+                    report(std::move(hits), false);
+                    hits = {};
+                    clock.restart();
+                }
+            }
+            const auto& art = records->at(i);
+            if (!art) continue;
+            const int r = query.rank(*art);
+            if (r >= 0) hits.push_back({baseIndex + i, r});
+        }
+        if (token->load()) return;
+        report(std::move(hits), true);
+    }, token);
+}
@@ -0,0 +1,544 @@
+#include "SimilarityIndex.h"
+#include "ArtObject.h"
+#include "Painting.h"
+#include "Sculpture.h"
+#include "DigitalArt.h"
+#include "TaskScheduler.h"
+#include "Mix64.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SIMILARITY_SSE2 1
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define SIMILARITY_AVX2 1   // built alongside, picked at run time
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SIMILARITY_NEON 1
+#endif
+
+namespace {
+
+constexpr std::size_t kQueryGrain  = 16384;   // records per parallel slice
+constexpr std::size_t kEncodeGrain = 4096;
+constexpr std::size_t kBlock       = 256;     // rows per kernel call
+
+std::uint64_t termHash(const std::string& term) noexcept
+{
+    return mix64(std::hash<std::string>{}(term));
+}
+
+// Distinct term hashes of a record with their counts
+std::vector<std::pair<std::uint64_t, int>> termCounts(const ArtObject& art)
+{
+    std::vector<std::uint64_t> hashes;
+    for (const auto& term : SimilarityIndex::terms(art)) hashes.push_back(termHash(term));
+    std::sort(hashes.begin(), hashes.end());
+    std::vector<std::pair<std::uint64_t, int>> counts;
+    for (std::uint64_t h : hashes) {
+        if (!counts.empty() && counts.back().first == h) ++counts.back().second;
+        else counts.emplace_back(h, 1);
+    }
+    return counts;
+}
+
+void appendWords(const std::string& text, int weight, std::vector<std::string>& out)
+{
+    std::string word;
+    auto flush = [&]() {
+        if (word.size() >= 2) {
+            for (int i = 0; i < weight; ++i) out.push_back(word);
+        }
+        word.clear();
+    };
+    for (char ch : text) {
+        const auto c = static_cast<unsigned char>(ch);
+        if (c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')) word += ch;
+        else if (c >= 'A' && c <= 'Z') word += static_cast<char>(c - 'A' + 'a');
+        else flush();
+    }
+    flush();
+}
+
+float logPrice(const ArtObject* art) noexcept
+{
+    const double price = art ? art->getPrice() : 0.0;
+    return std::isfinite(price) && price > 0 ? float(std::log1p(price)) : 0.0f;
+}
+
+float signedWeight(std::uint64_t hash, int count, float df, float documents) noexcept
+{
+    const float idf = std::log((1.0f + documents) / (1.0f + df)) + 1.0f;
+    const float weight = (1.0f + std::log(float(count))) * idf;
+    // Signed hashing: collisions cancel out on average
+    return (hash >> 63) ? -weight : weight;
+}
+
+// Quantize to [-127, 127]; the returned scale folds in the normalization
+float quantize(const float* values, std::int8_t* out) noexcept
+{
+    constexpr std::size_t dims = SimilarityIndex::kDims;
+    float norm = 0.0f, peak = 0.0f;
+    for (std::size_t i = 0; i < dims; ++i) {
+        norm += values[i] * values[i];
+        peak = std::max(peak, std::fabs(values[i]));
+    }
+    if (norm == 0.0f) {
+        std::fill(out, out + dims, std::int8_t(0));
+        return 0.0f;
+    }
+    const float toInt = 127.0f / peak;
+    for (std::size_t i = 0; i < dims; ++i) {
+        out[i] = static_cast<std::int8_t>(std::lround(values[i] * toInt));
+    }
+    return 1.0f / (toInt * std::sqrt(norm));
+}
+
+// Min-heap on score: the front is the weakest of the best k so far
+bool weaker(const SimilarHit& a, const SimilarHit& b) noexcept
+{
+    return a.score != b.score ? a.score > b.score : a.index < b.index;
+}
+
+} // namespace
+
+SimilarityIndex::SimilarityIndex(std::shared_ptr<ArtRepositoryInterface> repo)
+    : repo_(std::move(repo))
+{
+    rebuild();
+    repo_->addObserver(this);
+}
+
+SimilarityIndex::~SimilarityIndex()
+{
+    repo_->removeObserver(this);
+}
+
+// ── Building blocks ──
+std::vector<std::string> SimilarityIndex::terms(const ArtObject& art)
+{
+    std::vector<std::string> out;
+    appendWords(art.getName(), 2, out);
+    appendWords(art.getDescription(), 1, out);
+    if (auto p = dynamic_cast<const Painting*>(&art))        appendWords(p->getCanvasType(), 1, out);
+    else if (auto s = dynamic_cast<const Sculpture*>(&art))  appendWords(s->getMaterial(), 1, out);
+    else if (auto d = dynamic_cast<const DigitalArt*>(&art)) appendWords(d->getSoftware(), 1, out);
+    return out;
+}
+
+ArtKind SimilarityIndex::kindOf(const ArtObject& art) noexcept
+{
+    if (dynamic_cast<const Painting*>(&art))   return ArtKind::Painting;
+    if (dynamic_cast<const Sculpture*>(&art))  return ArtKind::Sculpture;
+    if (dynamic_cast<const DigitalArt*>(&art)) return ArtKind::DigitalArt;
+    return ArtKind::Other;
+}
+
+namespace {
+
+// Dot products of 'query' with 'count' consecutive rows of 'dims' values
+using DotKernel = void (*)(const std::int8_t* query, const std::int8_t* rows,
+                           std::size_t count, std::size_t dims, std::int32_t* out);
+
+void dotBaseline(const std::int8_t* query, const std::int8_t* rows,
+                 std::size_t count, std::size_t dims, std::int32_t* out) noexcept
+{
+    for (std::size_t r = 0; r < count; ++r) {
+        const std::int8_t* row = rows + r * dims;
+        std::size_t i = 0;
+        std::int32_t sum = 0;
+#if defined(SIMILARITY_SSE2)
+        // Sign-extend 16 bytes to two halves of int16, multiply-add pairs
+        // into int32 lanes
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc = zero;
+        for (; i + 16 <= dims; i += 16) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(query + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            const __m128i sa = _mm_cmpgt_epi8(zero, va);
+            const __m128i sb = _mm_cmpgt_epi8(zero, vb);
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(va, sa),
+                                                    _mm_unpacklo_epi8(vb, sb)));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(va, sa),
+                                                    _mm_unpackhi_epi8(vb, sb)));
+        }
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum = _mm_cvtsi128_si32(acc);
+#elif defined(SIMILARITY_NEON)
+        int32x4_t acc = vdupq_n_s32(0);
+        for (; i + 16 <= dims; i += 16) {
+            const int8x16_t va = vld1q_s8(query + i);
+            const int8x16_t vb = vld1q_s8(row + i);
+            acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(va), vget_low_s8(vb)));
+            acc = vpadalq_s16(acc, vmull_s8(vget_high_s8(va), vget_high_s8(vb)));
+        }
+        sum = vaddvq_s32(acc);
+#endif
+        for (; i < dims; ++i) sum += std::int32_t(query[i]) * row[i];
+        out[r] = sum;
+    }
+}
+
+#if defined(SIMILARITY_AVX2)
+__attribute__((target("avx2")))
+void dotAvx2(const std::int8_t* query, const std::int8_t* rows,
+             std::size_t count, std::size_t dims, std::int32_t* out) noexcept
+{
+    if (dims != SimilarityIndex::kDims) return dotBaseline(query, rows, count, dims, out);
+
+    // The query stays in registers, sign-extended once
+    constexpr std::size_t kSteps = SimilarityIndex::kDims / 16;
+    __m256i q[kSteps];
+    for (std::size_t s = 0; s < kSteps; ++s) {
+        q[s] = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(query + 16 * s)));
+    }
+    for (std::size_t r = 0; r < count; ++r) {
+        const std::int8_t* row = rows + r * dims;
+        __m256i acc = _mm256_setzero_si256();
+        for (std::size_t s = 0; s < kSteps; ++s) {
+            const __m256i v = _mm256_cvtepi8_epi16(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 16 * s)));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(q[s], v));
+        }
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        out[r] = _mm_cvtsi128_si32(sum);
+    }
+}
+#endif
+
+DotKernel dotKernel() noexcept
+{
+#if defined(SIMILARITY_AVX2)
+    static const DotKernel kernel = __builtin_cpu_supports("avx2") ? &dotAvx2 : &dotBaseline;
+    return kernel;
+#else
+    return &dotBaseline;
+#endif
+}
+
+} // namespace
+
+std::int32_t SimilarityIndex::dot(const std::int8_t* a, const std::int8_t* b,
+                                  std::size_t n) noexcept
+{
+    std::int32_t out = 0;
+    dotKernel()(a, b, 1, n, &out);
+    return out;
+}
+
+// ── Query ──
+std::vector<SimilarHit> SimilarityIndex::scan(const std::int8_t* query, float queryScale,
+                                              float queryPrice, float priceWeight,
+                                              const SimilarityFilter* filter,
+                                              std::size_t skip, std::size_t k) const
+{
+    const std::size_t n = size();
+    const DotKernel kernel = dotKernel();
+    const float cosineWeight = queryScale * (1.0f - priceWeight);
+
+    // Filters become a bit mask and a lookup table for the inner loop
+    unsigned kindMask = ~0u;
+    std::vector<char> locationWanted;
+    float minPrice = 0.0f, maxPrice = std::numeric_limits<float>::infinity();
+    if (filter) {
+        if (!filter->kinds.empty()) {
+            kindMask = 0;
+            for (ArtKind kind : filter->kinds) kindMask |= 1u << unsigned(kind);
+        }
+        if (!filter->locations.empty()) {
+            locationWanted.assign(locationNames_.size(), 0);
+            for (std::uint32_t id : filter->locations) {
+                if (id < locationWanted.size()) locationWanted[id] = 1;
+            }
+        }
+        minPrice = float(filter->minPrice);
+        maxPrice = float(filter->maxPrice);
+    }
+    auto passes = [&](std::size_t r) {
+        return ((kindMask >> unsigned(kinds_[r])) & 1u)
+            && (locationWanted.empty() || locationWanted[locations_[r]])
+            && prices_[r] >= minPrice && prices_[r] <= maxPrice;
+    };
+    const bool filtered = filter && !filter->empty();
+
+    std::vector<SimilarHit> best;
+    std::mutex bestMutex;
+    TaskScheduler::instance().parallelFor(
+        TaskScheduler::Priority::Interactive, n, kQueryGrain,
+        [&](std::size_t begin, std::size_t end) {
+            std::vector<SimilarHit> heap;
+            heap.reserve(k + 1);
+            std::int32_t dots[kBlock];
+            for (std::size_t block = begin; block < end; block += kBlock) {
+                const std::size_t count = std::min(kBlock, end - block);
+                kernel(query, &vectors_[block * kDims], count, kDims, dots);
+                for (std::size_t j = 0; j < count; ++j) {
+                    const std::size_t r = block + j;
+                    if (r == skip || (filtered && !passes(r))) continue;
+                    float score = cosineWeight * scales_[r] * float(dots[j]);
+                    if (priceWeight > 0.0f) {
+                        score += priceWeight / (1.0f + std::fabs(queryPrice - logPrices_[r]));
+                    }
+                    if (heap.size() < k) {
+                        heap.push_back({r, score});
+                        std::push_heap(heap.begin(), heap.end(), weaker);
+                    } else if (score > heap.front().score) {
+                        std::pop_heap(heap.begin(), heap.end(), weaker);
+                        heap.back() = {r, score};
+                        std::push_heap(heap.begin(), heap.end(), weaker);
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(bestMutex);
+            best.insert(best.end(), heap.begin(), heap.end());
+        });
+
+    std::sort(best.begin(), best.end(), weaker);
+    if (best.size() > k) best.resize(k);
+    return best;
+}
+
+std::vector<SimilarHit> SimilarityIndex::similar(std::size_t index, std::size_t k) const
+{
+    if (index >= size() || k == 0) return {};
+    return scan(&vectors_[index * kDims], scales_[index], logPrices_[index], kPriceWeight,
+                nullptr, index, k);
+}
+
+std::vector<SimilarHit> SimilarityIndex::search(const std::string& text,
+                                                const SimilarityFilter& filter,
+                                                std::size_t k) const
+{
+    if (k == 0) return {};
+
+    // Same weighting as a record, minus the words no record has
+    float values[kDims] = {};
+    std::vector<std::string> words;
+    appendWords(text, 1, words);
+    std::vector<std::pair<std::uint64_t, int>> counts;
+    {
+        std::vector<std::uint64_t> hashes;
+        for (const auto& word : words) hashes.push_back(termHash(word));
+        std::sort(hashes.begin(), hashes.end());
+        for (std::uint64_t h : hashes) {
+            if (!counts.empty() && counts.back().first == h) ++counts.back().second;
+            else counts.emplace_back(h, 1);
+        }
+    }
+    for (const auto& entry : counts) {
+        auto it = documentFrequency_.find(entry.first);
+        if (it == documentFrequency_.end()) continue;
+        values[entry.first % kDims] += signedWeight(entry.first, entry.second,
+                                                    float(it->second), float(documents_));
+    }
+    std::int8_t query[kDims];
+    const float scale = quantize(values, query);
+    return scan(query, scale, 0.0f, 0.0f, &filter, std::size_t(-1), k);
+}
+
+std::vector<std::uint32_t> SimilarityIndex::locationsIn(const std::string& text) const
+{
+    std::vector<std::string> queryWords;
+    appendWords(text, 1, queryWords);
+    std::sort(queryWords.begin(), queryWords.end());
+    auto mentioned = [&](const std::string& word) {
+        return std::binary_search(queryWords.begin(), queryWords.end(), word);
+    };
+
+    // Words that are part of many names but name no place by themselves
+    static const char* const kGeneric[] = {
+        "museum", "gallery", "galerie", "collection", "private", "foundation", "institute",
+        "national", "modern", "contemporary", "house", "hall", "centre", "center", "storage",
+        "studio", "city", "street", "room", "wing", "floor", "north", "south", "east", "west"};
+    auto generic = [](const std::string& w) {
+        return std::any_of(std::begin(kGeneric), std::end(kGeneric),
+                           [&](const char* g) { return w == g; });
+    };
+    std::vector<std::vector<std::string>> wordsOf(locationNames_.size());
+    for (std::size_t id = 0; id < locationNames_.size(); ++id) {
+        appendWords(locationNames_[id], 1, wordsOf[id]);
+    }
+
+    std::vector<std::uint32_t> out;
+    for (std::size_t id = 0; id < locationNames_.size(); ++id) {
+        const auto& words = wordsOf[id];
+        if (words.empty()) continue;
+        const bool whole = std::all_of(words.begin(), words.end(), mentioned);
+        const bool distinctive = std::any_of(words.begin(), words.end(), [&](const std::string& w) {
+            return w.size() >= 4 && !generic(w) && mentioned(w);
+        });
+        if (whole || distinctive) out.push_back(std::uint32_t(id));
+    }
+    return out;
+}
+
+// ── Maintenance ──
+void SimilarityIndex::countTerms(const ArtObject& art, int delta)
+{
+    for (const auto& entry : termCounts(art)) {
+        auto it = documentFrequency_.try_emplace(entry.first, 0).first;
+        if (delta > 0) {
+            it->second += delta;
+        } else {
+            it->second -= std::min<std::uint32_t>(it->second, -delta);
+            if (it->second == 0) documentFrequency_.erase(it);
+        }
+    }
+}
+
+void SimilarityIndex::encode(std::size_t index, const ArtObject* art)
+{
+    float values[kDims] = {};
+    if (art) {
+        const float documents = float(documents_);
+        for (const auto& entry : termCounts(*art)) {
+            auto it = documentFrequency_.find(entry.first);
+            const float df = it != documentFrequency_.end() ? float(it->second) : 0.0f;
+            values[entry.first % kDims] += signedWeight(entry.first, entry.second, df, documents);
+        }
+    }
+    scales_[index] = quantize(values, &vectors_[index * kDims]);
+}
+
+void SimilarityIndex::setAttributes(std::size_t index, const ArtObject* art)
+{
+    logPrices_[index] = logPrice(art);
+    prices_[index] = art ? float(art->getPrice()) : 0.0f;
+    kinds_[index] = art ? kindOf(*art) : ArtKind::Other;
+
+    std::string location;
+    if (art) {
+        for (char ch : art->getLocation()) {
+            const auto c = static_cast<unsigned char>(ch);
+            location += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : ch;
+        }
+    }
+    auto it = locationIds_.find(location);
+    if (it == locationIds_.end()) {
+        it = locationIds_.emplace(location, std::uint32_t(locationNames_.size())).first;
+        locationNames_.push_back(location);
+    }
+    locations_[index] = it->second;
+}
+
+void SimilarityIndex::rebuild()
+{
+    documentFrequency_.clear();
+    pendingRemovals_.clear();
+    const ArtSnapshotPtr items = repo_->snapshot();
+    for (const auto& art : *items) {
+        if (art) countTerms(*art, +1);
+    }
+    documents_ = items->size();
+    vectors_.assign(items->size() * kDims, 0);
+    scales_.assign(items->size(), 0.0f);
+    logPrices_.assign(items->size(), 0.0f);
+    prices_.assign(items->size(), 0.0f);
+    kinds_.assign(items->size(), ArtKind::Other);
+    locations_.assign(items->size(), 0);
+    for (std::size_t r = 0; r < items->size(); ++r) setAttributes(r, items->at(r).get());
+    reencodeAll();
+}
+
+void SimilarityIndex::reencodeAll()
+{
+    const ArtSnapshotPtr items = repo_->snapshot();
+    encodedAt_ = documents_;
+    TaskScheduler::instance().parallelFor(
+        TaskScheduler::Priority::Interactive, std::min(items->size(), size()), kEncodeGrain,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t r = begin; r < end; ++r) encode(r, items->at(r).get());
+        });
+}
+
+void SimilarityIndex::flushRemovals()
+{
+    if (pendingRemovals_.empty()) return;
+    std::vector<std::size_t> removed(pendingRemovals_.rbegin(), pendingRemovals_.rend());
+    pendingRemovals_.clear();
+
+    // One compaction pass over the rows that stay
+    std::size_t write = 0, next = 0;
+    for (std::size_t read = 0; read < size(); ++read) {
+        if (next < removed.size() && removed[next] == read) {
+            ++next;
+            continue;
+        }
+        if (write != read) {
+            std::copy_n(&vectors_[read * kDims], kDims, &vectors_[write * kDims]);
+            scales_[write]    = scales_[read];
+            logPrices_[write] = logPrices_[read];
+            prices_[write]    = prices_[read];
+            kinds_[write]     = kinds_[read];
+            locations_[write] = locations_[read];
+        }
+        ++write;
+    }
+    vectors_.resize(write * kDims);
+    scales_.resize(write);
+    logPrices_.resize(write);
+    prices_.resize(write);
+    kinds_.resize(write);
+    locations_.resize(write);
+}
+
+void SimilarityIndex::itemAdded(std::size_t index, const ArtPtr& art)
+{
+    flushRemovals();
+    index = std::min(index, size());
+    vectors_.insert(vectors_.begin() + index * kDims, kDims, 0);
+    scales_.insert(scales_.begin() + index, 0.0f);
+    logPrices_.insert(logPrices_.begin() + index, 0.0f);
+    prices_.insert(prices_.begin() + index, 0.0f);
+    kinds_.insert(kinds_.begin() + index, ArtKind::Other);
+    locations_.insert(locations_.begin() + index, 0);
+    setAttributes(index, art.get());
+    ++documents_;
+    if (art) countTerms(*art, +1);
+
+    // Frequencies are worth refreshing once the catalog has doubled
+    if (documents_ >= 2 * std::max<std::size_t>(encodedAt_, 512)) reencodeAll();
+    else encode(index, art.get());
+}
+
+void SimilarityIndex::itemUpdated(std::size_t index, const ArtPtr& oldArt, const ArtPtr& newArt)
+{
+    flushRemovals();
+    if (index >= size()) return;
+    if (oldArt) countTerms(*oldArt, -1);
+    if (newArt) countTerms(*newArt, +1);
+    setAttributes(index, newArt.get());
+    encode(index, newArt.get());
+}
+
+void SimilarityIndex::itemRemoved(std::size_t index, const ArtPtr& art)
+{
+    // Pending removals must all lie above this one for the deferred
+    // compaction to be right; anything else is applied first
+    if (!pendingRemovals_.empty() && pendingRemovals_.back() <= index) flushRemovals();
+    if (index >= size()) return;
+    if (art) countTerms(*art, -1);
+    pendingRemovals_.push_back(index);
+    if (documents_ > 0) --documents_;
+}
+
+void SimilarityIndex::itemsReset()
+{
+    rebuild();
+}
+
+void SimilarityIndex::repositoryChanged()
+{
+    flushRemovals();
+    if (documents_ > 0 && 2 * documents_ <= encodedAt_) reencodeAll();
+}
@@ -0,0 +1,405 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+// Set on worker threads so that tasks they submit land in their own deque
+thread_local const TaskScheduler* tlsScheduler = nullptr;
+thread_local std::size_t          tlsWorker    = 0;
+
+std::uint64_t microsSince(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace
+
+// ── TaskScheduler ──
+
+TaskScheduler& TaskScheduler::instance()
+{
+    static TaskScheduler scheduler(std::max(2u, std::thread::hardware_concurrency()));
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler(unsigned threads)
+{
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i)
+        workers_.push_back(std::make_unique<Worker>());
+    // Start only once every deque exists, since workers steal from each other
+    for (std::size_t i = 0; i < workers_.size(); ++i)
+        workers_[i]->thread = std::thread([this, i]() { run(i); });
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker->thread.join();
+}
+
+const char* TaskScheduler::priorityName(Priority priority) noexcept
+{
+    switch (priority) {
+    case Priority::Interactive: return "interactive";
+    case Priority::Thumbnail:   return "thumbnail";
+    case Priority::Prefetch:    return "prefetch";
+    case Priority::IndexBuild:  return "index build";
+    case Priority::Autosave:    return "autosave";
+    case Priority::Compaction:  return "compaction";
+    }
+    return "?";
+}
+
+void TaskScheduler::submit(Priority priority, Task task, CancelToken token)
+{
+    if (!task) return;
+    const int p = static_cast<int>(priority);
+    Item item{std::move(task), std::move(token), priority, Clock::now()};
+
+    // Counted before the item is visible, so a worker that finds
+    // pending_ > 0 but no item just looks again
+    counters_[p].submitted.fetch_add(1, std::memory_order_relaxed);
+    counters_[p].queued.fetch_add(1);
+    pending_.fetch_add(1);
+
+    if (tlsScheduler == this) {
+        Worker& own = *workers_[tlsWorker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.queues[p].push_back(std::move(item));
+    } else {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        inject_[p].push_back(std::move(item));
+    }
+
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    wake_.notify_one();
+}
+
+void TaskScheduler::parallelFor(Priority priority, std::size_t n, std::size_t grain,
+                                const std::function<void(std::size_t, std::size_t)>& body)
+{
+    if (n == 0) return;
+    if (grain == 0) grain = 1;
+    const std::size_t slices = (n + grain - 1) / grain;
+    if (slices == 1) {
+        body(0, n);
+        return;
+    }
+
+    // Helpers may start after the loop is over: they only touch 'state'
+    // (kept alive by their copy) until they have claimed a slice
+    struct State {
+        std::atomic<std::size_t> next{0};
+        std::size_t              done = 0;
+        std::mutex               mutex;
+        std::condition_variable  finished;
+        const std::function<void(std::size_t, std::size_t)>* body;
+    };
+    auto state = std::make_shared<State>();
+    state->body = &body;
+
+    auto work = [state, n, grain, slices]() {
+        for (;;) {
+            const std::size_t slice = state->next.fetch_add(1);
+            if (slice >= slices) return;
+            const std::size_t begin = slice * grain;
+            (*state->body)(begin, std::min(n, begin + grain));
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (++state->done == slices) state->finished.notify_all();
+        }
+    };
+
+    const std::size_t helpers = std::min<std::size_t>(slices - 1, workers_.size());
+    for (std::size_t i = 0; i < helpers; ++i) submit(priority, work);
+    work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&]() { return state->done == slices; });
+}
+
+bool TaskScheduler::take(std::size_t self, Item* out)
+{
+    for (int p = 0; p < kPriorities; ++p) {
+        if (counters_[p].queued.load() == 0) continue;
+
+        // Own deque, newest first: it was most likely spawned by the task
+        // this worker just ran
+        {
+            Worker& own = *workers_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.queues[p].empty()) {
+                *out = std::move(own.queues[p].back());
+                own.queues[p].pop_back();
+                return true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(injectMutex_);
+            if (!inject_[p].empty()) {
+                *out = std::move(inject_[p].front());
+                inject_[p].pop_front();
+                return true;
+            }
+        }
+        // Steal the oldest from the others, starting after ourselves so
+        // victims are spread out
+        for (std::size_t k = 1; k < workers_.size(); ++k) {
+            Worker& victim = *workers_[(self + k) % workers_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.queues[p].empty()) {
+                *out = std::move(victim.queues[p].front());
+                victim.queues[p].pop_front();
+                counters_[p].stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::run(std::size_t self)
+{
+    tlsScheduler = this;
+    tlsWorker    = self;
+
+    for (;;) {
+        Item item;
+        if (take(self, &item)) {
+            counters_[static_cast<int>(item.priority)].queued.fetch_sub(1);
+            pending_.fetch_sub(1);
+            execute(item);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]() { return stopping_ || pending_.load() > 0; });
+        if (stopping_ && pending_.load() == 0) return;
+    }
+}
+
+void TaskScheduler::execute(Item& item)
+{
+    Counters& c = counters_[static_cast<int>(item.priority)];
+    if (item.token && item.token->load()) {
+        c.cancelled.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const std::uint64_t waited = microsSince(item.queuedAt);
+    c.waitUsTotal.fetch_add(waited, std::memory_order_relaxed);
+    std::uint64_t max = c.waitUsMax.load(std::memory_order_relaxed);
+    while (waited > max && !c.waitUsMax.compare_exchange_weak(max, waited)) {}
+
+    const auto start = Clock::now();
+    item.task();
+    c.runUsTotal.fetch_add(microsSince(start), std::memory_order_relaxed);
+    c.completed.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::size_t TaskScheduler::queueDepth(Priority priority) const noexcept
+{
+    return counters_[static_cast<int>(priority)].queued.load();
+}
+
+TaskScheduler::Stats TaskScheduler::stats() const
+{
+    Stats out;
+    for (int p = 0; p < kPriorities; ++p) {
+        const Counters& c = counters_[p];
+        PriorityStats& s = out[p];
+        s.queued    = c.queued.load();
+        s.submitted = c.submitted.load();
+        s.completed = c.completed.load();
+        s.cancelled = c.cancelled.load();
+        s.stolen    = c.stolen.load();
+        s.maxWaitMs = c.waitUsMax.load() / 1000.0;
+        if (s.completed > 0) {
+            s.avgWaitMs = c.waitUsTotal.load() / 1000.0 / s.completed;
+            s.avgRunMs  = c.runUsTotal.load() / 1000.0 / s.completed;
+        }
+    }
+    return out;
+}
+
+std::string TaskScheduler::statsSummary() const
+{
+    const Stats all = stats();
+    std::string out;
+    char line[200];
+    for (int p = 0; p < kPriorities; ++p) {
+        const PriorityStats& s = all[p];
+        if (s.submitted == 0) continue;
+        std::snprintf(line, sizeof line,
+                      "%s: %llu done, %llu cancelled, %zu queued, %llu stolen, "
+                      "wait avg %.2f ms max %.2f ms, run avg %.2f ms\n",
+                      priorityName(static_cast<Priority>(p)),
+                      static_cast<unsigned long long>(s.completed),
+                      static_cast<unsigned long long>(s.cancelled),
+                      s.queued,
+                      static_cast<unsigned long long>(s.stolen),
+                      s.avgWaitMs, s.maxWaitMs, s.avgRunMs);
+        out += line;
+    }
+    return out;
+}
+
+// ── TaskGroup ──
+
+struct TaskGroup::State {
+    TaskScheduler*          scheduler;
+    bool                    serial;
+    std::mutex              mutex;
+    std::condition_variable idle;
+    std::size_t             outstanding = 0;
+    CancelToken             token = std::make_shared<std::atomic_bool>(false);
+
+    // Serial groups only
+    struct Queued {
+        Priority                 priority;
+        Task                     task;
+        CancelToken              token;
+        std::shared_ptr<void>    ticket;
+    };
+    std::deque<Queued> queue;
+    bool               pumping = false;
+
+    void finished() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--outstanding == 0) idle.notify_all();
+    }
+};
+
+// Released when a task has run or been dropped, whichever way that
+// happened; the last copy going away is what the group counts
+std::shared_ptr<void> TaskGroup::makeTicket(const std::shared_ptr<State>& state)
+{
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        ++state->outstanding;
+    }
+    return std::shared_ptr<void>(static_cast<void*>(nullptr),
+                                 [state](void*) { state->finished(); });
+}
+
+namespace {
+
+// Declared ticket first so it is released after the task (and whatever
+// the task captured) has been destroyed
+struct GroupTask {
+    std::shared_ptr<void>      ticket;
+    TaskScheduler::Task        task;
+    TaskScheduler::CancelToken token;
+
+    void operator()() {
+        if (token && token->load()) return;
+        task();
+        task = nullptr;
+    }
+};
+
+} // namespace
+
+TaskGroup::TaskGroup(bool serial, TaskScheduler& scheduler)
+    : scheduler_(scheduler), state_(std::make_shared<State>())
+{
+    state_->scheduler = &scheduler;
+    state_->serial    = serial;
+}
+
+TaskGroup::~TaskGroup()
+{
+    cancel();
+    wait();
+}
+
+void TaskGroup::submit(Priority priority, Task task, CancelToken token)
+{
+    if (!task) return;
+    auto ticket = makeTicket(state_);
+
+    if (!state_->serial) {
+        CancelToken groupToken;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            groupToken = state_->token;
+        }
+        // The scheduler checks one token (and counts what it skips); the
+        // other one, if any, is checked by the task itself
+        if (!token) std::swap(token, groupToken);
+        scheduler_.submit(priority,
+                          GroupTask{std::move(ticket), std::move(task), std::move(groupToken)},
+                          std::move(token));
+        return;
+    }
+
+    bool startPump = false;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->queue.push_back({priority, std::move(task), std::move(token), std::move(ticket)});
+        if (!state_->pumping) state_->pumping = startPump = true;
+    }
+    if (startPump) scheduler_.submit(priority, [state = state_]() { TaskGroup::pump(state); });
+}
+
+void TaskGroup::pump(const std::shared_ptr<State>& state)
+{
+    // Runs one queued task, then reschedules itself for the next one so
+    // a long serial queue does not hold a worker against higher priorities
+    State::Queued next;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->queue.empty()) {
+            state->pumping = false;
+            return;
+        }
+        next = std::move(state->queue.front());
+        state->queue.pop_front();
+    }
+
+    if (!next.token || !next.token->load()) next.task();
+    next.task = nullptr;
+    next.ticket.reset();
+
+    Priority priority;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->queue.empty()) {
+            state->pumping = false;
+            return;
+        }
+        priority = state->queue.front().priority;
+    }
+    state->scheduler->submit(priority, [state]() { TaskGroup::pump(state); });
+}
+
+void TaskGroup::cancel()
+{
+    std::deque<State::Queued> dropped;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->token->store(true);
+        state_->token = std::make_shared<std::atomic_bool>(false);
+        dropped.swap(state_->queue);
+    }
+    // 'dropped' releases its tickets here, outside the lock
+}
+
+void TaskGroup::wait()
+{
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->idle.wait(lock, [this]() { return state_->outstanding == 0; });
+}
+
+bool TaskGroup::idle() const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->outstanding == 0;
+}
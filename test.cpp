@@ -1,16 +1,52 @@
 // tests.cpp
+// The checks are asserts: keep them in release builds of art_tests too
+#undef NDEBUG
 #include "test.h"
 
 #include <cassert>
 #include <iostream>
+#include <map>
+#include <set>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include "ArtRepository.h"          // in-memory repository
+#include "ConcurrentArtRepository.h" // snapshot-reading variant
 #include "ArtRepositoryInterface.h" // interface used by Command.h
-#include "Command.h"                // AddCommand, RemoveCommand, EditCommand
-#include "painting.h"
-#include "sculpture.h"
+#include "Command.h"                // AddCommand, RemoveCommand, EditCommand, ...
+#include "UndoHistory.h"
+#include "UndoJournal.h"
+#include "JsonRepository.h"
+#include "TaskScheduler.h"
+#include "BoundedQueue.h"
+#include "BloomFilter.h"
+#include "Mix64.h"
+#include "NameIndex.h"
+#include "NearDuplicateFinder.h"
+#include "SimilarityIndex.h"
+#include "SseParser.h"
+#include "ChatContext.h"
+#include "CatalogRetriever.h"
+#include "ResponseCache.h"
+#include "RetryPolicy.h"
+#include "LatencyHistogram.h"
+#include "ChatTelemetry.h"
+#include "CatalogGenerator.h"
+#include "CsvRepository.h"
+#include "ChatTranscript.h"
+#include "BulkImporter.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDateTime>
+#include <QEventLoop>
+#include <QScrollBar>
+#include <QTimer>
+#include "Painting.h"
+#include "Sculpture.h"
 #include "DigitalArt.h"
 
 static void testAddUndoRedo()
@@ -236,11 +272,1268 @@ static void testMixedUndoRedoSequence()
     std::cout << "testMixedUndoRedoSequence is OK\n";
 }
 
+static void testCompositeUndoRedo()
+{
+    // 1) Three works, two of them in the same location
+    auto repo = std::make_shared<ArtRepository>();
+    repo->add(std::make_shared<Painting>("P1", "d", 100.0, "Hall", "C", ""));
+    repo->add(std::make_shared<Sculpture>("S1", "d", 200.0, "Garden", "M", ""));
+    repo->add(std::make_shared<Painting>("P2", "d", 300.0, "Hall", "C", ""));
+
+    // 2) +10% on everything in "Hall", as one command
+    auto batch = std::make_unique<CompositeCommand>(repo);
+    for (size_t i = 0; i < repo->size(); ++i) {
+        auto oldArt = repo->get(i);
+        if (oldArt->getLocation() != "Hall") continue;
+        auto newArt = oldArt->clone();
+        newArt->setPrice(oldArt->getPrice() * 1.1);
+        batch->add(std::make_unique<EditCommand>(repo, i, oldArt, newArt));
+    }
+    assert(batch->size() == 2);
+
+    batch->execute();
+    assert(repo->get(0)->getPrice() > 109.9 && repo->get(0)->getPrice() < 110.1);
+    assert(repo->get(1)->getPrice() == 200.0);
+    assert(repo->get(2)->getPrice() > 329.9 && repo->get(2)->getPrice() < 330.1);
+    // clone() keeps the dynamic type
+    assert(std::dynamic_pointer_cast<Painting>(repo->get(0)));
+
+    // 3) Undo restores every child
+    batch->undo();
+    assert(repo->get(0)->getPrice() == 100.0);
+    assert(repo->get(2)->getPrice() == 300.0);
+
+    // 4) Redo
+    batch->execute();
+    assert(repo->get(2)->getPrice() > 329.9);
+
+    std::cout << "testCompositeUndoRedo is OK\n";
+}
+
+static void testRemoveManyUndoRedo()
+{
+    // 1) Five works: A B C D E
+    auto repo = std::make_shared<ArtRepository>();
+    for (const char* name : {"A", "B", "C", "D", "E"}) {
+        repo->add(std::make_shared<Painting>(name, "d", 1.0, "L", "C", ""));
+    }
+
+    // 2) Remove B, D and E (unsorted, with a duplicate)
+    auto cmd = std::make_unique<RemoveManyCommand>(repo, std::vector<size_t>{4, 1, 3, 1});
+    cmd->execute();
+    assert(repo->size() == 2);
+    assert(repo->get(0)->getName() == "A");
+    assert(repo->get(1)->getName() == "C");
+
+    // 3) Undo re-appends them in their original order: A C B D E
+    cmd->undo();
+    assert(repo->size() == 5);
+    assert(repo->get(2)->getName() == "B");
+    assert(repo->get(3)->getName() == "D");
+    assert(repo->get(4)->getName() == "E");
+
+    // 4) Redo removes the same objects again
+    cmd->execute();
+    assert(repo->size() == 2);
+    assert(repo->get(0)->getName() == "A");
+    assert(repo->get(1)->getName() == "C");
+
+    std::cout << "testRemoveManyUndoRedo is OK\n";
+}
+
+static void testCommandsFindTheirRecords()
+{
+    auto names = [](const std::shared_ptr<ArtRepository>& repo) {
+        std::string all;
+        for (size_t i = 0; i < repo->size(); ++i) all += repo->get(i)->getName();
+        return all;
+    };
+    auto make = [](const char* name) {
+        return std::make_shared<Painting>(name, "d", 1.0, "L", "C", "");
+    };
+
+    // 1) A restored AddCommand holds an equal copy and a stale index:
+    //    undo removes the matching record, not whatever sits at the index
+    auto repo = std::make_shared<ArtRepository>();
+    for (const char* name : {"X", "A", "B"}) repo->add(make(name));
+    AddCommand restored(repo, make("B"), 1);
+    restored.markExecuted(true);
+    restored.undo();
+    assert(names(repo) == "XA");
+    restored.execute();
+    assert(names(repo) == "XAB");
+
+    // 2) ...and leaves the repository alone if the record is gone
+    AddCommand missing(repo, make("Z"), 0);
+    missing.markExecuted(true);
+    missing.undo();
+    assert(names(repo) == "XAB");
+
+    // 3) Same name, different fields: not a match
+    assert(!sameArt(*make("A"), Painting("A", "d", 2.0, "L", "C", "")));
+    assert(!sameArt(*make("A"), Sculpture("A", "d", 1.0, "L", "C", "")));
+
+    // 4) RemoveManyCommand redo after something else was appended
+    repo = std::make_shared<ArtRepository>();
+    for (const char* name : {"A", "B", "C"}) repo->add(make(name));
+    RemoveManyCommand remove(repo, {1});
+    remove.execute();
+    remove.undo();
+    assert(names(repo) == "ACB");
+    repo->add(make("D"));
+    remove.execute();
+    assert(names(repo) == "ACD");
+
+    // 5) A restored, undone RemoveManyCommand holds copies: redo matches
+    //    them by value wherever they are
+    repo = std::make_shared<ArtRepository>();
+    for (const char* name : {"A", "B", "C"}) repo->add(make(name));
+    RemoveManyCommand copies(repo, {0}, {make("B")});
+    copies.execute();
+    assert(names(repo) == "AC");
+    copies.undo();
+    assert(names(repo) == "ACB");
+
+    std::cout << "testCommandsFindTheirRecords is OK\n";
+}
+
+static void testBatchNotifiesOnce()
+{
+    struct Counter : RepositoryObserver {
+        int items = 0;
+        int changes = 0;
+        void itemAdded(size_t, const ArtPtr&) override { ++items; }
+        void itemUpdated(size_t, const ArtPtr&, const ArtPtr&) override { ++items; }
+        void itemRemoved(size_t, const ArtPtr&) override { ++items; }
+        void repositoryChanged() override { ++changes; }
+    };
+
+    auto repo = std::make_shared<ArtRepository>();
+    Counter counter;
+    repo->addObserver(&counter);
+
+    // 1) Standalone mutations notify one by one
+    repo->add(std::make_shared<Painting>("A", "d", 1.0, "L", "C", ""));
+    repo->add(std::make_shared<Painting>("B", "d", 2.0, "L", "C", ""));
+    repo->add(std::make_shared<Painting>("C", "d", 3.0, "L", "C", ""));
+    assert(counter.items == 3 && counter.changes == 3);
+
+    // 2) A composite of four children: every item event, one change
+    counter = Counter{};
+    auto batch = std::make_unique<CompositeCommand>(repo);
+    batch->add(std::make_unique<AddCommand>(
+        repo, std::make_shared<Painting>("D", "d", 4.0, "L", "C", "")));
+    batch->add(std::make_unique<EditCommand>(
+        repo, 0, repo->get(0), std::make_shared<Painting>("A2", "d", 1.0, "L", "C", "")));
+    batch->add(std::make_unique<RemoveManyCommand>(repo, std::vector<size_t>{1, 2}));
+    batch->execute();
+    assert(counter.items == 4);
+    assert(counter.changes == 1);
+
+    batch->undo();
+    assert(counter.changes == 2);
+    assert(repo->size() == 3);
+
+    repo->removeObserver(&counter);
+    std::cout << "testBatchNotifiesOnce is OK\n";
+}
+
+static void testFieldEditMerge()
+{
+    // 1) One painting, edited through an UndoHistory
+    auto repo = std::make_shared<ArtRepository>();
+    auto original = std::make_shared<Painting>("P", "d", 100.0, "L", "Linen", "");
+    repo->add(original);
+    UndoHistory history;
+
+    auto edit = [&](ArtField field, FieldValue oldValue, FieldValue newValue) {
+        auto cmd = std::make_unique<FieldEditCommand>(repo, 0, field, oldValue, newValue);
+        cmd->execute();
+        history.push(std::move(cmd));
+    };
+
+    // 2) Three price tweaks in a row collapse into one step
+    edit(ArtField::Price, 100.0, 110.0);
+    edit(ArtField::Price, 110.0, 120.0);
+    edit(ArtField::Price, 120.0, 125.0);
+    assert(history.undoCount() == 1);
+    assert(repo->get(0)->getPrice() == 125.0);
+    // The original object is never modified in place
+    assert(original->getPrice() == 100.0);
+
+    // 3) A different field starts a new step
+    edit(ArtField::CanvasType, std::string("Linen"), std::string("Cotton"));
+    assert(history.undoCount() == 2);
+    auto painting = std::dynamic_pointer_cast<Painting>(repo->get(0));
+    assert(painting && painting->getCanvasType() == "Cotton");
+
+    // 4) Undo both steps
+    history.undo();
+    assert(std::dynamic_pointer_cast<Painting>(repo->get(0))->getCanvasType() == "Linen");
+    assert(repo->get(0)->getPrice() == 125.0);
+    history.undo();
+    assert(repo->get(0)->getPrice() == 100.0);
+    assert(!history.canUndo());
+
+    // 5) Redo, then an edit after a redo does not merge into it
+    history.redo();
+    assert(repo->get(0)->getPrice() == 125.0);
+    edit(ArtField::Price, 125.0, 130.0);
+    assert(history.undoCount() == 2);
+    assert(!history.canRedo());
+
+    std::cout << "testFieldEditMerge is OK\n";
+}
+
+static void testUndoHistoryBudget()
+{
+    auto repo = std::make_shared<ArtRepository>();
+    for (int i = 0; i < 100; ++i) {
+        repo->add(std::make_shared<Sculpture>("S", "d", 1.0, "L", "M", ""));
+    }
+
+    // 1) A budget for only a handful of single-field edits
+    FieldEditCommand probe(repo, 0, ArtField::Price, 1.0, 2.0);
+    UndoHistory history(probe.memoryCost() * 5);
+
+    // 2) Edit every record: usage stays flat, the oldest steps go
+    for (size_t i = 0; i < repo->size(); ++i) {
+        auto cmd = std::make_unique<FieldEditCommand>(repo, i, ArtField::Price, 1.0, 2.0);
+        cmd->execute();
+        history.push(std::move(cmd));
+        assert(history.memoryUsage() <= history.memoryBudget());
+    }
+    assert(history.undoCount() == 5);
+    assert(history.droppedCount() == 95);
+
+    // 3) What is left still undoes the most recent edits
+    while (history.undo()) {}
+    assert(repo->get(99)->getPrice() == 1.0);
+    assert(repo->get(95)->getPrice() == 1.0);
+    assert(repo->get(94)->getPrice() == 2.0);
+
+    // 4) The newest step survives even if it alone is over budget
+    history.setMemoryBudget(1);
+    assert(history.undoCount() == 0);
+    auto cmd = std::make_unique<FieldEditCommand>(repo, 0, ArtField::Price, 2.0, 3.0);
+    cmd->execute();
+    assert(history.oversizedCount() == 0);
+    history.push(std::move(cmd));
+    assert(history.undoCount() == 1);
+    assert(history.oversizedCount() == 1);
+
+    std::cout << "testUndoHistoryBudget is OK\n";
+}
+
+static void testBulkImportUndo()
+{
+    // 1) Two exports that overlap each other and the catalog, plus a file
+    //    with two invalid rows (no name, negative price)
+    const CatalogGenerator generator;
+    QTemporaryDir dir;
+    assert(dir.isValid());
+    auto writeFile = [&](const QString& name, const std::string& text) {
+        QFile file(dir.filePath(name));
+        assert(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray::fromStdString(text));
+    };
+    std::ostringstream a, b, bad;
+    generator.write(a, CatalogGenerator::Format::Csv, 12000, 0);
+    generator.write(b, CatalogGenerator::Format::Json, 12000, 8000);
+    generator.write(bad, CatalogGenerator::Format::Csv, 0);
+    CatalogGenerator::Record noName = generator.record(30000);
+    noName.name.clear();
+    CatalogGenerator::Record negative = generator.record(30001);
+    negative.price = -5.0;
+    bad << CatalogGenerator::csvRow(noName) << CatalogGenerator::csvRow(negative);
+    writeFile("a.csv", a.str());
+    writeFile("b.json", b.str());
+    writeFile("bad.csv", bad.str());
+
+    auto repo = std::make_shared<ArtRepository>();
+    repo->addMany(generator.arts(0, 1000));
+    std::vector<std::shared_ptr<ArtObject>> before;
+    for (std::size_t i = 0; i < repo->size(); ++i) before.push_back(repo->get(i));
+
+    // What should come in: every key not in the catalog, once
+    std::set<std::string> keys;
+    for (const auto& art : before) keys.insert(BulkImporter::dedupKey(*art));
+    const std::size_t existingKeys = keys.size();
+    for (std::uint64_t i = 0; i < 20000; ++i) keys.insert(BulkImporter::dedupKey(*generator.art(i)));
+    const std::size_t expected = keys.size() - existingKeys;
+
+    // 2) Import the way MainWindow does: one undo step per batch
+    UndoHistory history;
+    BulkImporter importer;
+    BulkImporter::Report report;
+    std::size_t batches = 0;
+    QEventLoop loop;
+    QObject::connect(&importer, &BulkImporter::batchReady, [&](const BulkImporter::Batch& batch) {
+        const std::size_t first = repo->size();
+        repo->addMany(batch);
+        auto cmd = std::make_unique<AddManyCommand>(repo, batch, first);
+        cmd->markExecuted(true);
+        history.push(std::move(cmd));
+        ++batches;
+    });
+    QObject::connect(&importer, &BulkImporter::finished, [&](const BulkImporter::Report& r) {
+        report = r;
+        loop.quit();
+    });
+    QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+    importer.start(dir.path(), repo->snapshot());
+    loop.exec();
+
+    assert(!importer.isRunning());
+    assert(report.files == 3 && report.failedFiles == 0);
+    assert(report.rows == 24002);
+    assert(report.invalid == 2);
+    assert(report.imported == expected);
+    assert(report.duplicates == report.rows - report.invalid - report.imported);
+    assert(repo->size() == before.size() + expected);
+    assert(batches > 1 && history.undoCount() == batches);
+    std::set<std::string> inRepo;
+    for (std::size_t i = 0; i < repo->size(); ++i) {
+        assert(inRepo.insert(BulkImporter::dedupKey(*repo->get(i))).second);
+    }
+
+    // 3) Undo takes out exactly the imported records, redo brings them back
+    while (history.undo()) {}
+    assert(repo->size() == before.size());
+    for (std::size_t i = 0; i < before.size(); ++i) assert(repo->get(i) == before[i]);
+    while (history.redo()) {}
+    assert(repo->size() == before.size() + expected);
+
+    std::cout << "testBulkImportUndo is OK\n";
+}
+
+static void testUndoJournalRecovery()
+{
+    // 1) A saved catalog with two works
+    QTemporaryDir dir;
+    assert(dir.isValid());
+    const QString catalog = dir.filePath("catalog.json");
+    {
+        JsonRepository repo;
+        repo.add(std::make_shared<Painting>("P1", "d", 100.0, "L", "C", ""));
+        repo.add(std::make_shared<Sculpture>("S1", "d", 200.0, "L", "M", ""));
+        assert(repo.saveToFile(catalog));
+    }
+
+    // 2) A session that edits, removes and then dies without saving
+    {
+        auto repo = std::make_shared<JsonRepository>();
+        assert(repo->loadFromFile(catalog));
+        UndoHistory history;
+        UndoJournal journal;
+        assert(journal.open(catalog, repo, history) == UndoJournal::State::Reset);
+
+        auto edit = std::make_unique<FieldEditCommand>(repo, 0, ArtField::Price, 100.0, 150.0);
+        edit->execute();
+        history.push(std::move(edit));
+        auto remove = std::make_unique<RemoveCommand>(repo, 1);
+        remove->execute();
+        history.push(std::move(remove));
+        journal.flush();
+    }
+
+    // 3) The next start replays both edits onto the saved catalog and
+    //    can still undo them
+    {
+        auto repo = std::make_shared<JsonRepository>();
+        assert(repo->loadFromFile(catalog));
+        assert(repo->size() == 2);
+        UndoHistory history;
+        UndoJournal journal;
+        assert(journal.open(catalog, repo, history) == UndoJournal::State::Recovered);
+        assert(repo->size() == 1);
+        assert(repo->get(0)->getPrice() == 150.0);
+
+        history.undo();
+        assert(repo->size() == 2);
+        assert(repo->get(1)->getName() == "S1");
+        history.undo();
+        assert(repo->get(0)->getPrice() == 100.0);
+
+        // Clean shutdown
+        assert(repo->saveToFile(catalog));
+        journal.checkpoint(history);
+    }
+
+    // 4) After a clean shutdown nothing is replayed; the old steps are
+    //    only read when asked for
+    {
+        auto repo = std::make_shared<JsonRepository>();
+        assert(repo->loadFromFile(catalog));
+        UndoHistory history;
+        UndoJournal journal;
+        assert(journal.open(catalog, repo, history) == UndoJournal::State::Clean);
+        assert(history.hasPendingOlder());
+        assert(repo->get(0)->getPrice() == 100.0);
+
+        assert(history.redo());
+        assert(!history.hasPendingOlder());
+        assert(repo->get(0)->getPrice() == 150.0);
+        assert(history.redo());
+        assert(repo->size() == 1);
+    }
+
+    std::cout << "testUndoJournalRecovery is OK\n";
+}
+
+static void testConcurrentSnapshots()
+{
+    // 1) Enough works to span several chunks
+    auto repo = std::make_shared<ConcurrentArtRepository>();
+    const size_t n = ArtSnapshot::kChunkSize * 3 + 10;
+    std::vector<std::shared_ptr<ArtObject>> batch;
+    for (size_t i = 0; i < n; ++i) {
+        batch.push_back(std::make_shared<Painting>(
+            std::to_string(i), "d", double(i), "L", "C", ""));
+    }
+    repo->addMany(batch);
+    assert(repo->size() == n);
+
+    // 2) A snapshot does not see later changes
+    auto before = repo->snapshot();
+    repo->add(std::make_shared<Painting>("extra", "d", 0.0, "L", "C", ""));
+    repo->update(5, std::make_shared<Painting>("five", "d", 5.0, "L", "C", ""));
+    assert(before->size() == n);
+    assert(before->at(5)->getName() == "5");
+    assert(repo->snapshot()->at(5)->getName() == "five");
+    assert(repo->get(n)->getName() == "extra");
+
+    // 3) Untouched chunks are shared between versions
+    auto after = repo->snapshot();
+    assert(after->chunks()[1] == before->chunks()[1]);
+    assert(after->chunks()[0] != before->chunks()[0]);
+
+    // 4) removeMany across chunk boundaries keeps the order of the rest
+    repo->removeMany({ArtSnapshot::kChunkSize * 2 + 1, 3, ArtSnapshot::kChunkSize});
+    assert(repo->size() == n + 1 - 3);
+    assert(repo->get(3)->getName() == "4");
+    assert(repo->get(ArtSnapshot::kChunkSize - 1)->getName()
+           == std::to_string(ArtSnapshot::kChunkSize + 1));
+    size_t count = 0;
+    for (const auto& art : *repo->snapshot()) {
+        assert(art);
+        ++count;
+    }
+    assert(count == repo->size());
+
+    // 5) Commands work on it like on any repository
+    auto cmd = std::make_unique<RemoveCommand>(repo, 0);
+    cmd->execute();
+    assert(repo->get(0)->getName() == "1");
+    cmd->undo();
+    assert(repo->get(repo->size() - 1)->getName() == "0");
+
+    std::cout << "testConcurrentSnapshots is OK\n";
+}
+
+static void testTaskScheduler()
+{
+    using Priority = TaskScheduler::Priority;
+
+    // 1) One worker, held busy by a gate task: everything queued behind
+    //    it runs highest priority first, FIFO within a priority
+    {
+        TaskScheduler scheduler(1);
+        std::atomic_bool open{false};
+        std::mutex mutex;
+        std::vector<int> order;
+        auto record = [&](int value) {
+            return [&, value]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(value);
+            };
+        };
+
+        TaskGroup group(false, scheduler);
+        group.submit(Priority::Interactive, [&]() {
+            while (!open.load()) std::this_thread::yield();
+        });
+        while (scheduler.queueDepth(Priority::Interactive) != 0) std::this_thread::yield();
+
+        group.submit(Priority::Compaction,  record(5));
+        group.submit(Priority::Autosave,    record(4));
+        group.submit(Priority::Thumbnail,   record(2));
+        group.submit(Priority::Interactive, record(0));
+        group.submit(Priority::Thumbnail,   record(3));
+        group.submit(Priority::Interactive, record(1));
+
+        // 2) Cancelled before starting: skipped and counted
+        auto token = std::make_shared<std::atomic_bool>(false);
+        group.submit(Priority::Interactive, record(99), token);
+        token->store(true);
+        assert(scheduler.queueDepth(Priority::Thumbnail) == 2);
+
+        open.store(true);
+        group.wait();
+        assert(group.idle());
+        assert((order == std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+        const auto stats = scheduler.stats();
+        const auto& interactive = stats[static_cast<int>(Priority::Interactive)];
+        assert(interactive.submitted == 4);
+        assert(interactive.completed == 3);
+        assert(interactive.cancelled == 1);
+        assert(interactive.queued == 0);
+    }
+
+    // 3) Group cancel drops what is still queued, but not what is running
+    {
+        TaskScheduler scheduler(1);
+        std::atomic_bool open{false}, started{false};
+        std::atomic_int ran{0};
+        TaskGroup group(false, scheduler);
+        group.submit(Priority::IndexBuild, [&]() {
+            started.store(true);
+            while (!open.load()) std::this_thread::yield();
+            ++ran;
+        });
+        while (!started.load()) std::this_thread::yield();
+        for (int i = 0; i < 10; ++i) group.submit(Priority::IndexBuild, [&]() { ++ran; });
+        group.cancel();
+        group.submit(Priority::IndexBuild, [&]() { ran += 100; });   // after cancel: runs
+        open.store(true);
+        group.wait();
+        assert(ran.load() == 101);
+    }
+
+    // 4) Serial group on many workers: tasks never overlap and keep order
+    {
+        TaskScheduler scheduler(4);
+        TaskGroup serial(true, scheduler);
+        std::atomic_int running{0};
+        std::vector<int> order;
+        for (int i = 0; i < 200; ++i) {
+            serial.submit(Priority::Autosave, [&, i]() {
+                assert(++running == 1);
+                order.push_back(i);
+                --running;
+            });
+        }
+        serial.wait();
+        assert(order.size() == 200);
+        for (int i = 0; i < 200; ++i) assert(order[i] == i);
+    }
+
+    // 5) Tasks spawned by tasks: the spawning worker keeps them, idle ones steal
+    {
+        TaskScheduler scheduler(4);
+        std::atomic_int leaves{0};
+        {
+            TaskGroup group(false, scheduler);
+            group.submit(Priority::IndexBuild, [&]() {
+                for (int i = 0; i < 64; ++i) {
+                    group.submit(Priority::IndexBuild, [&]() {
+                        std::this_thread::sleep_for(std::chrono::microseconds(200));
+                        ++leaves;
+                    });
+                }
+            });
+            group.wait();
+        }
+        assert(leaves.load() == 64);
+        assert(scheduler.stats()[static_cast<int>(Priority::IndexBuild)].completed == 65);
+    }
+
+    std::cout << "testTaskScheduler is OK\n";
+}
+
+static void testAddManyUndoRedo()
+{
+    auto repo = std::make_shared<ArtRepository>();
+    repo->add(std::make_shared<Painting>("Old", "", 1.0, "A", "Oil", ""));
+
+    std::vector<std::shared_ptr<ArtObject>> arts;
+    for (int i = 0; i < 5; ++i) {
+        arts.push_back(std::make_shared<Sculpture>("Imported " + std::to_string(i), "",
+                                                   10.0 + i, "B", "Bronze", ""));
+    }
+
+    // 1) Added up front, recorded afterwards (as a bulk import does), with
+    //    an unrelated record appended in between
+    repo->addMany({arts[0], arts[1]});
+    repo->add(std::make_shared<Painting>("Meanwhile", "", 2.0, "A", "Oil", ""));
+    repo->addMany({arts[2], arts[3], arts[4]});
+    AddManyCommand cmd(repo, arts, 1);
+    cmd.markExecuted(true);
+    assert(repo->size() == 7);
+
+    // 2) Undo removes exactly the imported objects
+    cmd.undo();
+    assert(repo->size() == 2);
+    assert(repo->get(0)->getName() == "Old");
+    assert(repo->get(1)->getName() == "Meanwhile");
+
+    // 3) Redo appends them again, in order
+    cmd.execute();
+    assert(repo->size() == 7);
+    assert(cmd.index() == 2);
+    for (int i = 0; i < 5; ++i) assert(repo->get(2 + i) == arts[i]);
+
+    // 4) A restored command holds copies: it matches them by value
+    std::vector<std::shared_ptr<ArtObject>> copies;
+    for (const auto& art : arts) copies.push_back(art->clone());
+    AddManyCommand restored(repo, copies, 2);
+    restored.markExecuted(true);
+    restored.undo();
+    assert(repo->size() == 2);
+    restored.execute();
+    assert(repo->get(6) == arts[4]);   // adopted the removed objects
+
+    // 5) Records that are gone (or moved) are not replaced by whatever is
+    //    at their old positions
+    repo->remove(3);                   // arts[1]
+    repo->add(std::make_shared<Painting>("Later", "", 3.0, "A", "Oil", ""));
+    AddManyCommand stale(repo, copies, 2);
+    stale.markExecuted(true);
+    stale.undo();
+    assert(repo->size() == 3);
+    assert(repo->get(0)->getName() == "Old");
+    assert(repo->get(1)->getName() == "Meanwhile");
+    assert(repo->get(2)->getName() == "Later");
+
+    std::cout << "testAddManyUndoRedo is OK\n";
+}
+
+static void testBoundedQueue()
+{
+    // 1) Single thread: FIFO, capacity rounded up, full/empty reported
+    BoundedQueue<int> small(3);
+    assert(small.capacity() == 4);
+    assert(small.empty());
+    for (int i = 0; i < 4; ++i) assert(small.tryPush(int(i)));
+    assert(!small.tryPush(99));
+    int v = -1;
+    for (int i = 0; i < 4; ++i) {
+        assert(small.tryPop(v));
+        assert(v == i);
+    }
+    assert(!small.tryPop(v));
+
+    // 2) Several producers and consumers: every value comes out once
+    constexpr int kProducers = 4, kConsumers = 4, kPerProducer = 20000;
+    BoundedQueue<std::unique_ptr<int>> queue(64);
+    std::vector<std::atomic_int> seen(kProducers * kPerProducer);
+    std::atomic_int consumed{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                auto item = std::make_unique<int>(p * kPerProducer + i);
+                while (!queue.tryPush(std::move(item))) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&]() {
+            std::unique_ptr<int> item;
+            while (consumed.load() < kProducers * kPerProducer) {
+                if (!queue.tryPop(item)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                ++seen[*item];
+                ++consumed;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    for (const auto& count : seen) assert(count.load() == 1);
+    assert(queue.empty());
+
+    std::cout << "testBoundedQueue is OK\n";
+}
+
+static void testBloomFilter()
+{
+    BloomFilter bloom(10000, 0.01);
+
+    // 1) No false negatives
+    for (std::uint64_t i = 0; i < 10000; ++i) bloom.insert(mix64(i));
+    for (std::uint64_t i = 0; i < 10000; ++i) assert(bloom.mightContain(mix64(i)));
+
+    // 2) False positives near the requested rate (allow 2x)
+    int falsePositives = 0;
+    for (std::uint64_t i = 10000; i < 110000; ++i) {
+        if (bloom.mightContain(mix64(i))) ++falsePositives;
+    }
+    assert(falsePositives < 2000);
+
+    // 3) An empty filter contains nothing
+    BloomFilter empty;
+    assert(!empty.mightContain(mix64(1)));
+
+    std::cout << "testBloomFilter is OK\n";
+}
+
+static void testNameIndex()
+{
+    auto repo = std::make_shared<ArtRepository>();
+    repo->add(std::make_shared<Painting>("Mona Lisa", "", 1.0, "Louvre", "Oil", ""));
+    NameIndex index(repo);   // built from what is there
+
+    // 1) Case, width and spacing do not matter
+    repo->add(std::make_shared<Painting>("MONA  LISA", "", 2.0, "Paris", "Oil", ""));
+    repo->add(std::make_shared<Sculpture>("David", "", 3.0, "Florence", "Marble", ""));
+    assert((index.find("mona lisa") == std::vector<std::size_t>{0, 1}));
+    assert((index.find(QString::fromUtf8("\uff2d\uff4f\uff4e\uff41 Lisa")).size() == 2));
+    assert(index.find("Venus").empty());
+
+    // 2) Renames move the record between names
+    auto renamed = repo->get(1)->clone();
+    renamed->setName("Gioconda");
+    repo->update(1, renamed);
+    assert((index.find("Mona Lisa") == std::vector<std::size_t>{0}));
+    assert((index.find("gioconda") == std::vector<std::size_t>{1}));
+
+    // 3) Removals shift later indices, also when batched
+    for (int i = 0; i < 5; ++i) {
+        repo->add(std::make_shared<Painting>("Copy " + std::to_string(i), "", 1.0, "X", "Oil", ""));
+    }
+    repo->add(std::make_shared<Painting>("mona lisa", "", 1.0, "Y", "Oil", ""));   // index 8
+    repo->removeMany({0, 3, 5});
+    assert((index.find("Mona Lisa") == std::vector<std::size_t>{5}));
+    assert((index.find("David") == std::vector<std::size_t>{1}));
+    assert((index.find("Copy 3") == std::vector<std::size_t>{3}));
+    repo->remove(0);
+    repo->remove(0);
+    assert((index.find("Copy 1") == std::vector<std::size_t>{0}));
+    assert(index.size() == repo->size());
+
+    // 4) Undo of a batch removal re-adds at the end
+    auto cmd = std::make_unique<RemoveManyCommand>(repo, std::vector<std::size_t>{0, 1});
+    cmd->execute();
+    cmd->undo();
+    assert((index.find("Copy 1") == std::vector<std::size_t>{2}));
+
+    std::cout << "testNameIndex is OK\n";
+}
+
+static void testNearDuplicateFinder()
+{
+    // 1) Shingles ignore case and punctuation
+    Painting a("Water Lilies", "Pond at Giverny, morning light", 1.0, "Paris", "Oil", "");
+    Painting b("water lilies!", "pond at giverny -- morning light", 9.0, "Orsay", "Oil", "");
+    assert(NearDuplicateFinder::shingles(a) == NearDuplicateFinder::shingles(b));
+    assert(NearDuplicateFinder::jaccard(NearDuplicateFinder::shingles(a),
+                                        NearDuplicateFinder::shingles(b)) == 1.0);
+
+    // 2) Equal sets give equal signatures
+    assert(NearDuplicateFinder::signature(NearDuplicateFinder::shingles(a), 64) ==
+           NearDuplicateFinder::signature(NearDuplicateFinder::shingles(b), 64));
+
+    // 3) Planted near-duplicates are found among unrelated records, more
+    //    than one parallel slice's worth of them
+    std::vector<std::shared_ptr<ArtObject>> items;
+    std::uint32_t seed = 12345;
+    auto word = [&seed]() {
+        std::string w;
+        for (int i = 0; i < 7; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            w += static_cast<char>('a' + (seed >> 24) % 26);
+        }
+        return w;
+    };
+    for (int i = 0; i < 10000; ++i) {
+        items.push_back(std::make_shared<Painting>(
+            word() + " " + word(), word() + " " + word() + " " + word(), 1.0, "Store", "Ink", ""));
+    }
+    items.push_back(std::make_shared<Painting>(
+        "The Starry Night", "Swirling night sky over Saint-Remy, cypress in front", 1.0, "MoMA", "Oil", ""));
+    items.push_back(std::make_shared<Painting>(
+        "Starry Night", "Swirling night sky over Saint-Remy, cypress in the front", 2.0, "NY", "Oil", ""));
+    items.push_back(std::make_shared<Sculpture>(   // same text, other type
+        "The Starry Night", "Swirling night sky over Saint-Remy, cypress in front", 1.0, "MoMA", "Clay", ""));
+    const ArtSnapshot snapshot(items);
+
+    const auto pairs = NearDuplicateFinder::find(snapshot);
+    bool found = false;
+    for (const auto& pair : pairs) {
+        assert(pair.first < pair.second && pair.similarity >= 0.7);
+        assert(items[pair.first]->getType() == items[pair.second]->getType());
+        if (pair.first == 10000 && pair.second == 10001) found = true;
+    }
+    assert(found);
+    for (std::size_t i = 1; i < pairs.size(); ++i) {
+        assert(pairs[i - 1].similarity >= pairs[i].similarity);
+    }
+
+    // 4) A cancelled search stops
+    std::atomic_bool cancelled{true};
+    assert(NearDuplicateFinder::find(snapshot, NearDuplicateFinder::Options(), &cancelled).empty());
+
+    std::cout << "testNearDuplicateFinder is OK\n";
+}
+
+static void testSimilarityIndex()
+{
+    // 1) The dot kernel matches a plain loop, tail included
+    std::vector<std::int8_t> a(75), b(75);
+    std::int32_t expected = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        a[i] = static_cast<std::int8_t>(int(i * 37 % 255) - 127);
+        b[i] = static_cast<std::int8_t>(127 - int(i * 91 % 255));
+        expected += std::int32_t(a[i]) * b[i];
+    }
+    assert(SimilarityIndex::dot(a.data(), b.data(), a.size()) == expected);
+
+    // 2) Shared words and a close price rank first
+    auto repo = std::make_shared<ArtRepository>();
+    repo->add(std::make_shared<Painting>("Harbour at dusk", "fishing boats, orange sky", 900.0, "A", "Oil", ""));
+    repo->add(std::make_shared<Sculpture>("Bronze horse", "rearing stallion", 5000.0, "B", "Bronze", ""));
+    repo->add(std::make_shared<Painting>("Harbour at dawn", "fishing boats, grey sky", 1000.0, "C", "Oil", ""));
+    repo->add(std::make_shared<DigitalArt>("Pixel city", "neon skyline", 50.0, "D", "Krita", 800, 600));
+    SimilarityIndex index(repo);
+    auto hits = index.similar(0, 2);
+    assert(hits.size() == 2 && hits[0].index == 2 && hits[0].score > hits[1].score);
+
+    // 3) Edits re-encode the record
+    auto edited = repo->get(1)->clone();
+    edited->setName("Harbour at dusk");
+    edited->setDescription("fishing boats, orange sky");
+    repo->update(1, edited);
+    assert(index.similar(0, 1).front().index == 1);
+
+    // 4) Removals shift later records down, also when batched
+    repo->add(std::make_shared<Painting>("Harbour at night", "fishing boats", 950.0, "E", "Oil", ""));
+    repo->removeMany({1, 2});
+    assert(index.size() == repo->size());
+    assert(index.similar(0, 1).front().index == 2);   // the one at night
+    assert(index.similar(0, 10).size() == 2);
+
+    std::cout << "testSimilarityIndex is OK\n";
+}
+
+static void testSseParser()
+{
+    // 1) Events split across reads at awkward places, CRLF included
+    const std::string stream =
+        ": keep-alive\r\n"
+        "data: {\"a\":1}\r\n\r\n"
+        "event: note\n"
+        "data: line one\n"
+        "data:line two\n\n"
+        "data: [DONE]\r\r";
+    for (std::size_t split = 0; split <= stream.size(); ++split) {
+        SseParser parser;
+        auto events = parser.feed(stream.substr(0, split));
+        for (auto& e : parser.feed(stream.substr(split))) events.push_back(e);
+        assert(events.size() == 3);
+        assert(events[0].data == "{\"a\":1}" && events[0].event.empty());
+        assert(events[1].event == "note" && events[1].data == "line one\nline two");
+        assert(events[2].data == "[DONE]");
+    }
+
+    // 2) A stream cut off after its last data line still delivers it
+    SseParser parser;
+    assert(parser.feed("data: partial").empty());
+    auto last = parser.finish();
+    assert(last.size() == 1 && last[0].data == "partial");
+
+    std::cout << "testSseParser is OK\n";
+}
+
+static void testChatContext()
+{
+    ChatContext context(500, "system prompt");
+    auto tokens = [](const std::vector<ChatMessage>& messages) {
+        std::size_t total = 0;
+        for (const auto& m : messages) total += ChatContext::estimateTokens(m.content);
+        return total;
+    };
+
+    // 1) Short sessions go out whole
+    context.add("user", "hello");
+    context.add("assistant", "hi");
+    auto built = context.build();
+    assert(built.size() == 3 && built[0].role == "system" && built[2].content == "hi");
+
+    // 2) Long sessions stay within the budget, newest turn last
+    for (int turn = 0; turn < 50; ++turn) {
+        context.add("user", "question " + std::to_string(turn) + std::string(200, 'q'));
+        context.add("assistant", "answer " + std::to_string(turn) + std::string(200, 'a'));
+    }
+    built = context.build();
+    assert(tokens(built) <= 500);
+    assert(built.back().content.compare(0, 9, "answer 49") == 0);
+    assert(built[0].content == "system prompt");
+
+    // 3) Folding replaces the old turns with the summary
+    std::uint64_t foldEnd = 0;
+    const auto prompt = context.foldRequest(&foldEnd);
+    assert(!prompt.empty() && foldEnd > 0);
+    assert(context.foldRequest(&foldEnd).empty());   // one at a time
+    context.setSummary("they talked about fifty things", foldEnd);
+    built = context.build();
+    assert(built[1].content.find("fifty things") != std::string::npos);
+    assert(context.pendingMessages() < 102 && tokens(built) <= 500);
+    assert(built.back().content.compare(0, 9, "answer 49") == 0);
+
+    // 4) A single oversized message is still sent
+    context.add("user", std::string(5000, 'x'));
+    assert(context.build().back().content.size() == 5000);
+
+    std::cout << "testChatContext is OK\n";
+}
+
+static void testCatalogRetriever()
+{
+    // 1) Kinds and price bounds come from the wording
+    SimilarityFilter f = CatalogRetriever::parseFilter("Which bronze sculptures are under 5k?");
+    assert(f.kinds.size() == 1 && f.kinds[0] == ArtKind::Sculpture && f.maxPrice == 5000.0);
+    f = CatalogRetriever::parseFilter("paintings between $1,200 and 2.5k");
+    assert(f.minPrice == 1200.0 && f.maxPrice == 2500.0);
+    assert(CatalogRetriever::parseFilter("tell me a joke").empty());
+
+    // 2) Kind, location and price narrow the records; words rank them
+    auto repo = std::make_shared<ArtRepository>();
+    repo->add(std::make_shared<Sculpture>("Bronze horse", "rearing stallion", 4000.0, "Albertina, Vienna", "Bronze", ""));
+    repo->add(std::make_shared<Sculpture>("Marble bust", "roman senator", 3000.0, "Belvedere, Vienna", "Marble", ""));
+    repo->add(std::make_shared<Sculpture>("Bronze owl", "small owl", 9000.0, "Leopold Museum, Vienna", "Bronze", ""));
+    repo->add(std::make_shared<Sculpture>("Bronze deer", "grazing deer", 2000.0, "Louvre, Paris", "Bronze", ""));
+    repo->add(std::make_shared<Painting>("Bronze light", "a bronze evening", 1000.0, "Albertina, Vienna", "Oil", ""));
+    SimilarityIndex index(repo);
+    CatalogRetriever retriever(repo, index);
+    auto result = retriever.retrieve("which bronze sculptures in Vienna are under 5k?");
+    assert(result.filter.locations.size() == 3);
+    assert(result.records == 2);
+    assert(result.context.find("Bronze horse") < result.context.find("Marble bust"));
+    assert(result.context.find("Bronze owl") == std::string::npos);
+    assert(result.context.find("Louvre") == std::string::npos);
+
+    // 3) The context is bounded by k, not by the catalog
+    for (int i = 0; i < 500; ++i) {
+        repo->add(std::make_shared<Sculpture>("Bronze cast " + std::to_string(i), std::string(400, 'x'),
+                                              100.0 + i, "Albertina, Vienna", "Bronze", ""));
+    }
+    result = retriever.retrieve("bronze sculptures in vienna", 4);
+    assert(result.records == 4 && result.context.size() < 4 * 400);
+
+    // 4) Small talk gets no catalog context; a question nothing matches says so
+    assert(retriever.retrieve("hello there").context.empty());
+    result = retriever.retrieve("digital art over 1m");
+    assert(result.records == 0 && result.context.find("No catalog records") == 0);
+
+    // 5) Grounding sits right before the question and counts toward the budget
+    ChatContext context(1000, "system prompt");
+    for (int turn = 0; turn < 60; ++turn) context.add("user", std::string(100, 'q'));
+    const auto built = context.build(std::string(400, 'g'));
+    assert(built[built.size() - 2].content == std::string(400, 'g'));
+    std::size_t tokens = 0;
+    for (const auto& m : built) tokens += ChatContext::estimateTokens(m.content);
+    assert(tokens <= 1000);
+
+    std::cout << "testCatalogRetriever is OK\n";
+}
+
+static void testResponseCache()
+{
+    QTemporaryDir dir;
+    assert(dir.isValid());
+    const QUrl endpoint("http://localhost:8080/v1/chat/completions");
+    const std::vector<ChatMessage> asked = {{"system", "prompt"}, {"user", "Which  bronze sculptures?"}};
+    const std::vector<ChatMessage> same  = {{"system", "prompt"}, {"user", " which bronze sculptures? "}};
+
+    // 1) Keys ignore spacing and case of the question, not the model
+    const QByteArray key = ResponseCache::key(endpoint, "m", asked);
+    assert(key == ResponseCache::key(endpoint, "m", same));
+    assert(key != ResponseCache::key(endpoint, "other", asked));
+    assert(key != ResponseCache::key(QUrl("http://elsewhere/"), "m", asked));
+
+    // 2) Stored replies survive a restart
+    {
+        ResponseCache cache(dir.path());
+        QString text;
+        assert(!cache.lookup(key, &text));
+        cache.insert(key, "Two of them.");
+        assert(cache.lookup(key, &text) && text == "Two of them.");
+    }
+    {
+        ResponseCache cache(dir.path());
+        QString text;
+        assert(cache.entryCount() == 1 && cache.lookup(key, &text) && text == "Two of them.");
+    }
+
+    // 3) Old replies expire
+    {
+        QFile file(dir.filePath(QString::fromLatin1(key) + ".txt"));
+        assert(file.open(QIODevice::ReadWrite));
+        assert(file.setFileTime(QDateTime::currentDateTime().addDays(-2),
+                                QFileDevice::FileModificationTime));
+    }
+    {
+        ResponseCache cache(dir.path(), ResponseCache::kDefaultMaxBytes, 24 * 3600);
+        assert(cache.entryCount() == 0 && !cache.lookup(key, nullptr));
+    }
+
+    // 4) Past the size limit the least recently used reply goes
+    {
+        ResponseCache cache(dir.path(), 25);
+        const QByteArray a = ResponseCache::key(endpoint, "m", {{"user", "a"}});
+        const QByteArray b = ResponseCache::key(endpoint, "m", {{"user", "b"}});
+        const QByteArray c = ResponseCache::key(endpoint, "m", {{"user", "c"}});
+        cache.insert(a, "0123456789");
+        cache.insert(b, "0123456789");
+        assert(cache.lookup(a, nullptr));
+        cache.insert(c, "0123456789");
+        assert(cache.lookup(a, nullptr) && !cache.lookup(b, nullptr) && cache.lookup(c, nullptr));
+        assert(cache.totalBytes() <= 25);
+    }
+
+    std::cout << "testResponseCache is OK\n";
+}
+
+static void testRetryAndLatency()
+{
+    // 1) Only overload and gateway answers are retried
+    assert(RetryPolicy::retryableStatus(429) && RetryPolicy::retryableStatus(503));
+    assert(!RetryPolicy::retryableStatus(400) && !RetryPolicy::retryableStatus(401)
+           && !RetryPolicy::retryableStatus(200));
+
+    // 2) Backoff doubles up to the cap, jitter picks within it, and
+    //    Retry-After is a floor
+    RetryPolicy policy;
+    policy.baseDelayMs = 100;
+    policy.maxDelayMs  = 1000;
+    assert(policy.delayMs(1, 0.999) < 100 && policy.delayMs(2, 0.999) > 100);
+    assert(policy.delayMs(3, 0.5) == 200 && policy.delayMs(10, 0.5) == 500);
+    assert(policy.delayMs(1, 0.0) == 0 && policy.delayMs(1, 0.0, 2000) == 2000);
+
+    // 3) Histogram percentiles report the bucket bound
+    LatencyHistogram h;
+    assert(h.percentile(0.5) == 0 && h.count() == 0);
+    for (int i = 0; i < 90; ++i) h.record(30);      // 20..50 ms bucket
+    for (int i = 0; i < 10; ++i) h.record(1500);    // 1..2 s bucket
+    assert(h.count() == 100 && h.bucket(5) == 90);
+    assert(h.percentile(0.5) == 50 && h.percentile(0.9) == 50 && h.percentile(0.95) == 1500);
+    h.record(90000);                                // past the last bound
+    assert(h.bucket(LatencyHistogram::kBuckets - 1) == 1 && h.percentile(1.0) == 90000);
+    assert(h.summary().find("n=101") == 0);
+
+    std::cout << "testRetryAndLatency is OK\n";
+}
+
+static void testChatTranscript()
+{
+    ChatTranscriptModel model;
+    ChatTranscriptView view;
+    view.setModel(&model);
+    view.setAttribute(Qt::WA_DontShowOnScreen);
+    view.resize(400, 300);
+    view.show();   // lays out the viewport
+
+    // 1) Each new message is laid out once, however long the session
+    for (int i = 0; i < 2000; ++i) {
+        model.append(i % 2 ? "Bot" : "You", "message " + QString::number(i) + " " + QString(i % 300, 'w'));
+    }
+    const quint64 built = view.layoutsBuilt();
+    model.append("You", "one more");
+    assert(view.layoutsBuilt() == built + 1);
+    assert(view.cachedLayouts() <= ChatTranscriptView::kCachedLayouts);
+
+    // 2) A streamed reply re-lays out only itself
+    const int row = model.append("Bot", QString());
+    for (int i = 0; i < 50; ++i) model.appendText(row, "token ");
+    assert(view.layoutsBuilt() == built + 2 + 50);
+    assert(model.textAt(row).size() == 300);
+
+    // 3) The view followed the new text to the bottom
+    view.scrollToBottom();
+    assert(view.rowAt(view.viewport()->height() - 1) == row);
+    assert(view.rowAt(-1000000) == -1);
+
+    // 4) A new width lays out the rows on screen, not the whole session,
+    //    and still ends on the last message
+    const quint64 beforeResize = view.layoutsBuilt();
+    view.resize(250, 300);
+    const quint64 onScreen = view.layoutsBuilt() - beforeResize;
+    assert(onScreen > 0 && onScreen < 200);
+    assert(view.rowAt(view.viewport()->height() - 1) == row);
+
+    // 5) The others are measured as they scroll into view
+    view.verticalScrollBar()->setValue(0);
+    assert(view.rowAt(0) == 0);
+    assert(view.layoutsBuilt() - beforeResize < 2 * onScreen + 200);
+    assert(view.rowAt(view.viewport()->height() - 1) < 200);
+
+    std::cout << "testChatTranscript is OK\n";
+}
+
+static void testChatTelemetry()
+{
+    // 1) Tokens/s counts generation only, from the first token on
+    ChatRequestMetrics m;
+    m.id = 7;
+    m.model = "vendor/\"model\"";
+    m.outcome = "ok";
+    m.completionTokens = 101;
+    m.ttfbMs = 200;
+    m.ttftMs = 500;
+    m.totalMs = 2500;
+    assert(m.tokensPerSecond() == 50.0);
+    ChatRequestMetrics none = m;
+    none.ttftMs = -1;
+    assert(none.tokensPerSecond() == 0.0);
+
+    // 2) One JSON line, quotes escaped
+    const std::string line = m.toJson();
+    assert(line.front() == '{' && line.back() == '}' && line.find('\n') == std::string::npos);
+    assert(line.find("\"model\":\"vendor/\\\"model\\\"\"") != std::string::npos);
+    assert(line.find("\"ttft_ms\":500.0") != std::string::npos);
+    assert(line.find("\"tokens_per_s\":50.0") != std::string::npos);
+
+    // 3) Replies from the cache are counted but not timed
+    ChatTelemetry telemetry;
+    for (int i = 0; i < 9; ++i) telemetry.record(m);
+    ChatRequestMetrics slow = m;
+    slow.outcome = "timeout";
+    slow.ttftMs = -1;
+    slow.totalMs = 30000;
+    telemetry.record(slow);
+    ChatRequestMetrics cached = m;
+    cached.outcome = "cached";
+    cached.totalMs = 1;
+    telemetry.record(cached);
+    assert(telemetry.requests() == 10 && telemetry.local() == 1);
+    assert(telemetry.total().count() == 10 && telemetry.ttft().count() == 9);
+    assert(telemetry.total().percentile(0.5) == 5000 && telemetry.total().percentile(1.0) == 30000);
+    assert(telemetry.meanTokensPerSecond() == 50.0);
+    assert(telemetry.summary().find("10 sent (1 failed), 1 from cache") == 0);
+
+    std::cout << "testChatTelemetry is OK\n";
+}
+
+static void testCatalogGenerator()
+{
+    CatalogSpec spec;
+    spec.seed = 7;
+    spec.locations = 50;
+
+    // 1) The same seed writes the same bytes; record i does not depend on
+    //    where the file starts
+    const CatalogGenerator generator(spec);
+    std::ostringstream a, b;
+    generator.write(a, CatalogGenerator::Format::Csv, 300);
+    const std::uint64_t bytes = generator.write(b, CatalogGenerator::Format::Csv, 300);
+    assert(a.str() == b.str() && bytes == a.str().size());
+    std::ostringstream shard;
+    generator.write(shard, CatalogGenerator::Format::Csv, 1, 299);
+    const std::string last = CatalogGenerator::csvRow(generator.record(299));
+    assert(shard.str().size() > last.size()
+           && shard.str().compare(shard.str().size() - last.size(), last.size(), last) == 0);
+    spec.seed = 8;
+    std::ostringstream other;
+    CatalogGenerator(spec).write(other, CatalogGenerator::Format::Csv, 300);
+    assert(other.str() != a.str());
+
+    // 2) Type mix, price bounds and location cardinality follow the spec,
+    //    the first location being the most frequent
+    std::map<std::string, int> types, locations;
+    for (std::uint64_t i = 0; i < 20000; ++i) {
+        const CatalogGenerator::Record r = generator.record(i);
+        ++types[r.type];
+        ++locations[r.location];
+        assert(r.price >= spec.minPrice && r.price <= spec.maxPrice);
+        assert(r.type != "DigitalArt" || r.resolutionX > 0);
+    }
+    assert(types["Painting"] > 9500 && types["Painting"] < 10500);
+    assert(types["DigitalArt"] > 3600 && types["DigitalArt"] < 4400);
+    assert(locations.size() <= 50 && locations.size() > 40);
+    for (const auto& entry : locations) assert(entry.second <= locations[generator.locationName(0)]);
+
+    // 3) Awkward content shows up at the requested rates, escaped
+    spec.quoteRate = 1.0;
+    spec.newlineRate = 1.0;
+    spec.unicodeRate = 1.0;
+    const CatalogGenerator awkward(spec);
+    const CatalogGenerator::Record r = awkward.record(3);
+    assert(r.name.find(',') != std::string::npos && r.description.find('"') != std::string::npos);
+    assert(r.description.find('\n') != std::string::npos);
+    const std::string row = CatalogGenerator::csvRow(r);
+    assert(row.find("\"\"") != std::string::npos && row.back() == '\n');
+    const std::string json = CatalogGenerator::jsonObject(r);
+    assert(json.find('\n') == std::string::npos && json.find("\\n") != std::string::npos);
+
+    // 4) Art objects carry the record's fields
+    const auto art = awkward.art(3);
+    assert(art->getType() == r.type && art->getName() == r.name && art->getPrice() == r.price);
+
+    std::cout << "testCatalogGenerator is OK\n";
+}
+
+// Generated files load back through the repositories, quoted commas,
+// quotes and line breaks included
+static void testGeneratedCatalogLoads()
+{
+    CatalogSpec spec;
+    spec.quoteRate = 0.3;
+    spec.newlineRate = 0.3;
+    spec.unicodeRate = 0.3;
+    const CatalogGenerator generator(spec);
+    constexpr std::uint64_t kRecords = 2000;
+
+    QTemporaryDir dir;
+    assert(dir.isValid());
+    for (const auto format : {CatalogGenerator::Format::Csv, CatalogGenerator::Format::Json}) {
+        const QString path = dir.filePath(QString("catalog.") + CatalogGenerator::formatName(format));
+        {
+            std::ostringstream out;
+            generator.write(out, format, kRecords);
+            QFile file(path);
+            assert(file.open(QIODevice::WriteOnly));
+            file.write(QByteArray::fromStdString(out.str()));
+        }
+        std::unique_ptr<ArtRepositoryInterface> repo;
+        if (format == CatalogGenerator::Format::Csv) repo = std::make_unique<CsvRepository>();
+        else repo = std::make_unique<JsonRepository>();
+        assert(repo->loadFromFile(path));
+        assert(repo->size() == kRecords);
+        for (std::uint64_t i = 0; i < kRecords; i += 7) {
+            const CatalogGenerator::Record r = generator.record(i);
+            const auto art = repo->get(std::size_t(i));
+            assert(art->getType() == r.type && art->getName() == r.name);
+            assert(art->getDescription() == r.description && art->getLocation() == r.location);
+            assert(art->getPrice() == r.price);
+        }
+    }
+
+    std::cout << "testGeneratedCatalogLoads is OK\n";
+}
+
 void runAllTests()
 {
     testAddUndoRedo();
     testRemoveUndoRedo();
     testEditUndoRedo();
     testMixedUndoRedoSequence();
+    testCompositeUndoRedo();
+    testRemoveManyUndoRedo();
+    testCommandsFindTheirRecords();
+    testBatchNotifiesOnce();
+    testFieldEditMerge();
+    testUndoHistoryBudget();
+    testConcurrentSnapshots();
+    testTaskScheduler();
+    testAddManyUndoRedo();
+    testBoundedQueue();
+    testBloomFilter();
+    testNameIndex();
+    testNearDuplicateFinder();
+    testSimilarityIndex();
+    testSseParser();
+    testChatContext();
+    testCatalogRetriever();
+    testResponseCache();
+    testRetryAndLatency();
+    testChatTelemetry();
+    testChatTranscript();
+    testCatalogGenerator();
+    testGeneratedCatalogLoads();
+    testBulkImportUndo();
+    testUndoJournalRecovery();
     std::cout << "All tests passed successfully.\n";
 }
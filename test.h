@@ -2,7 +2,7 @@
 #ifndef TESTS_H
 #define TESTS_H
 
-/// Call this once at startup to run all of the repository/command tests.
+/// Runs all of the repository/command tests (the art_tests program).
 /// If any assertion fails, the program will abort.
 void runAllTests();
 
@@ -0,0 +1,10 @@
+#include <QApplication>
+#include "test.h"
+
+// Widget tests need a QApplication but no screen: ctest runs this with
+// QT_QPA_PLATFORM=offscreen
+int main(int argc, char *argv[]) {
+    QApplication app(argc, argv);
+    runAllTests();
+    return 0;
+}
@@ -0,0 +1,387 @@
+#include "ThumbnailDiskCache.h"
+
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+#include <QMutexLocker>
+#include <QDebug>
+
+#include <cstring>
+
+namespace {
+
+constexpr char    kFileMagic[8]  = {'P', '1', 'T', 'H', 'U', 'M', 'B', '1'};
+constexpr qint64  kFileHeaderSize = 16;
+constexpr quint32 kRecordMagic   = 0x52435454u;   // "TTCR"
+// Tail windows kept before they are merged into one mapping again
+constexpr std::size_t kMaxWindows = 16;
+
+struct RecordHeader {
+    quint32 magic;
+    qint32  width;
+    qint32  height;
+    qint32  bytesPerLine;
+    quint64 slot;
+    quint64 stamp;
+    quint64 pathHash;
+    quint64 payloadSize;
+};
+static_assert(sizeof(RecordHeader) == 48, "record header must stay packed");
+
+// Keep every record header 8-byte aligned inside the mapping.
+constexpr qint64 padded(qint64 n) { return (n + 7) & ~qint64(7); }
+
+quint64 hash64(const QByteArray& data)
+{
+    const QByteArray digest = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    quint64 h = 0;
+    std::memcpy(&h, digest.constData(), sizeof(h));
+    return h;
+}
+
+} // namespace
+
+ThumbnailDiskCache::ThumbnailDiskCache(const QString& filePath)
+    : filePath_(filePath)
+{
+    QMutexLocker lock(&mutex_);
+    if (openFile()) scan();
+}
+
+ThumbnailDiskCache::~ThumbnailDiskCache()
+{
+    QMutexLocker lock(&mutex_);
+    unmap();
+    file_.close();
+}
+
+QString ThumbnailDiskCache::defaultPath()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir().mkpath(dir);
+    return dir + "/thumbnails.bin";
+}
+
+bool ThumbnailDiskCache::isOpen() const
+{
+    QMutexLocker lock(&mutex_);
+    return file_.isOpen();
+}
+
+int ThumbnailDiskCache::entryCount() const
+{
+    QMutexLocker lock(&mutex_);
+    return index_.size();
+}
+
+// ── Keys ──
+quint64 ThumbnailDiskCache::slotHash(const QString& imagePath, const QSize& size)
+{
+    return hash64(QString("%1@%2x%3").arg(imagePath).arg(size.width())
+                      .arg(size.height()).toUtf8());
+}
+
+quint64 ThumbnailDiskCache::pathHash(const QString& imagePath)
+{
+    return hash64(imagePath.toUtf8());
+}
+
+bool ThumbnailDiskCache::stampFor(const QString& imagePath, quint64* stamp)
+{
+    QFileInfo info(imagePath);
+    if (!info.exists()) return false;
+    *stamp = hash64(QByteArray::number(info.lastModified().toMSecsSinceEpoch())
+                    + ':' + QByteArray::number(info.size()));
+    return true;
+}
+
+// ── Lookup / insert ──
+bool ThumbnailDiskCache::lookup(const QString& imagePath, const QSize& size, QImage* out)
+{
+    quint64 stamp = 0;
+    if (!stampFor(imagePath, &stamp)) return false;
+
+    QMutexLocker lock(&mutex_);
+    auto it = index_.constFind(slotHash(imagePath, size));
+    if (it == index_.constEnd() || it->stamp != stamp) return false;
+
+    const Entry e = *it;
+    const uchar* record = mapped(e.offset, e.length);
+    if (!record) return false;
+
+    const uchar* pixels = record + sizeof(RecordHeader);
+    // Copy out of the mapping: the file may be remapped or compacted later.
+    QImage view(pixels, e.width, e.height, e.bytesPerLine,
+                QImage::Format_ARGB32_Premultiplied);
+    if (out) *out = view.copy();
+    return true;
+}
+
+void ThumbnailDiskCache::insert(const QString& imagePath, const QSize& size, const QImage& image)
+{
+    if (image.isNull()) return;
+    quint64 stamp = 0;
+    if (!stampFor(imagePath, &stamp)) return;
+
+    const QImage img = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    RecordHeader h{};
+    h.magic        = kRecordMagic;
+    h.width        = img.width();
+    h.height       = img.height();
+    h.bytesPerLine = static_cast<qint32>(img.bytesPerLine());
+    h.slot         = slotHash(imagePath, size);
+    h.stamp        = stamp;
+    h.pathHash     = pathHash(imagePath);
+    h.payloadSize  = static_cast<quint64>(img.sizeInBytes());
+
+    const qint64 length = padded(sizeof(RecordHeader) + img.sizeInBytes());
+    static const char zeros[8] = {};
+
+    QMutexLocker lock(&mutex_);
+    if (!file_.isOpen()) return;
+
+    const qint64 offset = file_.size();
+    if (!file_.seek(offset)) return;
+    bool ok = file_.write(reinterpret_cast<const char*>(&h), sizeof(h)) == qint64(sizeof(h))
+           && file_.write(reinterpret_cast<const char*>(img.constBits()), img.sizeInBytes())
+                  == img.sizeInBytes();
+    const qint64 pad = length - qint64(sizeof(h)) - img.sizeInBytes();
+    if (ok && pad > 0) ok = file_.write(zeros, pad) == pad;
+    file_.flush();
+    if (!ok) {
+        qWarning() << "Cannot append to thumbnail cache:" << filePath_;
+        file_.resize(offset);
+        return;
+    }
+
+    Entry e;
+    e.stamp        = h.stamp;
+    e.pathHash     = h.pathHash;
+    e.offset       = offset;
+    e.length       = length;
+    e.width        = h.width;
+    e.height       = h.height;
+    e.bytesPerLine = h.bytesPerLine;
+
+    auto old = index_.find(h.slot);
+    if (old != index_.end()) {
+        garbage_ += old->length;
+        *old = e;
+    } else {
+        index_.insert(h.slot, e);
+    }
+}
+
+// ── Eviction ──
+void ThumbnailDiskCache::prune(const QSet<QString>& livePaths)
+{
+    QSet<quint64> live;
+    live.reserve(livePaths.size());
+    for (const QString& p : livePaths) live.insert(pathHash(p));
+
+    QHash<quint64, Entry> snapshot;
+    qint64 snapshotEnd = 0;
+    {
+        QMutexLocker lock(&mutex_);
+        for (auto it = index_.begin(); it != index_.end(); ) {
+            if (!live.contains(it->pathHash)) {
+                garbage_ += it->length;
+                it = index_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // Rewrite once a quarter of the file is dead weight
+        if (compacting_ || !file_.isOpen() || garbage_ == 0 || garbage_ * 4 < file_.size()) return;
+        compacting_ = true;
+        snapshot    = index_;
+        snapshotEnd = file_.size();
+    }
+    compact(snapshot, snapshotEnd);
+}
+
+// ── File handling (mutex held) ──
+bool ThumbnailDiskCache::openFile()
+{
+    file_.setFileName(filePath_);
+    if (!file_.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open thumbnail cache:" << filePath_;
+        return false;
+    }
+
+    char magic[sizeof(kFileMagic)] = {};
+    const bool valid = file_.size() >= kFileHeaderSize
+                    && file_.read(magic, sizeof(magic)) == qint64(sizeof(magic))
+                    && std::memcmp(magic, kFileMagic, sizeof(magic)) == 0;
+    if (!valid) {
+        // New file, or one written by an incompatible version: start over
+        QByteArray header(kFileHeaderSize, '\0');
+        std::memcpy(header.data(), kFileMagic, sizeof(kFileMagic));
+        file_.resize(0);
+        file_.seek(0);
+        file_.write(header);
+        file_.flush();
+    }
+    return true;
+}
+
+void ThumbnailDiskCache::scan()
+{
+    index_.clear();
+    garbage_ = 0;
+
+    const qint64 size = file_.size();
+    const uchar* base = mapped(0, size);
+    if (!base) return;
+
+    qint64 pos = kFileHeaderSize;
+    while (pos + qint64(sizeof(RecordHeader)) <= size) {
+        RecordHeader h;
+        std::memcpy(&h, base + pos, sizeof(h));
+        const qint64 length = padded(sizeof(RecordHeader) + qint64(h.payloadSize));
+        if (h.magic != kRecordMagic || h.width <= 0 || h.height <= 0
+            || qint64(h.payloadSize) != qint64(h.bytesPerLine) * h.height
+            || pos + length > size) {
+            break;
+        }
+
+        Entry e;
+        e.stamp        = h.stamp;
+        e.pathHash     = h.pathHash;
+        e.offset       = pos;
+        e.length       = length;
+        e.width        = h.width;
+        e.height       = h.height;
+        e.bytesPerLine = h.bytesPerLine;
+
+        auto old = index_.find(h.slot);
+        if (old != index_.end()) {
+            garbage_ += old->length;   // a later record superseded it
+            *old = e;
+        } else {
+            index_.insert(h.slot, e);
+        }
+        pos += length;
+    }
+
+    if (pos < size) {
+        // Torn write from a crash: drop the incomplete tail
+        unmap();
+        file_.resize(pos);
+    }
+}
+
+// Pointer to [offset, offset + length) of the file. Growth since the
+// last call is mapped as a new window rather than remapping the file.
+const uchar* ThumbnailDiskCache::mapped(qint64 offset, qint64 length)
+{
+    const qint64 end = offset + length;
+    if (end > mappedEnd_) {
+        const qint64 size = file_.size();
+        if (end > size) return nullptr;
+        if (windows_.size() >= kMaxWindows) unmap();   // start over as one window
+        uchar* data = file_.map(mappedEnd_, size - mappedEnd_);
+        if (!data) return nullptr;
+        windows_.push_back({mappedEnd_, size - mappedEnd_, data});
+        mappedEnd_ = size;
+    }
+    for (auto it = windows_.rbegin(); it != windows_.rend(); ++it) {
+        if (offset >= it->start && end <= it->start + it->size) return it->data + (offset - it->start);
+    }
+    return nullptr;
+}
+
+void ThumbnailDiskCache::unmap()
+{
+    for (const Window& w : windows_) file_.unmap(w.data);
+    windows_.clear();
+    mappedEnd_ = 0;
+}
+
+// ── Compaction (mutex not held) ──
+// Copies the records of 'snapshot' (the index when the file was
+// 'snapshotEnd' bytes long) to a new file through a handle of its own.
+// Records are only ever appended meanwhile, so the copied bytes cannot
+// change. Under the lock at the end, records appended since are copied
+// too and the new file is swapped in.
+bool ThumbnailDiskCache::compact(const QHash<quint64, Entry>& snapshot, qint64 snapshotEnd)
+{
+    const QString tmpPath = filePath_ + ".compact";
+    QFile src(filePath_);
+    QFile out(tmpPath);
+    auto fail = [&]() {
+        out.close();
+        QFile::remove(tmpPath);
+        QMutexLocker lock(&mutex_);
+        compacting_ = false;
+        return false;
+    };
+    if (!src.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return fail();
+    }
+    auto copy = [&out](QFile& from, qint64 offset, qint64 length) {
+        return from.seek(offset) && out.write(from.read(length)) == length;
+    };
+
+    if (!copy(src, 0, kFileHeaderSize)) return fail();
+    QHash<quint64, Entry> moved;
+    moved.reserve(snapshot.size());
+    qint64 pos = kFileHeaderSize;
+    for (auto it = snapshot.constBegin(); it != snapshot.constEnd(); ++it) {
+        Entry e = *it;
+        if (!copy(src, e.offset, e.length)) return fail();
+        e.offset = pos;
+        pos += e.length;
+        moved.insert(it.key(), e);
+    }
+    src.close();
+
+    QMutexLocker lock(&mutex_);
+    compacting_ = false;
+
+    // Whatever was superseded or pruned meanwhile is garbage in the new file
+    QHash<quint64, Entry> index;
+    index.reserve(index_.size());
+    qint64 garbage = 0;
+    for (auto it = index_.constBegin(); it != index_.constEnd(); ++it) {
+        auto before = snapshot.constFind(it.key());
+        if (before != snapshot.constEnd() && before->offset == it->offset) {
+            index.insert(it.key(), moved.value(it.key()));
+            continue;
+        }
+        // Appended after the snapshot
+        Entry e = *it;
+        if (e.offset < snapshotEnd || !copy(file_, e.offset, e.length)) {
+            out.close();
+            QFile::remove(tmpPath);
+            return false;
+        }
+        e.offset = pos;
+        pos += e.length;
+        index.insert(it.key(), e);
+    }
+    for (auto it = moved.constBegin(); it != moved.constEnd(); ++it) {
+        auto now = index.constFind(it.key());
+        if (now == index.constEnd() || now->offset != it->offset) garbage += it->length;
+    }
+    out.close();
+
+    unmap();
+    file_.close();
+    QFile::remove(filePath_);
+    if (!QFile::rename(tmpPath, filePath_)) {
+        qWarning() << "Cannot replace thumbnail cache:" << filePath_;
+        index_.clear();
+        garbage_ = 0;
+        return openFile();
+    }
+    if (!openFile()) return false;
+
+    index_   = index;
+    garbage_ = garbage;
+    return true;
+}
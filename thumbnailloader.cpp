@@ -0,0 +1,263 @@
+#include "ThumbnailLoader.h"
+#include "ThumbnailDiskCache.h"
+
+#include <QImageReader>
+#include <QFileInfo>
+#include <QMetaObject>
+
+namespace {
+// Default in-memory budget for decoded thumbnails.
+constexpr qint64 kDefaultCacheBytes = 64LL * 1024 * 1024;
+}
+
+ThumbnailLoader::ThumbnailLoader(QObject* parent)
+    : QObject(parent)
+{
+    cache_.setMaxCost(kDefaultCacheBytes);
+}
+
+ThumbnailLoader::~ThumbnailLoader()
+{
+    cancelPending(Priority::Interactive);
+    cancelPending(Priority::Prefetch);
+    tasks_.cancel();
+    tasks_.wait();
+}
+
+QString ThumbnailLoader::cacheKey(const QString& path, const QSize& size)
+{
+    return QString("%1@%2x%3").arg(path).arg(size.width()).arg(size.height());
+}
+
+void ThumbnailLoader::setDiskCache(std::shared_ptr<ThumbnailDiskCache> disk)
+{
+    disk_ = std::move(disk);
+}
+
+bool ThumbnailLoader::lookup(const QString& path, const QSize& size, QImage* out)
+{
+    const QString key = cacheKey(path, size);
+    if (QImage* hit = cache_.object(key)) {   // also bumps LRU order
+        ++stats_.memoryHits;
+        if (prefetched_.remove(key)) ++stats_.prefetchUsed;
+        if (out) *out = *hit;
+        return true;
+    }
+
+    // A disk hit is a stat() and a copy out of the mapping: cheap enough
+    // to do right here and skip the placeholder entirely.
+    QImage stored;
+    if (!disk_ || !disk_->lookup(path, size, &stored)) {
+        ++stats_.misses;
+        return false;
+    }
+    ++stats_.diskHits;
+    cache_.insert(key, new QImage(stored), stored.sizeInBytes());
+    if (out) *out = stored;
+    return true;
+}
+
+void ThumbnailLoader::request(const QString& path, const QSize& size, Priority priority)
+{
+    if (path.isEmpty() || size.isEmpty()) return;
+
+    const QString key = cacheKey(path, size);
+    if (cache_.contains(key)) return;
+
+    auto it = inFlight_.find(key);
+    if (it != inFlight_.end()) {
+        JobPtr job = it.value();
+        if (priority == Priority::Interactive && job->priority == Priority::Prefetch) {
+            if (prefetched_.remove(key)) ++stats_.prefetchUsed;
+            if (job->started.load()) {
+                // Already decoding: just keep it from being cancelled
+                // together with the rest of the prefetch window.
+                job->priority = Priority::Interactive;
+            } else {
+                job->cancelled.store(true);
+                inFlight_.erase(it);
+                start(key, path, size, priority);
+            }
+        }
+        return;
+    }
+
+    start(key, path, size, priority);
+}
+
+void ThumbnailLoader::prefetch(const QStringList& paths, const QSize& size, qint64 budgetBytes)
+{
+    if (size.isEmpty()) return;
+
+    QSet<QString> window;
+    window.reserve(paths.size());
+    for (const QString& path : paths) {
+        if (!path.isEmpty()) window.insert(cacheKey(path, size));
+    }
+
+    // Forget whatever fell out of the window
+    qint64 used = 0;
+    for (auto it = prefetched_.begin(); it != prefetched_.end(); ) {
+        if (window.contains(it.key())) {
+            used += it.value();
+            ++it;
+            continue;
+        }
+        auto job = inFlight_.find(it.key());
+        if (job != inFlight_.end() && job.value()->priority == Priority::Prefetch) {
+            job.value()->cancelled.store(true);
+            inFlight_.erase(job);
+        } else {
+            ++stats_.prefetchWasted;
+        }
+        it = prefetched_.erase(it);
+    }
+
+    const qint64 estimate = qint64(size.width()) * size.height() * 4;
+    for (const QString& path : paths) {
+        if (path.isEmpty()) continue;
+        const QString key = cacheKey(path, size);
+        if (prefetched_.contains(key) || cache_.contains(key) || inFlight_.contains(key)) continue;
+        if (used + estimate > budgetBytes) break;
+
+        used += estimate;
+        prefetched_.insert(key, estimate);
+        ++stats_.prefetchIssued;
+        start(key, path, size, Priority::Prefetch);
+    }
+}
+
+void ThumbnailLoader::cancelPending(Priority priority)
+{
+    for (auto it = inFlight_.begin(); it != inFlight_.end(); ) {
+        if (it.value()->priority != priority) {
+            ++it;
+            continue;
+        }
+        it.value()->cancelled.store(true);
+        prefetched_.remove(it.key());
+        it = inFlight_.erase(it);
+    }
+}
+
+void ThumbnailLoader::retain(const QSet<QString>& paths, const QSize& size)
+{
+    QSet<QString> keep;
+    keep.reserve(paths.size());
+    for (const QString& path : paths) keep.insert(cacheKey(path, size));
+
+    for (auto it = inFlight_.begin(); it != inFlight_.end(); ) {
+        if (it.value()->priority != Priority::Interactive || keep.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        it.value()->cancelled.store(true);
+        it = inFlight_.erase(it);
+    }
+}
+
+void ThumbnailLoader::start(const QString& key, const QString& path,
+                            const QSize& size, Priority priority)
+{
+    JobPtr job = std::make_shared<Job>();
+    job->priority = priority;
+    inFlight_.insert(key, job);
+
+    // The job's flag doubles as the scheduler's cancel token
+    TaskScheduler::CancelToken token(job, &job->cancelled);
+    const auto schedulerPriority = priority == Priority::Interactive
+        ? TaskScheduler::Priority::Thumbnail : TaskScheduler::Priority::Prefetch;
+
+    std::shared_ptr<ThumbnailDiskCache> disk = disk_;
+    tasks_.submit(schedulerPriority, [this, key, path, size, job, disk]() {
+        if (job->cancelled.load()) return;    // cancelled before it started
+        job->started.store(true);
+
+        QImage image;
+        if (!disk || !disk->lookup(path, size, &image)) {
+            image = decode(path, size);
+            if (disk && !image.isNull()) disk->insert(path, size, image);
+        }
+        if (job->cancelled.load()) return;    // cancelled while decoding
+
+        QMetaObject::invokeMethod(this, [this, key, path, size, job, image]() {
+            deliver(key, path, size, job, image);
+        }, Qt::QueuedConnection);
+    }, std::move(token));
+}
+
+void ThumbnailLoader::pruneDiskCache(const QSet<QString>& livePaths)
+{
+    if (!disk_) return;
+    std::shared_ptr<ThumbnailDiskCache> disk = disk_;
+    tasks_.submit(TaskScheduler::Priority::Compaction, [disk, livePaths]() {
+        disk->prune(livePaths);
+    });
+}
+
+void ThumbnailLoader::setCacheLimit(qint64 bytes)
+{
+    cache_.setMaxCost(bytes);
+}
+
+qint64 ThumbnailLoader::cacheLimit() const noexcept
+{
+    return cache_.maxCost();
+}
+
+qint64 ThumbnailLoader::cacheUsage() const noexcept
+{
+    return cache_.totalCost();
+}
+
+const ThumbnailLoader::Stats& ThumbnailLoader::stats() const noexcept
+{
+    return stats_;
+}
+
+// ── Worker side ──
+QImage ThumbnailLoader::decode(const QString& path, const QSize& size)
+{
+    if (!QFileInfo::exists(path)) return {};
+
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+
+    // Let the codec downscale while decoding (JPEG can skip most of the
+    // work this way) instead of decoding the full image and scaling after.
+    const QSize full = reader.size();
+    QSize target = size;
+    if (full.isValid()) {
+        target = full.scaled(size, Qt::KeepAspectRatio);
+        reader.setScaledSize(target);
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) return {};
+
+    if (image.width() > size.width() || image.height() > size.height()) {
+        image = image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+// ── GUI side ──
+void ThumbnailLoader::deliver(const QString& key, const QString& path,
+                              const QSize& size, const JobPtr& job,
+                              const QImage& image)
+{
+    // A newer request for the same key replaces the job; only the
+    // current one may deliver.
+    auto it = inFlight_.find(key);
+    if (it == inFlight_.end() || it.value() != job) return;
+    inFlight_.erase(it);
+    if (job->cancelled.load()) return;
+
+    if (image.isNull()) {
+        emit thumbnailFailed(path, size);
+        return;
+    }
+
+    cache_.insert(key, new QImage(image), image.sizeInBytes());
+    emit thumbnailReady(path, size, image);
+}
@@ -0,0 +1,157 @@
+#include "UndoHistory.h"
+
+void UndoHistory::push(CommandPtr cmd)
+{
+    if (!cmd) return;
+
+    for (auto& e : redo_) usage_ -= e.cost;
+    redo_.clear();
+
+    if (!sealed_ && !undo_.empty() && undo_.back().cmd->mergeWith(*cmd)) {
+        if (listener_) listener_->commandPushed(*cmd, true);
+        Entry& top = undo_.back();
+        usage_ -= top.cost;
+        top.cost = top.cmd->memoryCost();
+        usage_ += top.cost;
+    } else {
+        if (listener_) listener_->commandPushed(*cmd, false);
+        Entry e;
+        e.cost = cmd->memoryCost();
+        e.cmd  = std::move(cmd);
+        usage_ += e.cost;
+        undo_.push_back(std::move(e));
+    }
+    sealed_ = false;
+    pushed_ = true;
+    if (undo_.back().cost > budget_) ++oversized_;
+    trim();
+}
+
+bool UndoHistory::undo()
+{
+    if (undo_.empty()) loadOlder();
+    if (undo_.empty()) return false;
+    Entry e = std::move(undo_.back());
+    undo_.pop_back();
+    e.cmd->undo();
+    redo_.push_back(std::move(e));
+    sealed_ = true;
+    if (listener_) listener_->commandUndone();
+    return true;
+}
+
+bool UndoHistory::redo()
+{
+    if (redo_.empty() && !pushed_) loadOlder();
+    if (redo_.empty()) return false;
+    Entry e = std::move(redo_.back());
+    redo_.pop_back();
+    e.cmd->execute();
+    undo_.push_back(std::move(e));
+    sealed_ = true;
+    if (listener_) listener_->commandRedone();
+    return true;
+}
+
+void UndoHistory::clear() noexcept
+{
+    undo_.clear();
+    redo_.clear();
+    usage_  = 0;
+    sealed_ = true;
+    olderLoader_ = nullptr;   // older steps would no longer line up
+    if (listener_) listener_->historyCleared();
+}
+
+void UndoHistory::loadOlder()
+{
+    if (!olderLoader_) return;
+    OlderLoader loader = std::move(olderLoader_);
+    olderLoader_ = nullptr;
+
+    // Once steps were dropped for the budget, older ones would leave a gap
+    if (dropped_ > 0) return;
+
+    std::vector<CommandPtr> undo, redo;
+    loader(undo, redo);
+
+    for (auto it = undo.rbegin(); it != undo.rend(); ++it) {
+        Entry e;
+        e.cost = (*it)->memoryCost();
+        e.cmd  = std::move(*it);
+        usage_ += e.cost;
+        undo_.push_front(std::move(e));
+    }
+    // The previous session's redo steps are only valid if this session
+    // has not moved on since
+    if (!pushed_ && redo_.empty()) {
+        for (auto& cmd : redo) {
+            Entry e;
+            e.cost = cmd->memoryCost();
+            e.cmd  = std::move(cmd);
+            usage_ += e.cost;
+            redo_.push_back(std::move(e));
+        }
+    }
+    trim();
+}
+
+void UndoHistory::restore(std::vector<CommandPtr> undo, std::vector<CommandPtr> redo)
+{
+    undo_.clear();
+    redo_.clear();
+    usage_  = 0;
+    sealed_ = true;
+    for (auto& cmd : undo) {
+        Entry e;
+        e.cost = cmd->memoryCost();
+        e.cmd  = std::move(cmd);
+        usage_ += e.cost;
+        undo_.push_back(std::move(e));
+    }
+    for (auto& cmd : redo) {
+        Entry e;
+        e.cost = cmd->memoryCost();
+        e.cmd  = std::move(cmd);
+        usage_ += e.cost;
+        redo_.push_back(std::move(e));
+    }
+    trim();
+}
+
+std::vector<const Command*> UndoHistory::undoCommands() const
+{
+    std::vector<const Command*> out;
+    out.reserve(undo_.size());
+    for (const auto& e : undo_) out.push_back(e.cmd.get());
+    return out;
+}
+
+std::vector<const Command*> UndoHistory::redoCommands() const
+{
+    std::vector<const Command*> out;
+    out.reserve(redo_.size());
+    for (const auto& e : redo_) out.push_back(e.cmd.get());
+    return out;
+}
+
+void UndoHistory::setMemoryBudget(std::size_t bytes)
+{
+    budget_ = bytes;
+    trim();
+}
+
+void UndoHistory::trim()
+{
+    // Oldest history goes first; keep the step the user just took
+    while (usage_ > budget_ && undo_.size() > 1) {
+        usage_ -= undo_.front().cost;
+        undo_.pop_front();
+        ++dropped_;
+    }
+    while (usage_ > budget_ && !redo_.empty()) {
+        usage_ -= redo_.front().cost;
+        redo_.pop_front();
+        ++dropped_;
+    }
+}
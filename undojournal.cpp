@@ -0,0 +1,504 @@
+#include "UndoJournal.h"
+#include "JsonRepository.h"
+
+#include <QCborValue>
+#include <QCborMap>
+#include <QCborArray>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QDebug>
+
+#include <cstring>
+
+namespace {
+
+constexpr char   kMagic[8]      = {'P', '1', 'U', 'N', 'D', 'O', '0', '1'};
+constexpr qint64 kHeaderSize    = sizeof(kMagic);
+// Rewrite the file at checkpoint time once it is bigger than this
+constexpr qint64 kCompactBytes  = 1024 * 1024;
+// Per record: leading length, op, trailing length
+constexpr qint64 kFrameOverhead = 4 + 1 + 4;
+
+QCborValue encodeArt(const std::shared_ptr<ArtObject>& art)
+{
+    if (!art) return QCborValue();
+    return QCborValue::fromJsonValue(JsonRepository::toJson(*art));
+}
+
+std::shared_ptr<ArtObject> decodeArt(const QCborValue& value)
+{
+    if (!value.isMap()) return nullptr;
+    const QJsonObject obj = value.toMap().toJsonObject();
+    if (auto art = JsonRepository::fromJson(obj)) return art;
+    return std::make_shared<ArtObject>(
+        obj.value("name").toString().toStdString(),
+        obj.value("description").toString().toStdString(),
+        obj.value("price").toDouble(),
+        obj.value("location").toString().toStdString(),
+        obj.value("imagePath").toString());
+}
+
+QCborValue encodeField(const FieldValue& v)
+{
+    if (auto text = std::get_if<std::string>(&v)) return QString::fromStdString(*text);
+    if (auto number = std::get_if<double>(&v))    return *number;
+    return static_cast<qint64>(std::get<int>(v));
+}
+
+FieldValue decodeField(const QCborValue& v)
+{
+    if (v.isString())  return v.toString().toStdString();
+    if (v.isInteger()) return static_cast<int>(v.toInteger());
+    return v.toDouble();
+}
+
+QCborMap encodeMap(const Command& cmd)
+{
+    QCborMap m;
+    if (auto add = dynamic_cast<const AddCommand*>(&cmd)) {
+        m[QStringLiteral("k")]   = QStringLiteral("add");
+        m[QStringLiteral("i")]   = static_cast<qint64>(add->index());
+        m[QStringLiteral("art")] = encodeArt(add->art());
+    }
+    else if (auto many = dynamic_cast<const AddManyCommand*>(&cmd)) {
+        QCborArray arts;
+        for (const auto& art : many->arts()) arts.append(encodeArt(art));
+        m[QStringLiteral("k")]    = QStringLiteral("addMany");
+        m[QStringLiteral("i")]    = static_cast<qint64>(many->index());
+        m[QStringLiteral("arts")] = arts;
+    }
+    else if (auto rm = dynamic_cast<const RemoveCommand*>(&cmd)) {
+        m[QStringLiteral("k")]   = QStringLiteral("remove");
+        m[QStringLiteral("i")]   = static_cast<qint64>(rm->index());
+        m[QStringLiteral("art")] = encodeArt(rm->removedArt());
+    }
+    else if (auto many = dynamic_cast<const RemoveManyCommand*>(&cmd)) {
+        QCborArray indices, arts;
+        for (std::size_t i : many->indices())      indices.append(static_cast<qint64>(i));
+        for (const auto& art : many->removedArt()) arts.append(encodeArt(art));
+        m[QStringLiteral("k")]    = QStringLiteral("removeMany");
+        m[QStringLiteral("is")]   = indices;
+        m[QStringLiteral("arts")] = arts;
+    }
+    else if (auto edit = dynamic_cast<const EditCommand*>(&cmd)) {
+        m[QStringLiteral("k")]   = QStringLiteral("edit");
+        m[QStringLiteral("i")]   = static_cast<qint64>(edit->index());
+        m[QStringLiteral("old")] = encodeArt(edit->oldArt());
+        m[QStringLiteral("new")] = encodeArt(edit->newArt());
+    }
+    else if (auto fields = dynamic_cast<const FieldEditCommand*>(&cmd)) {
+        QCborArray deltas;
+        for (const FieldDelta& d : fields->deltas()) {
+            deltas.append(QCborArray{static_cast<int>(d.field),
+                                     encodeField(d.oldValue), encodeField(d.newValue)});
+        }
+        m[QStringLiteral("k")] = QStringLiteral("fields");
+        m[QStringLiteral("i")] = static_cast<qint64>(fields->index());
+        m[QStringLiteral("d")] = deltas;
+    }
+    else if (auto group = dynamic_cast<const CompositeCommand*>(&cmd)) {
+        QCborArray children;
+        for (const auto& child : group->children()) children.append(encodeMap(*child));
+        m[QStringLiteral("k")] = QStringLiteral("group");
+        m[QStringLiteral("c")] = children;
+    }
+    return m;
+}
+
+CommandPtr decodeMap(const QCborMap& m, const std::shared_ptr<ArtRepositoryInterface>& repo)
+{
+    const QString kind = m.value(QStringLiteral("k")).toString();
+    const auto index = static_cast<std::size_t>(m.value(QStringLiteral("i")).toInteger());
+
+    if (kind == QLatin1String("add")) {
+        auto art = decodeArt(m.value(QStringLiteral("art")));
+        if (!art) return nullptr;
+        return std::make_unique<AddCommand>(repo, art, index);
+    }
+    if (kind == QLatin1String("addMany")) {
+        std::vector<std::shared_ptr<ArtObject>> arts;
+        for (const QCborValue& v : m.value(QStringLiteral("arts")).toArray()) {
+            auto art = decodeArt(v);
+            if (!art) return nullptr;
+            arts.push_back(art);
+        }
+        return std::make_unique<AddManyCommand>(repo, std::move(arts), index);
+    }
+    if (kind == QLatin1String("remove")) {
+        return std::make_unique<RemoveCommand>(repo, index,
+                                               decodeArt(m.value(QStringLiteral("art"))));
+    }
+    if (kind == QLatin1String("removeMany")) {
+        std::vector<std::size_t> indices;
+        std::vector<std::shared_ptr<ArtObject>> arts;
+        for (const QCborValue& v : m.value(QStringLiteral("is")).toArray()) {
+            indices.push_back(static_cast<std::size_t>(v.toInteger()));
+        }
+        for (const QCborValue& v : m.value(QStringLiteral("arts")).toArray()) {
+            if (auto art = decodeArt(v)) arts.push_back(art);
+        }
+        return std::make_unique<RemoveManyCommand>(repo, std::move(indices), std::move(arts));
+    }
+    if (kind == QLatin1String("edit")) {
+        auto oldArt = decodeArt(m.value(QStringLiteral("old")));
+        auto newArt = decodeArt(m.value(QStringLiteral("new")));
+        if (!oldArt || !newArt) return nullptr;
+        return std::make_unique<EditCommand>(repo, index, oldArt, newArt);
+    }
+    if (kind == QLatin1String("fields")) {
+        std::vector<FieldDelta> deltas;
+        for (const QCborValue& v : m.value(QStringLiteral("d")).toArray()) {
+            const QCborArray d = v.toArray();
+            if (d.size() != 3) return nullptr;
+            deltas.push_back({static_cast<ArtField>(d.at(0).toInteger()),
+                              decodeField(d.at(1)), decodeField(d.at(2))});
+        }
+        return std::make_unique<FieldEditCommand>(repo, index, std::move(deltas));
+    }
+    if (kind == QLatin1String("group")) {
+        auto group = std::make_unique<CompositeCommand>(repo);
+        for (const QCborValue& v : m.value(QStringLiteral("c")).toArray()) {
+            CommandPtr child = decodeMap(v.toMap(), repo);
+            if (!child) return nullptr;
+            group->add(std::move(child));
+        }
+        return group;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+UndoJournal::UndoJournal() = default;
+
+UndoJournal::~UndoJournal()
+{
+    flush();
+    file_.close();
+}
+
+QString UndoJournal::pathFor(const QString& catalogPath)
+{
+    return catalogPath + ".undo";
+}
+
+QByteArray UndoJournal::fingerprint(const QString& catalogPath)
+{
+    QFileInfo info(catalogPath);
+    if (!info.exists()) return QByteArray();
+    return QByteArray::number(info.size()) + ':'
+         + QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+// ── Codec ──
+QByteArray UndoJournal::encodeCommand(const Command& cmd)
+{
+    return encodeMap(cmd).toCborValue().toCbor();
+}
+
+CommandPtr UndoJournal::decodeCommand(const QByteArray& data,
+                                      const std::shared_ptr<ArtRepositoryInterface>& repo)
+{
+    const QCborValue value = QCborValue::fromCbor(data);
+    if (!value.isMap()) return nullptr;
+    return decodeMap(value.toMap(), repo);
+}
+
+QByteArray UndoJournal::frame(Op op, const QByteArray& payload)
+{
+    const quint32 length = static_cast<quint32>(payload.size());
+    QByteArray out;
+    out.reserve(payload.size() + kFrameOverhead);
+    out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.append(static_cast<char>(op));
+    out.append(payload);
+    out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    return out;
+}
+
+// ── Open ──
+UndoJournal::State UndoJournal::open(const QString& catalogPath,
+                                     std::shared_ptr<ArtRepositoryInterface> repo,
+                                     UndoHistory& history)
+{
+    flush();
+    file_.close();
+
+    catalogPath_ = catalogPath;
+    path_        = pathFor(catalogPath);
+    repo_        = std::move(repo);
+    state_       = State::Closed;
+
+    file_.setFileName(path_);
+    if (!file_.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open undo journal:" << path_;
+        return state_;
+    }
+
+    char magic[sizeof(kMagic)] = {};
+    const bool valid = file_.size() >= kHeaderSize
+                    && file_.read(magic, sizeof(magic)) == qint64(sizeof(magic))
+                    && std::memcmp(magic, kMagic, sizeof(magic)) == 0;
+    const QByteArray current = fingerprint(catalogPath_);
+
+    Record last;
+    if (valid && readLastRecord(&last)) {
+        if (last.op == Checkpoint && last.payload == current) {
+            // Clean shutdown: nothing to do until the user undoes that far
+            sessionStart_ = file_.size();
+            state_ = State::Clean;
+            history.setOlderLoader([this](std::vector<CommandPtr>& undo,
+                                          std::vector<CommandPtr>& redo) {
+                loadOlder(undo, redo);
+            });
+        } else if (last.op != Checkpoint) {
+            // The app died after the last save: replay what followed it
+            std::vector<Record> records;
+            readRecords(file_.size(), &records);
+            std::size_t liveFrom = records.size();
+            for (std::size_t i = records.size(); i-- > 0; ) {
+                if (records[i].op == Checkpoint) {
+                    if (records[i].payload == current) liveFrom = i + 1;
+                    break;
+                }
+            }
+            if (liveFrom < records.size()) {
+                std::vector<CommandPtr> undo, redo;
+                {
+                    ArtRepositoryInterface::BatchScope batch(*repo_);
+                    replay(records, liveFrom, undo, redo);
+                }
+                history.restore(std::move(undo), std::move(redo));
+                sessionStart_ = file_.size();
+                state_ = State::Recovered;
+            }
+        }
+    }
+
+    if (state_ == State::Closed) {
+        // No usable history for this catalog
+        reset();
+        state_ = State::Reset;
+    }
+    file_.seek(file_.size());
+    history.setListener(this);
+    return state_;
+}
+
+void UndoJournal::reset()
+{
+    file_.resize(0);
+    file_.seek(0);
+    file_.write(kMagic, sizeof(kMagic));
+    file_.write(frame(Checkpoint, fingerprint(catalogPath_)));
+    file_.flush();
+    sessionStart_ = file_.size();
+}
+
+// ── Reading (GUI thread, writer idle) ──
+bool UndoJournal::readRecords(qint64 end, std::vector<Record>* out)
+{
+    if (!file_.seek(kHeaderSize)) return false;
+    const QByteArray data = file_.read(end - kHeaderSize);
+    const char* p = data.constData();
+    qint64 pos = 0;
+
+    while (pos + kFrameOverhead <= data.size()) {
+        quint32 length = 0, trailer = 0;
+        std::memcpy(&length, p + pos, sizeof(length));
+        if (pos + kFrameOverhead + qint64(length) > data.size()) break;
+        std::memcpy(&trailer, p + pos + 5 + length, sizeof(trailer));
+        if (trailer != length) break;
+
+        Record r;
+        r.op      = static_cast<Op>(static_cast<quint8>(p[pos + 4]));
+        r.payload = data.mid(pos + 5, length);
+        out->push_back(std::move(r));
+        pos += kFrameOverhead + length;
+    }
+
+    if (pos < data.size()) {
+        // Torn write from a crash: drop the incomplete tail
+        qWarning() << "Undo journal truncated at" << kHeaderSize + pos << path_;
+        file_.resize(kHeaderSize + pos);
+    }
+    return true;
+}
+
+bool UndoJournal::readLastRecord(Record* out)
+{
+    const qint64 size = file_.size();
+    if (size < kHeaderSize + kFrameOverhead) return false;
+
+    quint32 length = 0, leading = 0;
+    if (!file_.seek(size - 4) || file_.read(reinterpret_cast<char*>(&length), 4) != 4) return false;
+    const qint64 start = size - kFrameOverhead - length;
+    if (start < kHeaderSize || !file_.seek(start)
+        || file_.read(reinterpret_cast<char*>(&leading), 4) != 4 || leading != length) {
+        // Torn tail: not a clean checkpoint, let the full read sort it out
+        out->op = Push;
+        return true;
+    }
+    char op = 0;
+    file_.read(&op, 1);
+    out->op      = static_cast<Op>(static_cast<quint8>(op));
+    out->payload = file_.read(length);
+    return true;
+}
+
+void UndoJournal::replay(const std::vector<Record>& records, std::size_t liveFrom,
+                         std::vector<CommandPtr>& undo, std::vector<CommandPtr>& redo)
+{
+    // Up to liveFrom only the stacks are rebuilt; the repository already
+    // reflects those steps. After it every step is also applied.
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        const Record& r = records[i];
+        const bool live = i >= liveFrom;
+        if (i == liveFrom) {
+            for (auto& cmd : undo) cmd->markExecuted(true);
+            for (auto& cmd : redo) cmd->markExecuted(false);
+        }
+
+        switch (r.op) {
+        case Push:
+        case PushMerged: {
+            CommandPtr cmd = decodeCommand(r.payload, repo_);
+            if (!cmd) {
+                qWarning() << "Undo journal: unreadable step, history cut short" << path_;
+                undo.clear();
+                redo.clear();
+                continue;
+            }
+            if (live) cmd->execute();
+            redo.clear();
+            if (r.op == PushMerged && !undo.empty() && undo.back()->mergeWith(*cmd)) break;
+            undo.push_back(std::move(cmd));
+            break;
+        }
+        case Undo:
+            if (undo.empty()) break;
+            if (live) undo.back()->undo();
+            redo.push_back(std::move(undo.back()));
+            undo.pop_back();
+            break;
+        case Redo:
+            if (redo.empty()) break;
+            if (live) redo.back()->execute();
+            undo.push_back(std::move(redo.back()));
+            redo.pop_back();
+            break;
+        case Clear:
+            undo.clear();
+            redo.clear();
+            break;
+        case Checkpoint:
+            break;
+        }
+    }
+
+    if (liveFrom >= records.size()) {
+        for (auto& cmd : undo) cmd->markExecuted(true);
+        for (auto& cmd : redo) cmd->markExecuted(false);
+    }
+}
+
+void UndoJournal::loadOlder(std::vector<CommandPtr>& undo, std::vector<CommandPtr>& redo)
+{
+    flush();
+    std::vector<Record> records;
+    readRecords(sessionStart_, &records);
+    replay(records, records.size(), undo, redo);
+    file_.seek(file_.size());
+}
+
+// ── Writing ──
+void UndoJournal::commandPushed(const Command& cmd, bool merged)
+{
+    append(merged ? PushMerged : Push, encodeCommand(cmd));
+}
+
+void UndoJournal::commandUndone()  { append(Undo); }
+void UndoJournal::commandRedone()  { append(Redo); }
+void UndoJournal::historyCleared() { append(Clear); }
+
+void UndoJournal::append(Op op, const QByteArray& payload)
+{
+    if (state_ == State::Closed) return;
+
+    QMutexLocker lock(&mutex_);
+    pending_.append(frame(op, payload));
+    if (writeQueued_) return;   // the queued write picks this up too
+    writeQueued_ = true;
+
+    writer_.submit(TaskScheduler::Priority::Autosave, [this]() {
+        QByteArray batch;
+        {
+            QMutexLocker lock(&mutex_);
+            batch.swap(pending_);
+            writeQueued_ = false;
+        }
+        if (file_.write(batch) != batch.size()) {
+            qWarning() << "Cannot append to undo journal:" << path_;
+        }
+        file_.flush();
+    });
+}
+
+void UndoJournal::flush()
+{
+    writer_.wait();
+}
+
+void UndoJournal::checkpoint(UndoHistory& history)
+{
+    if (state_ == State::Closed) return;
+    flush();
+
+    if (file_.size() > kCompactBytes) {
+        // The whole history has to be in memory to be written back
+        history.loadOlder();
+        if (rewrite(history)) return;
+    }
+    append(Checkpoint, fingerprint(catalogPath_));
+    flush();
+}
+
+bool UndoJournal::rewrite(const UndoHistory& history)
+{
+    const QString tmpPath = path_ + ".compact";
+    QFile out(tmpPath);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    // Undo steps as plain pushes; redo steps pushed nearest-last-undone
+    // first and then undone again, which rebuilds the same redo stack
+    QByteArray data(kMagic, sizeof(kMagic));
+    for (const Command* cmd : history.undoCommands()) data += frame(Push, encodeCommand(*cmd));
+    const auto redo = history.redoCommands();
+    for (auto it = redo.rbegin(); it != redo.rend(); ++it) data += frame(Push, encodeCommand(**it));
+    for (std::size_t i = 0; i < redo.size(); ++i) data += frame(Undo, QByteArray());
+    data += frame(Checkpoint, fingerprint(catalogPath_));
+
+    const bool ok = out.write(data) == data.size();
+    out.close();
+    if (!ok) {
+        QFile::remove(tmpPath);
+        return false;
+    }
+
+    file_.close();
+    QFile::remove(path_);
+    if (!QFile::rename(tmpPath, path_)) {
+        qWarning() << "Cannot replace undo journal:" << path_;
+        state_ = State::Closed;
+        return false;
+    }
+    file_.setFileName(path_);
+    if (!file_.open(QIODevice::ReadWrite)) {
+        state_ = State::Closed;
+        return false;
+    }
+    file_.seek(file_.size());
+    sessionStart_ = file_.size();
+    return true;
+}